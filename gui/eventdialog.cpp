@@ -239,7 +239,8 @@ mef::FaultTree *EventDialog::getFaultTree(const mef::Gate *event) const
 {
     auto it = boost::find_if(m_model->table<mef::FaultTree>(),
                              [&event](const mef::FaultTree &faultTree) {
-                                 return faultTree.gates().count(event->name());
+                                 return faultTree.gates().count(
+                                     event->name_symbol());
                              });
     GUI_ASSERT(it != m_model->table<mef::FaultTree>().end(), nullptr);
     return &*it;
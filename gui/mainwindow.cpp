@@ -1022,7 +1022,8 @@ mef::FaultTree *MainWindow::getFaultTree(mef::Gate *gate)
     /// @todo Duplicate code from EventDialog.
     auto it = boost::find_if(m_model->table<mef::FaultTree>(),
                              [&gate](const mef::FaultTree &faultTree) {
-                                 return faultTree.gates().count(gate->name());
+                                 return faultTree.gates().count(
+                                     gate->name_symbol());
                              });
     GUI_ASSERT(it != m_model->table<mef::FaultTree>().end(), nullptr);
     return &*it;
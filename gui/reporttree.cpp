@@ -96,6 +96,14 @@ QVariant ReportTree::data(const QModelIndex &index, int role) const
             GUI_ASSERT(false && "unexpected analysis target", {});
             return {};
         }
+
+        QString
+        operator()(const std::pair<const mef::InitiatingEvent &,
+                                   const core::EventTreeAnalysis::EndState &> &)
+        {
+            GUI_ASSERT(false && "unexpected analysis target", {});
+            return {};
+        }
     } nameExtractor;
 
     if (!index.parent().isValid()) {
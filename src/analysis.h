@@ -26,6 +26,7 @@
 
 #include <boost/noncopyable.hpp>
 
+#include "resources.h"
 #include "settings.h"
 
 namespace scram::core {
@@ -47,10 +48,16 @@ class Analysis : private boost::noncopyable {
   /// @returns Time taken by the analysis.
   double analysis_time() const { return analysis_time_; }
 
+  /// @returns Resources consumed by the analysis.
+  const Resources& resources() const { return resources_; }
+
  protected:
   /// @returns Modifiable analysis settings.
   Settings& settings() { return settings_; }
 
+  /// @returns The destination for the resource measurements.
+  Resources& resources() { return resources_; }
+
   /// Appends a warning message to the analysis warnings.
   /// Warnings are separated by spaces.
   ///
@@ -71,6 +78,7 @@ class Analysis : private boost::noncopyable {
  private:
   Settings settings_;  ///< All settings for analysis.
   double analysis_time_;  ///< Time taken by the analysis.
+  Resources resources_;  ///< Resources consumed by the analysis.
   std::string warnings_;  ///< Generated warnings in analysis.
 };
 
@@ -20,11 +20,15 @@
 
 #include "bdd.h"
 
+#include <unordered_set>
+
 #include <boost/multiprecision/miller_rabin.hpp>
 #include <boost/range/algorithm.hpp>
 
+#include "ext/algorithm.h"
 #include "ext/find_iterator.h"
 #include "logger.h"
+#include "progress.h"
 #include "zbdd.h"
 
 namespace scram::core {
@@ -44,25 +48,8 @@ Bdd::Bdd(const Pdag* graph, const Settings& settings)
       kOne_(new Terminal<Ite>(true)),
       function_id_(2) {
   TIMER(DEBUG3, "Converting PDAG into BDD");
-  if (graph->IsTrivial()) {
-    const Gate& top_gate = graph->root();
-    assert(top_gate.args().size() == 1);
-    assert(top_gate.args<Gate>().empty());
-    int child = *top_gate.args().begin();
-    if (top_gate.constant()) {
-      // Constant case should only happen to the top gate.
-      root_ = {child < 0, kOne_};
-    } else {
-      const Variable& var = top_gate.args<Variable>().begin()->second;
-      root_ = {child < 0,
-               FindOrAddVertex(var.index(), kOne_, kOne_, true, var.order())};
-      index_to_order_.emplace(var.index(), var.order());
-    }
-  } else {
-    std::unordered_map<int, std::pair<Function, int>> gates;
-    root_ = ConvertGraph(graph->root(), &gates);
-    root_.complement ^= graph->complement();
-  }
+  root_ = ConvertGraph(*graph);
+  roots_.push_back(root_);
   ClearMarks(false);
   TestStructure(root_.vertex);
   LOG(DEBUG4) << "# of BDD vertices created: " << function_id_ - 1;
@@ -79,9 +66,37 @@ Bdd::Bdd(const Pdag* graph, const Settings& settings)
   }
 }
 
+Bdd::Bdd(const std::vector<const Pdag*>& graphs, const Settings& settings)
+    : kSettings_(settings),
+      coherent_(ext::all_of(graphs,
+                            [](const Pdag* graph) { return graph->coherent(); })),
+      kOne_(new Terminal<Ite>(true)),
+      function_id_(2) {
+  TIMER(DEBUG3, "Converting PDAGs into shared BDD");
+  assert(!graphs.empty() && "No graphs to share the BDD.");
+  shared_ = true;
+  std::unordered_map<const mef::BasicEvent*, int> indices;
+  for (const Pdag* graph : graphs) {
+    MapVariables(*graph, &indices);
+    roots_.push_back(ConvertGraph(*graph));
+  }
+  root_ = roots_.front();
+  variables_.clear();
+  ClearMarks(false);
+  for (const Function& root : roots_)
+    TestStructure(root.vertex);
+  LOG(DEBUG4) << "# of shared BDD roots: " << roots_.size();
+  LOG(DEBUG4) << "# of shared BDD variables: " << basic_events_.size();
+  LOG(DEBUG4) << "# of BDD vertices created: " << function_id_ - 1;
+  LOG(DEBUG4) << "# of entries in unique table: " << unique_table_.size();
+  ClearMarks(false);
+  Freeze();
+}
+
 Bdd::~Bdd() noexcept = default;
 
-void Bdd::Analyze(const Pdag* graph) noexcept {
+void Bdd::Analyze(const Pdag* graph) {
+  CheckCancellation(kSettings_.progress());
   zbdd_ = std::make_unique<Zbdd>(this, kSettings_);
   zbdd_->Analyze(graph);
   if (!coherent_)  // The BDD has been used by the ZBDD.
@@ -132,9 +147,65 @@ ItePtr Bdd::FindOrAddVertex(const Gate& gate, const VertexPtr& high,
   return in_table;
 }
 
+Bdd::Function Bdd::ConvertGraph(const Pdag& graph) {
+  if (graph.IsTrivial()) {
+    const Gate& top_gate = graph.root();
+    assert(top_gate.args().size() == 1);
+    assert(top_gate.args<Gate>().empty());
+    int child = *top_gate.args().begin();
+    if (top_gate.constant())  // Constant case should only happen to the top.
+      return {child < 0, kOne_};
+    auto [index, order] =
+        GetIndexOrder(top_gate.args<Variable>().begin()->second);
+    index_to_order_.emplace(index, order);
+    return {child < 0, FindOrAddVertex(index, kOne_, kOne_, true, order)};
+  }
+  std::unordered_map<int, std::pair<Function, int>> gates;
+  Function result = ConvertGraph(graph.root(), &gates);
+  result.complement ^= graph.complement();
+  return result;
+}
+
+void Bdd::MapVariables(
+    const Pdag& graph,
+    std::unordered_map<const mef::BasicEvent*, int>* indices) noexcept {
+  std::vector<const Variable*> variables;
+  if (graph.IsTrivial()) {
+    if (!graph.root().constant())
+      variables.push_back(&graph.root().args<Variable>().begin()->second);
+  } else {
+    std::unordered_set<int> visited;
+    auto collect = [&variables, &visited](const Gate& gate, auto& self) {
+      if (!visited.insert(gate.index()).second)
+        return;
+      for (const Gate::ConstArg<Variable>& arg : gate.args<Variable>()) {
+        if (visited.insert(arg.second.index()).second)
+          variables.push_back(&arg.second);
+      }
+      for (const Gate::ConstArg<Gate>& arg : gate.args<Gate>())
+        self(arg.second, self);
+    };
+    collect(graph.root(), collect);
+  }
+  boost::sort(variables, [](const Variable* lhs, const Variable* rhs) {
+    return lhs->order() < rhs->order();
+  });
+  variables_.assign(graph.basic_events().size(), {0, 0});
+  for (const Variable* var : variables) {
+    const mef::BasicEvent* event = graph.basic_events()[var->index()];
+    auto [it, is_new] = indices->emplace(
+        event, Pdag::kVariableStartIndex + basic_events_.size());
+    if (is_new)
+      basic_events_.push_back(event);
+    // The shared order follows the order of the first appearance.
+    variables_[var->index()] = {it->second,
+                                it->second - Pdag::kVariableStartIndex + 1};
+  }
+}
+
 Bdd::Function Bdd::ConvertGraph(
     const Gate& gate,
-    std::unordered_map<int, std::pair<Function, int>>* gates) noexcept {
+    std::unordered_map<int, std::pair<Function, int>>* gates) {
   assert(!gate.constant() && "Unexpected constant gate!");
   Function result;  // For the NRVO, due to memoization.
   // Memoization check.
@@ -146,16 +217,17 @@ Bdd::Function Bdd::ConvertGraph(
       gates->erase(it_entry);
     return result;
   }
+  CheckCancellation(kSettings_.progress());
   std::vector<Function> args;
   for (const Gate::ConstArg<Variable>& arg : gate.args<Variable>()) {
+    auto [index, order] = GetIndexOrder(arg.second);
     args.push_back(
-        {arg.first < 0, FindOrAddVertex(arg.second.index(), kOne_, kOne_, true,
-                                        arg.second.order())});
-    index_to_order_.emplace(arg.second.index(), arg.second.order());
+        {arg.first < 0, FindOrAddVertex(index, kOne_, kOne_, true, order)});
+    index_to_order_.emplace(index, order);
   }
   for (const Gate::ConstArg<Gate>& arg : gate.args<Gate>()) {
     Function res = ConvertGraph(arg.second, gates);
-    if (arg.second.module()) {
+    if (arg.second.module() && !shared_) {
       args.push_back(
           {arg.first < 0, FindOrAddVertex(arg.second, kOne_, kOne_, true)});
     } else {
@@ -175,9 +247,10 @@ Bdd::Function Bdd::ConvertGraph(
     result = Apply(gate.type(), result.vertex, it->vertex, result.complement,
                    it->complement);
   }
-  ClearTables();
+  if (!shared_)  // The shared BDD keeps computations for other roots.
+    ClearTables();
   assert(result.vertex);
-  if (gate.module())
+  if (gate.module() && !shared_)
     modules_.emplace(gate.index(), result);
   if (gate.parents().size() > 1)
     gates->insert({gate.index(), {result, 1}});
@@ -34,6 +34,7 @@
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
 #include "pdag.h"
+#include "resources.h"
 #include "settings.h"
 
 namespace scram::core {
@@ -261,7 +262,9 @@ class NonTerminal : public Vertex<T>, public IntrusivePtrCast<T> {
         index_(index),
         module_(false),
         coherent_(false),
-        mark_(false) {}
+        mark_(false) {
+    ResourceMeter::Acquire(T::kResource, sizeof(T));
+  }
 
   /// @returns The index of this vertex.
   int index() const { return index_; }
@@ -304,7 +307,7 @@ class NonTerminal : public Vertex<T>, public IntrusivePtrCast<T> {
   void mark(bool flag) { mark_ = flag; }
 
  protected:
-  ~NonTerminal() = default;
+  ~NonTerminal() noexcept { ResourceMeter::Release(T::kResource); }
 
  private:
   VertexPtr high_;  ///< 1 (True/then) branch in the Shannon decomposition.
@@ -335,6 +338,9 @@ class Ite : public NonTerminal<Ite> {
   }
 
  public:
+  /// The kind of the vertex for resource accounting.
+  static constexpr Resource kResource = Resource::kBddVertex;
+
   using NonTerminal::NonTerminal;
 
   /// @returns true if the low edge is complement.
@@ -737,12 +743,40 @@ class Bdd : private boost::noncopyable {
   /// @note BDD construction may take considerable time.
   Bdd(const Pdag* graph, const Settings& settings);
 
+  /// Constructs a shared multi-rooted BDD from several PDAGs.
+  /// The variables of the graphs are identified by their basic events,
+  /// so the roots share the unique table and computation results
+  /// for the common sub-functions, e.g., system fault trees.
+  ///
+  /// The shared variables are ordered by their first appearance
+  /// in the variable orderings of the graphs.
+  /// Modules are converted in place without proxy vertices.
+  ///
+  /// @param[in] graphs  Preprocessed and partially normalized PDAGs.
+  /// @param[in] settings  The analysis settings.
+  ///
+  /// @pre The PDAGs have variable ordering.
+  ///
+  /// @post The BDD is frozen for calculations without further analysis.
+  Bdd(const std::vector<const Pdag*>& graphs, const Settings& settings);
+
   /// To handle incomplete ZBDD type with unique pointers.
   ~Bdd() noexcept;
 
   /// @returns The root function of the ROBDD.
   const Function& root() const { return root_; }
 
+  /// @returns The root functions of the shared BDD in the order of graphs.
+  ///          The root function only for BDD from a single graph.
+  const std::vector<Function>& roots() const { return roots_; }
+
+  /// @returns The basic events of the shared BDD variables
+  ///          mapped by their indices.
+  ///          Empty for BDD from a single graph.
+  const Pdag::IndexMap<const mef::BasicEvent*>& basic_events() const {
+    return basic_events_;
+  }
+
   /// @returns Mapping of PDAG modules and BDD graph vertices.
   const std::unordered_map<int, Function>& modules() const { return modules_; }
 
@@ -762,13 +796,16 @@ class Bdd : private boost::noncopyable {
   ///
   /// @warning If the graph is discontinuously and partially marked,
   ///          this function will not help with the mess.
-  void ClearMarks(bool mark) { ClearMarks(root_.vertex, mark); }
+  void ClearMarks(bool mark) {
+    for (const Function& root : roots_)
+      ClearMarks(root.vertex, mark);
+  }
 
   /// Runs the Qualitative analysis
   /// with the representation of a PDAG as ROBDD.
   ///
   /// @param[in] graph  The optional PDAG with non-declarative substitutions.
-  void Analyze(const Pdag* graph = nullptr) noexcept;
+  void Analyze(const Pdag* graph = nullptr);
 
   /// @returns Products generated by the analysis.
   ///
@@ -828,6 +865,31 @@ class Bdd : private boost::noncopyable {
   ItePtr FindOrAddVertex(const Gate& gate, const VertexPtr& high,
                          const VertexPtr& low, bool complement_edge) noexcept;
 
+  /// Converts the root gate of the PDAG into the BDD function.
+  ///
+  /// @param[in] graph  The PDAG with variable ordering.
+  ///
+  /// @returns The BDD function representing the graph.
+  Function ConvertGraph(const Pdag& graph);
+
+  /// Maps the variables of the graph onto the shared BDD variables.
+  /// New variables are appended in the order of the graph.
+  ///
+  /// @param[in] graph  The PDAG with variable ordering.
+  /// @param[in,out] indices  The shared indices of the basic events.
+  void MapVariables(
+      const Pdag& graph,
+      std::unordered_map<const mef::BasicEvent*, int>* indices) noexcept;
+
+  /// @param[in] var  The PDAG variable under conversion.
+  ///
+  /// @returns The index and order of the variable vertices in this BDD.
+  std::pair<int, int> GetIndexOrder(const Variable& var) const {
+    if (!shared_)
+      return {var.index(), var.order()};
+    return variables_[var.index()];
+  }
+
   /// Converts all gates in the PDAG
   /// into function BDD graphs.
   /// Registers processed gates.
@@ -840,7 +902,7 @@ class Bdd : private boost::noncopyable {
   /// @pre The memoization container is not used outside of this function.
   Function ConvertGraph(
       const Gate& gate,
-      std::unordered_map<int, std::pair<Function, int>>* gates) noexcept;
+      std::unordered_map<int, std::pair<Function, int>>* gates);
 
   /// Computes minimum and maximum ids for keys in computation tables.
   ///
@@ -962,6 +1024,12 @@ class Bdd : private boost::noncopyable {
 
   const Settings kSettings_;  ///< Analysis settings.
   Function root_;  ///< The root function of this BDD.
+  std::vector<Function> roots_;  ///< All the root functions of this BDD.
+  bool shared_ = false;  ///< The BDD is shared by multiple graphs.
+  /// The basic events of the shared variables.
+  Pdag::IndexMap<const mef::BasicEvent*> basic_events_;
+  /// The shared {index, order} of the variables of the graph under conversion.
+  Pdag::IndexMap<std::pair<int, int>> variables_;
   bool coherent_;  ///< Inherited coherence from PDAG.
 
   /// Table of unique if-then-else nodes denoting function graphs.
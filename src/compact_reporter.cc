@@ -0,0 +1,651 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the compact reporters.
+
+#include "compact_reporter.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+#include <algorithm>
+#include <charconv>
+#include <iterator>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+
+#include <boost/exception/errinfo_errno.hpp>
+
+#include "error.h"
+#include "logger.h"
+#include "version.h"
+
+namespace scram {
+
+namespace {
+
+const std::size_t kBufferSize = 1 << 16;  ///< The output block size.
+
+/// The flat description of the analysis target.
+struct TargetId {
+  /// @param[in] id  The analysis id of the target.
+  explicit TargetId(const core::RiskAnalysis::Result::Id& id) {
+    struct {
+      void operator()(const mef::Gate* gate) { self.name = gate->id(); }
+      void operator()(const std::pair<const mef::InitiatingEvent&,
+                                      const mef::Sequence&>& sequence) {
+        self.kind = kSequence;
+        self.initiating_event = sequence.first.name();
+        self.name = sequence.second.name();
+      }
+      void operator()(const std::pair<const mef::InitiatingEvent&,
+                                      const core::EventTreeAnalysis::EndState&>&
+                          end_state) {
+        self.kind = kEndState;
+        self.initiating_event = end_state.first.name();
+        self.name = end_state.second.name;
+      }
+      TargetId& self;
+    } extractor{*this};
+    std::visit(extractor, id.target);
+    if (id.context) {
+      alignment = id.context->alignment.name();
+      phase = id.context->phase.name();
+    }
+  }
+
+  /// The kinds of the analysis targets.
+  enum Kind : std::uint8_t { kGate, kSequence, kEndState };
+
+  Kind kind = kGate;  ///< The kind of the target.
+  std::string_view name;  ///< The gate, sequence, or end-state name.
+  std::string_view initiating_event;  ///< The optional initiating event.
+  std::string_view alignment;  ///< The optional alignment of the target.
+  std::string_view phase;  ///< The optional phase of the target.
+};
+
+/// @returns The warnings of all the analyses of the target.
+std::string GatherWarnings(const core::RiskAnalysis::Result& result) {
+  std::string warning;
+  auto append = [&warning](const core::Analysis* analysis) {
+    if (!analysis || analysis->warnings().empty())
+      return;
+    warning += (warning.empty() ? "" : "; ") + analysis->warnings();
+  };
+  append(result.fault_tree_analysis.get());
+  append(result.probability_analysis.get());
+  append(result.importance_analysis.get());
+  append(result.uncertainty_analysis.get());
+  return warning;
+}
+
+/// JSON object per line.
+///
+/// The first line is the software information.
+/// Every analysis target is announced with a "target" line,
+/// and the lines of the target results reference its "target" number.
+/// The non-finite numbers are written as null.
+class JsonLinesReporter : public CompactReporter {
+ public:
+  /// @param[in] probability_analysis  The presence of the probability results.
+  /// @param[in] output  The destination of the report.
+  JsonLinesReporter(bool probability_analysis,
+                    std::unique_ptr<xml::Output> output)
+      : CompactReporter(std::move(output)),
+        probability_analysis_(probability_analysis) {
+    Begin("information");
+    Key("software");
+    String("SCRAM");
+    Key("version");
+    String(*SCRAM_GIT_REVISION != '\0' ? SCRAM_GIT_REVISION : SCRAM_VERSION);
+    Write("}\n");
+  }
+
+  void Consume(const core::RiskAnalysis::EtaResult& eta_result) override {
+    if (!probability_analysis_)
+      return;
+    const core::EventTreeAnalysis& eta = *eta_result.event_tree_analysis;
+    Begin("initiating-event");
+    Key("name");
+    String(eta.initiating_event().name());
+    if (eta_result.context) {
+      Key("alignment");
+      String(eta_result.context->alignment.name());
+      Key("phase");
+      String(eta_result.context->phase.name());
+    }
+    auto put_values = [this](std::string_view key, const auto& entries,
+                             const auto& get_name, const auto& get_value) {
+      Key(key);
+      Write("[");
+      bool first = true;
+      for (const auto& entry : entries) {
+        Write(first ? "{\"name\":" : ",{\"name\":");
+        first = false;
+        String(get_name(entry));
+        Key("value");
+        Number(get_value(entry));
+        Write("}");
+      }
+      Write("]");
+    };
+    put_values(
+        "sequences", eta.sequences(),
+        [](const auto& result) { return result.sequence.name(); },
+        [](const auto& result) { return result.p_sequence; });
+    put_values(
+        "end-states", eta.end_states(),
+        [](const auto& end_state) { return std::string_view(end_state.name); },
+        [](const auto& end_state) { return end_state.p_end_state; });
+    Write("}\n");
+  }
+
+  void Consume(const core::RiskAnalysis::Result& result) override {
+    ++target_;
+    TargetId id(result.id);
+    Begin("target");
+    Key("name");
+    String(id.name);
+    if (id.kind != TargetId::kGate) {
+      Key("initiating-event");
+      String(id.initiating_event);
+    }
+    if (id.kind == TargetId::kEndState) {
+      Key("end-state");
+      Write("true");
+    }
+    if (!id.alignment.empty()) {
+      Key("alignment");
+      String(id.alignment);
+      Key("phase");
+      String(id.phase);
+    }
+    if (std::string warning = GatherWarnings(result); !warning.empty()) {
+      Key("warning");
+      String(warning);
+    }
+    if (result.cached) {
+      Key("cached");
+      Write("true");
+    }
+    if (const core::FaultTreeAnalysis* fta = result.fault_tree_analysis.get()) {
+      Key("basic-events");
+      Integer(fta->products().product_events().size());
+      Key("products");
+      Integer(fta->products().size());
+      Key("distribution");
+      Write("[");
+      for (int i = 0; i < fta->products().distribution().size(); ++i) {
+        if (i)
+          Write(",");
+        Integer(fta->products().distribution()[i]);
+      }
+      Write("]");
+    }
+    if (result.probability_analysis) {
+      Key("probability");
+      Number(result.probability_analysis->p_total());
+    }
+    Write("}\n");
+
+    if (result.fault_tree_analysis)
+      ReportProducts(*result.fault_tree_analysis,
+                     result.probability_analysis != nullptr);
+    if (result.importance_analysis)
+      ReportImportance(*result.importance_analysis);
+    if (result.uncertainty_analysis)
+      ReportUncertainty(*result.uncertainty_analysis);
+  }
+
+ private:
+  /// Reports the products of the target a line per product.
+  ///
+  /// @param[in] fta  The qualitative analysis of the target.
+  /// @param[in] probability  The indication of the product probabilities.
+  void ReportProducts(const core::FaultTreeAnalysis& fta, bool probability) {
+    double sum = 0;
+    if (probability) {
+      for (const core::Product& product : fta.products())
+        sum += product.p();
+    }
+    for (const core::Product& product : fta.products()) {
+      Begin("product");
+      Key("target");
+      Integer(target_);
+      Key("order");
+      Integer(product.order());
+      if (probability) {
+        double p = product.p();
+        Key("probability");
+        Number(p);
+        if (sum != 0) {
+          Key("contribution");
+          Number(p / sum);
+        }
+      }
+      auto put_events = [this, &product](std::string_view key,
+                                         bool complement) {
+        Key(key);
+        Write("[");
+        bool first = true;
+        for (const core::Literal& literal : product) {
+          if (literal.complement != complement)
+            continue;
+          if (!first)
+            Write(",");
+          first = false;
+          String(literal.event.id());
+        }
+        Write("]");
+      };
+      put_events("events", false);
+      put_events("not", true);
+      Write("}\n");
+    }
+  }
+
+  /// Reports the importance factors a line per basic event.
+  ///
+  /// @param[in] importance_analysis  The importance analysis of the target.
+  void ReportImportance(const core::ImportanceAnalysis& importance_analysis) {
+    for (const core::ImportanceRecord& entry :
+         importance_analysis.importance()) {
+      Begin("importance");
+      Key("target");
+      Integer(target_);
+      Key("event");
+      String(entry.event.id());
+      Key("occurrence");
+      Integer(entry.factors.occurrence);
+      Key("probability");
+      Number(entry.event.p());
+      Key("MIF");
+      Number(entry.factors.mif);
+      Key("CIF");
+      Number(entry.factors.cif);
+      Key("DIF");
+      Number(entry.factors.dif);
+      Key("RAW");
+      Number(entry.factors.raw);
+      Key("RRW");
+      Number(entry.factors.rrw);
+      Write("}\n");
+    }
+  }
+
+  /// Reports the uncertainty measures in a single line.
+  ///
+  /// @param[in] uncert_analysis  The uncertainty analysis of the target.
+  void ReportUncertainty(const core::UncertaintyAnalysis& uncert_analysis) {
+    Begin("measure");
+    Key("target");
+    Integer(target_);
+    Key("mean");
+    Number(uncert_analysis.mean());
+    Key("standard-deviation");
+    Number(uncert_analysis.sigma());
+    Key("confidence-range");
+    Write("[");
+    Number(uncert_analysis.confidence_interval().first);
+    Write(",");
+    Number(uncert_analysis.confidence_interval().second);
+    Write("]");
+    Key("error-factor");
+    Number(uncert_analysis.error_factor());
+    Key("quantiles");
+    Write("[");
+    for (int i = 0; i < uncert_analysis.quantiles().size(); ++i) {
+      if (i)
+        Write(",");
+      Number(uncert_analysis.quantiles()[i]);
+    }
+    Write("]");
+    Key("histogram");  // [lower-bound, upper-bound, value] per bin.
+    Write("[");
+    const auto& distribution = uncert_analysis.distribution();
+    for (int i = 0; i + 1 < distribution.size(); ++i) {
+      Write(i ? ",[" : "[");
+      Number(distribution[i].first);
+      Write(",");
+      Number(distribution[i + 1].first);
+      Write(",");
+      Number(distribution[i].second);
+      Write("]");
+    }
+    Write("]}\n");
+  }
+
+  /// Starts the object of the given type.
+  void Begin(std::string_view type) {
+    Write("{\"type\":");
+    String(type);
+  }
+
+  /// Starts the next member of the object.
+  void Key(std::string_view key) {
+    Write(",");
+    String(key);
+    Write(":");
+  }
+
+  /// Writes the escaped JSON string.
+  void String(std::string_view text) {
+    Write("\"");
+    auto run = text.begin();
+    for (auto it = text.begin(); it != text.end(); ++it) {
+      unsigned char ch = *it;
+      if (ch >= 0x20 && ch != '"' && ch != '\\')
+        continue;
+      Write(std::string_view(&*run, it - run));
+      run = std::next(it);
+      if (ch == '"' || ch == '\\') {
+        char escape[] = {'\\', static_cast<char>(ch)};
+        Write(escape, sizeof(escape));
+      } else {
+        const char* hex = "0123456789abcdef";
+        char escape[] = {'\\', 'u', '0', '0', hex[ch >> 4], hex[ch & 0xF]};
+        Write(escape, sizeof(escape));
+      }
+    }
+    Write(std::string_view(&*run, text.end() - run));
+    Write("\"");
+  }
+
+  /// Writes the shortest representation of the number.
+  void Number(double value) {
+    if (!std::isfinite(value))
+      return Write("null");
+    char digits[32];
+    auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+    assert(ec == std::errc());
+    Write(digits, end - digits);
+  }
+
+  /// Writes the integer number.
+  void Integer(std::int64_t value) {
+    char digits[24];
+    auto [end, ec] = std::to_chars(std::begin(digits), std::end(digits), value);
+    assert(ec == std::errc());
+    Write(digits, end - digits);
+  }
+
+  using CompactReporter::Write;
+
+  bool probability_analysis_;  ///< The sequence values are meaningful.
+  int target_ = -1;  ///< The number of the current target.
+};
+
+/// Binary tables of results.
+///
+/// The report starts with the "SCRAMCOL" magic,
+/// the uint32 format version, and the uint32 byte-order mark 0x01020304.
+/// The tables follow as the uint32 table kind and the table data
+/// until the end-table kind.
+/// The strings are the uint32 size and UTF-8 characters.
+/// The columns are arrays of the given count:
+///
+///   - target: uint32 number, uint8 kind (gate, sequence, end-state),
+///     strings name, initiating-event, alignment, phase, warning,
+///     uint8 cached, double probability (NaN if not calculated).
+///   - products: uint32 target, uint32 count and strings of the event names,
+///     uint64 product count P, uint64 literal count L,
+///     uint64[P + 1] literal offsets of products,
+///     int32[L] literals as 1-based event numbers (negative for complement),
+///     uint8 probability flag followed by double[P] if set.
+///   - importance: uint32 target, uint32 count N, strings[N] event names,
+///     int32[N] occurrence, double[N] columns of probability,
+///     MIF, CIF, DIF, RAW, RRW.
+///   - uncertainty: uint32 target, double mean, sigma,
+///     95% confidence lower and upper bounds, error factor,
+///     uint32 count and double quantiles,
+///     uint32 count B and double[B] histogram bounds, double[B] bin values.
+///   - initiating-event: strings name, alignment, phase,
+///     uint32 count, strings names and double values of sequences,
+///     uint32 count, strings names and double values of end states.
+class ColumnarReporter : public CompactReporter {
+ public:
+  /// The kinds of tables.
+  enum Table : std::uint32_t {
+    kEnd,
+    kTarget,
+    kProducts,
+    kImportance,
+    kUncertainty,
+    kInitiatingEvent
+  };
+
+  static const std::uint32_t kVersion = 1;  ///< The format version.
+
+  /// @param[in] probability_analysis  The presence of the probability results.
+  /// @param[in] output  The destination of the report.
+  ColumnarReporter(bool probability_analysis,
+                   std::unique_ptr<xml::Output> output)
+      : CompactReporter(std::move(output)),
+        probability_analysis_(probability_analysis) {
+    Write("SCRAMCOL");
+    Put(kVersion);
+    Put(std::uint32_t{0x01020304});
+  }
+
+  void Consume(const core::RiskAnalysis::EtaResult& eta_result) override {
+    if (!probability_analysis_)
+      return;
+    const core::EventTreeAnalysis& eta = *eta_result.event_tree_analysis;
+    Put(kInitiatingEvent);
+    PutString(eta.initiating_event().name());
+    PutString(eta_result.context ? eta_result.context->alignment.name() : "");
+    PutString(eta_result.context ? eta_result.context->phase.name() : "");
+    Put<std::uint32_t>(eta.sequences().size());
+    for (const auto& result : eta.sequences())
+      PutString(result.sequence.name());
+    for (const auto& result : eta.sequences())
+      Put(result.p_sequence);
+    Put<std::uint32_t>(eta.end_states().size());
+    for (const auto& end_state : eta.end_states())
+      PutString(end_state.name);
+    for (const auto& end_state : eta.end_states())
+      Put(end_state.p_end_state);
+  }
+
+  void Consume(const core::RiskAnalysis::Result& result) override {
+    ++target_;
+    TargetId id(result.id);
+    Put(kTarget);
+    Put<std::uint32_t>(target_);
+    Put(id.kind);
+    PutString(id.name);
+    PutString(id.initiating_event);
+    PutString(id.alignment);
+    PutString(id.phase);
+    PutString(GatherWarnings(result));
+    Put<std::uint8_t>(result.cached);
+    Put(result.probability_analysis ? result.probability_analysis->p_total()
+                                    : std::nan(""));
+
+    if (result.fault_tree_analysis)
+      ReportProducts(*result.fault_tree_analysis,
+                     result.probability_analysis != nullptr);
+    if (result.importance_analysis)
+      ReportImportance(*result.importance_analysis);
+    if (result.uncertainty_analysis)
+      ReportUncertainty(*result.uncertainty_analysis);
+  }
+
+ private:
+  void End() override { Put(kEnd); }
+
+  /// Reports the products with the event dictionary sorted by names.
+  ///
+  /// @param[in] fta  The qualitative analysis of the target.
+  /// @param[in] probability  The indication of the product probabilities.
+  void ReportProducts(const core::FaultTreeAnalysis& fta, bool probability) {
+    const core::ProductContainer& products = fta.products();
+    std::vector<const mef::BasicEvent*> events(
+        products.product_events().begin(), products.product_events().end());
+    std::sort(events.begin(), events.end(),
+              [](const auto* lhs, const auto* rhs) {
+                return lhs->id() < rhs->id();
+              });
+    std::unordered_map<const mef::BasicEvent*, std::int32_t> numbers;
+    numbers.reserve(events.size());
+    Put(kProducts);
+    Put<std::uint32_t>(target_);
+    Put<std::uint32_t>(events.size());
+    for (const mef::BasicEvent* event : events) {
+      PutString(event->id());
+      numbers.emplace(event, numbers.size() + 1);
+    }
+
+    std::uint64_t num_literals = 0;
+    for (const core::Product& product : products)
+      num_literals += product.size();
+    Put<std::uint64_t>(products.size());
+    Put(num_literals);
+    std::uint64_t offset = 0;
+    Put(offset);
+    for (const core::Product& product : products)
+      Put(offset += product.size());
+    for (const core::Product& product : products) {
+      for (const core::Literal& literal : product) {
+        std::int32_t number = numbers.find(&literal.event)->second;
+        Put(literal.complement ? -number : number);
+      }
+    }
+    Put<std::uint8_t>(probability);
+    if (probability) {
+      for (const core::Product& product : products)
+        Put(product.p());
+    }
+  }
+
+  /// Reports the importance factors as columns.
+  ///
+  /// @param[in] importance_analysis  The importance analysis of the target.
+  void ReportImportance(const core::ImportanceAnalysis& importance_analysis) {
+    const auto& importance = importance_analysis.importance();
+    Put(kImportance);
+    Put<std::uint32_t>(target_);
+    Put<std::uint32_t>(importance.size());
+    for (const core::ImportanceRecord& entry : importance)
+      PutString(entry.event.id());
+    for (const core::ImportanceRecord& entry : importance)
+      Put<std::int32_t>(entry.factors.occurrence);
+    for (const core::ImportanceRecord& entry : importance)
+      Put(entry.event.p());
+    for (double core::ImportanceFactors::*factor :
+         {&core::ImportanceFactors::mif, &core::ImportanceFactors::cif,
+          &core::ImportanceFactors::dif, &core::ImportanceFactors::raw,
+          &core::ImportanceFactors::rrw}) {
+      for (const core::ImportanceRecord& entry : importance)
+        Put(entry.factors.*factor);
+    }
+  }
+
+  /// Reports the uncertainty measures.
+  ///
+  /// @param[in] uncert_analysis  The uncertainty analysis of the target.
+  void ReportUncertainty(const core::UncertaintyAnalysis& uncert_analysis) {
+    Put(kUncertainty);
+    Put<std::uint32_t>(target_);
+    Put(uncert_analysis.mean());
+    Put(uncert_analysis.sigma());
+    Put(uncert_analysis.confidence_interval().first);
+    Put(uncert_analysis.confidence_interval().second);
+    Put(uncert_analysis.error_factor());
+    Put<std::uint32_t>(uncert_analysis.quantiles().size());
+    for (double quantile : uncert_analysis.quantiles())
+      Put(quantile);
+    const auto& distribution = uncert_analysis.distribution();
+    Put<std::uint32_t>(distribution.size());
+    for (const std::pair<double, double>& bin : distribution)
+      Put(bin.first);
+    for (const std::pair<double, double>& bin : distribution)
+      Put(bin.second);
+  }
+
+  /// Writes the value in the host byte order.
+  template <typename T>
+  void Put(T value) {
+    static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>);
+    Write(&value, sizeof(value));
+  }
+
+  /// Writes the size-prefixed string.
+  void PutString(std::string_view text) {
+    Put<std::uint32_t>(text.size());
+    Write(text);
+  }
+
+  bool probability_analysis_;  ///< The sequence values are meaningful.
+  int target_ = -1;  ///< The number of the current target.
+};
+
+}  // namespace
+
+std::unique_ptr<CompactReporter> CompactReporter::Create(
+    Format format, bool probability_analysis,
+    std::unique_ptr<xml::Output> output) {
+  switch (format) {
+    case kJsonLines:
+      return std::make_unique<JsonLinesReporter>(probability_analysis,
+                                                 std::move(output));
+    case kColumnar:
+      return std::make_unique<ColumnarReporter>(probability_analysis,
+                                                std::move(output));
+  }
+  assert(false && "Unknown report format.");
+  return nullptr;
+}
+
+CompactReporter::CompactReporter(std::unique_ptr<xml::Output> output)
+    : output_(std::move(output)), buffer_(kBufferSize) {}
+
+void CompactReporter::Report(const core::RiskAnalysis& risk_an) {
+  TIMER(DEBUG1, "Reporting analysis results");
+  for (const core::RiskAnalysis::EtaResult& result :
+       risk_an.event_tree_results()) {
+    Consume(result);
+  }
+  for (const core::RiskAnalysis::Result& result : risk_an.results())
+    Consume(result);
+}
+
+void CompactReporter::Finish() {
+  End();
+  output_->Write(buffer_.data(), size_);
+  size_ = 0;
+  if (int err = output_->Finish())
+    SCRAM_THROW(IOError("FILE error on write")) << boost::errinfo_errno(err);
+}
+
+void CompactReporter::Flush(const void* data, std::size_t size) {
+  output_->Write(buffer_.data(), size_);
+  size_ = 0;
+  if (size >= buffer_.size()) {
+    output_->Write(static_cast<const char*>(data), size);
+  } else {
+    std::memcpy(buffer_.data(), data, size);
+    size_ = size;
+  }
+}
+
+}  // namespace scram
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Reporters of results in compact machine-readable formats.
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "risk_analysis.h"
+#include "xml_stream.h"
+
+namespace scram {
+
+/// Reporter of analysis results for downstream tools
+/// that do not need the verbose XML report.
+///
+/// The products are written directly from the product container
+/// into the output buffer without intermediate strings or documents.
+/// The reporter is also the sink of the streamed analysis results.
+///
+/// The probability curves and safety integrity levels are XML-only.
+class CompactReporter : public core::RiskAnalysis::Sink {
+ public:
+  /// The compact report formats.
+  enum Format {
+    /// A JSON object per line
+    /// with the target results referencing the target by its number.
+    kJsonLines,
+    /// Binary tables of the results in the host byte order
+    /// with the products as index arrays into the event name dictionary.
+    kColumnar
+  };
+
+  /// Creates the reporter and writes the report header.
+  ///
+  /// @param[in] format  The report format.
+  /// @param[in] probability_analysis  The indication of the probability
+  ///                                  analysis of event tree sequences.
+  /// @param[in] output  The destination of the report.
+  ///
+  /// @returns The reporter ready to consume the results.
+  static std::unique_ptr<CompactReporter> Create(
+      Format format, bool probability_analysis,
+      std::unique_ptr<xml::Output> output);
+
+  virtual ~CompactReporter() = default;
+
+  /// Reports all the results of the complete analysis.
+  ///
+  /// @param[in] risk_an  Risk analysis with results.
+  void Report(const core::RiskAnalysis& risk_an);
+
+  /// Completes the report.
+  ///
+  /// @throws IOError  The write operation has failed.
+  ///
+  /// @post No more results are accepted.
+  void Finish();
+
+ protected:
+  /// @param[in] output  The destination of the report.
+  explicit CompactReporter(std::unique_ptr<xml::Output> output);
+
+  /// Writes the data into the buffered output.
+  ///
+  /// @param[in] data  The beginning of the data.
+  /// @param[in] size  The number of bytes to write.
+  void Write(const void* data, std::size_t size) {
+    if (buffer_.size() - size_ < size) {
+      Flush(data, size);
+    } else {
+      std::memcpy(buffer_.data() + size_, data, size);
+      size_ += size;
+    }
+  }
+
+  /// Writes the text as is.
+  void Write(std::string_view text) { Write(text.data(), text.size()); }
+
+  /// Writes the trailer of the report.
+  virtual void End() {}
+
+ private:
+  /// Writes the buffer into the output together with the overflow data.
+  ///
+  /// @param[in] data  The beginning of the data not fitting into the buffer.
+  /// @param[in] size  The number of bytes of the data.
+  void Flush(const void* data, std::size_t size);
+
+  std::unique_ptr<xml::Output> output_;  ///< The report destination.
+  std::vector<char> buffer_;  ///< The buffer of output blocks.
+  std::size_t size_ = 0;  ///< The number of bytes in the buffer.
+};
+
+}  // namespace scram
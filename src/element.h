@@ -40,6 +40,7 @@
 #include "error.h"
 #include "ext/linear_set.h"
 #include "ext/multi_index.h"
+#include "symbol.h"
 
 namespace scram::mef {
 
@@ -158,22 +159,22 @@ class Element : public ContainerElement, private boost::noncopyable {
   ///
   /// @throws LogicError  The name is required and empty.
   /// @throws ValidityError  The name is malformed.
-  explicit Element(std::string name);
+  explicit Element(std::string_view name);
 
   /// @returns The original name.
-  const std::string& name() const { return name_; }
+  const std::string& name() const { return name_.str(); }
 
-  /// @returns The string view to the name for table keys.
-  std::string_view name_view() const { return name_; }
+  /// @returns The interned name for table keys.
+  Symbol name_symbol() const { return name_; }
 
   /// @returns The empty or preset label.
   /// @returns Empty string if the label has not been set.
-  const std::string& label() const { return label_; }
+  const std::string& label() const { return label_.str(); }
 
   /// Sets the element label.
   ///
   /// @param[in] label  The extra description for the element.
-  void label(std::string label) { label_ = std::move(label); }
+  void label(std::string_view label) { label_ = Symbol::Intern(label); }
 
   /// @returns The current set of element attributes (non-inherited!).
   ///
@@ -231,11 +232,11 @@ class Element : public ContainerElement, private boost::noncopyable {
   ///
   /// @throws LogicError  The name is required and empty.
   /// @throws ValidityError  The name is malformed.
-  void name(std::string name);
+  void name(std::string_view name);
 
  private:
-  std::string name_;  ///< The original name of the element.
-  std::string label_;  ///< The label text for the element.
+  Symbol name_;  ///< The interned original name of the element.
+  Symbol label_;  ///< The interned label text or null for no label.
 
   /// Element attributes ordered by insertion time.
   /// The attributes are unique by their names.
@@ -251,9 +252,9 @@ class Element : public ContainerElement, private boost::noncopyable {
 template <typename T>
 using ElementTable = boost::multi_index_container<
     T, boost::multi_index::indexed_by<boost::multi_index::hashed_unique<
-           boost::multi_index::const_mem_fun<Element, std::string_view,
-                                             &Element::name_view>,
-           std::hash<std::string_view>>>>;
+           boost::multi_index::const_mem_fun<Element, Symbol,
+                                             &Element::name_symbol>,
+           std::hash<Symbol>>>>;
 
 /// Role, access attributes for elements.
 enum class RoleSpecifier : std::uint8_t { kPublic, kPrivate };
@@ -274,19 +275,19 @@ class Role {
   /// @throws ValidityError  The base path string is malformed.
   /// @throws ValidityError  Private element at model/global scope.
   explicit Role(RoleSpecifier role = RoleSpecifier::kPublic,
-                std::string base_path = "");
+                std::string_view base_path = "");
 
   /// @returns The assigned role of the element.
   RoleSpecifier role() const { return kRole_; }
 
   /// @returns The base path containing ancestor container names.
-  const std::string& base_path() const { return kBasePath_; }
+  const std::string& base_path() const { return kBasePath_.str(); }
 
  protected:
   ~Role() = default;
 
  private:
-  const std::string kBasePath_;  ///< A series of ancestor containers.
+  const Symbol kBasePath_;  ///< Interned ancestor containers.
   const RoleSpecifier kRole_;  ///< The role of the element.
 };
 
@@ -311,20 +312,22 @@ class Id : public Element, public Role {
   /// Mangles the element name into a unique id.
   /// Private elements get their full path as their ids,
   /// while public elements retain their name as ids.
-  explicit Id(std::string name, std::string base_path = "",
+  explicit Id(std::string_view name, std::string_view base_path = "",
               RoleSpecifier role = RoleSpecifier::kPublic);
 
   /// @returns The unique id that is set upon the construction of this element.
   const std::string& id() const {
-    return Role::role() == RoleSpecifier::kPublic ? Element::name()
-                                                  : full_path_;
+    return id_symbol().str();
   }
 
-  /// @returns The string view to the id to be used as a table key.
-  std::string_view id_view() const { return id(); }
+  /// @returns The interned id to be used as a table key.
+  Symbol id_symbol() const {
+    return Role::role() == RoleSpecifier::kPublic ? Element::name_symbol()
+                                                  : full_path_;
+  }
 
-  /// @returns The string view to the unique full path for a table key.
-  std::string_view full_path() const { return full_path_; }
+  /// @returns The interned unique full path for a table key.
+  Symbol full_path() const { return full_path_; }
 
   /// Resets the element ID.
   ///
@@ -334,7 +337,7 @@ class Id : public Element, public Role {
   ///
   /// @throws LogicError  The name is empty.
   /// @throws ValidityError  The name is malformed.
-  void id(std::string name);
+  void id(std::string_view name);
 
   /// Produces unique name for the model element within the same type.
   /// @{
@@ -350,7 +353,8 @@ class Id : public Element, public Role {
   ~Id() = default;
 
  private:
-  std::string full_path_;  ///< Unique for all elements per certain type.
+  /// The interned path unique for all elements per certain type.
+  Symbol full_path_;
 };
 
 /// Table of elements with unique ids.
@@ -363,8 +367,8 @@ template <typename T>
 using IdTable = boost::multi_index_container<
     T,
     boost::multi_index::indexed_by<boost::multi_index::hashed_unique<
-        boost::multi_index::const_mem_fun<Id, std::string_view, &Id::id_view>,
-        std::hash<std::string_view>>>>;
+        boost::multi_index::const_mem_fun<Id, Symbol, &Id::id_symbol>,
+        std::hash<Symbol>>>>;
 
 /// Wraps the element container tables into ranges of plain references
 /// to hide the memory smart or raw pointers.
@@ -431,6 +435,21 @@ class TableRange {
   iterator cend() const { return table_.end(); }
   /// @}
 
+  /// Lookups by strings in tables keyed by symbols.
+  /// The string is converted into the symbol once for the lookup.
+  /// @{
+  template <class K = key_type,
+            typename = std::enable_if_t<std::is_same_v<K, Symbol>>>
+  std::size_t count(std::string_view key) const {
+    return table_.count(Symbol(key));
+  }
+  template <class K = key_type,
+            typename = std::enable_if_t<std::is_same_v<K, Symbol>>>
+  iterator find(std::string_view key) const {
+    return table_.find(Symbol(key));
+  }
+  /// @}
+
  private:
   T& table_;  ///< The associative table being wrapped by this range.
 };
@@ -469,8 +488,8 @@ class Container {
   ///
   /// @throws UndefinedElement  The element is not found.
   /// @{
-  const T& Get(const key_type& id) const {
-    auto it = table_.find(id);
+  const T& Get(std::string_view id) const {
+    auto it = table_.find(Symbol(id));
     if (it != table_.end())
       return **it;
 
@@ -479,7 +498,7 @@ class Container {
         << errinfo_container(Id::unique_name(static_cast<const Self&>(*this)),
                              Self::kTypeString);
   }
-  T& Get(const key_type& id) {
+  T& Get(std::string_view id) {
     return const_cast<T&>(std::as_const(*this).Get(id));
   }
   /// @}
@@ -510,11 +529,11 @@ class Container {
   /// @throws UndefinedElement  The element cannot be found in the container.
   /// @throws LogicError  The element in the container is not the same object.
   Pointer Remove(T* element) {
-    const std::string& key = [element]() -> decltype(auto) {
+    Symbol key = [element] {
       if constexpr (ById) {
-        return element->id();
+        return element->id_symbol();
       } else {
-        return element->name();
+        return element->name_symbol();
       }
     }();
 
@@ -613,12 +632,12 @@ class Composite : public Ts... {
   /// @{
   template <class T,
             class ContainerType = typename detail::container_of<T, Ts...>::type>
-  const T& Get(const typename ContainerType::key_type& id) const {
+  const T& Get(std::string_view id) const {
     return ContainerType::Get(id);
   }
   template <class T,
             class ContainerType = typename detail::container_of<T, Ts...>::type>
-  T& Get(const typename ContainerType::key_type& id) {
+  T& Get(std::string_view id) {
     return ContainerType::Get(id);
   }
   /// @}
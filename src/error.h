@@ -106,6 +106,11 @@ struct VersionError : public Error {
   using Error::Error;
 };
 
+/// The analysis is cancelled upon the request of the user.
+struct CancelError : public Error {
+  using Error::Error;
+};
+
 namespace mef {  // MEF specific errors.
 
 /// The MEF container element as namespace.
@@ -25,6 +25,7 @@
 #include <boost/range/algorithm.hpp>
 
 #include "error.h"
+#include "expression/tape.h"
 #include "ext/algorithm.h"
 #include "ext/variant.h"
 
@@ -49,6 +50,18 @@ void BasicEvent::Validate() const {
   }
 }
 
+std::vector<double>
+BasicEvent::p(const std::vector<double>& time_points) const {
+  assert(expression_ && "The basic event's expression is not set.");
+  ExpressionTape tape({expression_});
+  tape.Evaluate(time_points);
+  std::vector<double> probabilities;
+  probabilities.reserve(time_points.size());
+  for (int i = 0; i < tape.num_lanes(); ++i)
+    probabilities.push_back(tape.value(0, i));
+  return probabilities;
+}
+
 void Formula::ArgSet::Add(ArgEvent event, bool complement) {
   Event* base = ext::as<Event*>(event);
   if (ext::any_of(args_, [&base](const Arg& arg) {
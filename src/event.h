@@ -112,6 +112,16 @@ class BasicEvent : public Event {
     return expression_->value();
   }
 
+  /// Evaluates the mean probability of this basic event
+  /// over mission time points in a single batch.
+  ///
+  /// @param[in] time_points  The non-empty collection of non-negative times.
+  ///
+  /// @returns The probabilities at the corresponding time points.
+  ///
+  /// @pre The expression has been set.
+  std::vector<double> p(const std::vector<double>& time_points) const;
+
   /// Validates the probability expressions for the primary event.
   ///
   /// @pre The probability expression is set.
@@ -19,6 +19,10 @@
 
 #include "event_tree_analysis.h"
 
+#include <algorithm>
+#include <map>
+#include <tuple>
+
 #include "expression/numerical.h"
 #include "ext/find_iterator.h"
 #include "instruction.h"
@@ -32,217 +36,464 @@ EventTreeAnalysis::EventTreeAnalysis(
       initiating_event_(initiating_event),
       context_(context) {}
 
-namespace {  // The model cloning functions.
-
-/// Clones the formula by applying the set-instructions.
-///
-/// @param[in] formula  The formula to be deep-cloned.
-/// @param[in] set_instructions  The set instructions to change arguments.
-/// @param[in] clones  The storage container for newly created clones.
+/// Conditions collected formulas on house-event set-instructions
+/// without deep copies of the model.
 ///
-/// @returns The deep-copy of the argument formula with new (changed) arguments.
-std::unique_ptr<mef::Formula>
-Clone(const mef::Formula& formula,
-      const std::unordered_map<std::string, bool>& set_instructions,
-      std::vector<std::unique_ptr<mef::Event>>* clones) noexcept {
-  struct {
-    mef::Formula::ArgEvent operator()(mef::BasicEvent* arg) { return arg; }
-    mef::Formula::ArgEvent operator()(mef::HouseEvent* arg) {
-      if (auto it = ext::find(set_house, arg->id())) {
-        if (it->second == arg->state())
-          return arg;
-        auto clone = std::make_unique<mef::HouseEvent>(
-            arg->name(), "__clone__." + arg->id(),
-            mef::RoleSpecifier::kPrivate);
-        clone->state(it->second);
-        auto* ptr = clone.get();
-        event_register->emplace_back(std::move(clone));
-        return ptr;
+/// Only the gates reaching the changed house events are cloned.
+/// The clones are hash-consed by the source and the set-instructions,
+/// so the paths with the same conditions share the clones
+/// as well as the gates of the collected formulas.
+class EventTreeAnalysis::Conditioner {
+ public:
+  /// @param[in,out] eta  The host analysis to register new events.
+  explicit Conditioner(EventTreeAnalysis* eta) : eta_(*eta) {}
+
+  /// @param[in] instruction  The formula collection instruction.
+  /// @param[in] changes  The interned house-event states to apply.
+  ///
+  /// @returns The gate of the conditioned collected formula.
+  mef::Gate* operator()(const mef::CollectFormula& instruction, int changes) {
+    mef::Gate*& gate = formula_gates_[{&instruction, changes}];
+    if (!gate) {
+      mef::FormulaPtr formula = Condition(instruction.formula(), changes);
+      const mef::Formula& result = formula ? *formula : instruction.formula();
+      const mef::Formula::Arg& front = result.args().front();
+      if (result.connective() == mef::kNull && !front.complement &&
+          std::holds_alternative<mef::Gate*>(front.event)) {
+        gate = std::get<mef::Gate*>(front.event);
+      } else {
+        gate = MakeGate(formula ? std::move(formula)
+                                : std::make_unique<mef::Formula>(result));
       }
-      return arg;
-    }
-    mef::Formula::ArgEvent operator()(mef::Gate* arg) {
-      if (set_house.empty())
-        return arg;
-      auto clone = std::make_unique<mef::Gate>(
-          arg->name(), "__clone__." + arg->id(), mef::RoleSpecifier::kPrivate);
-      clone->formula(Clone(arg->formula(), set_house, event_register));
-      auto* ptr = clone.get();
-      event_register->emplace_back(std::move(clone));
-      return ptr;
-    }
-
-    const std::unordered_map<std::string, bool>& set_house;
-    std::vector<std::unique_ptr<mef::Event>>* event_register;
-  } cloner{set_instructions, clones};
-
-  mef::Formula::ArgSet arg_set;
-  for (const mef::Formula::Arg& arg : formula.args())
-    arg_set.Add(std::visit(cloner, arg.event), arg.complement);
-
-  return std::make_unique<mef::Formula>(
-      formula.connective(), std::move(arg_set), formula.min_number(),
-      formula.max_number());
-}
+    }
+    return gate;
+  }
 
-}  // namespace
+  /// Joins gates with a connective into a shared internal gate.
+  ///
+  /// @param[in] connective  The AND or OR connective.
+  /// @param[in] args  The non-empty gate arguments.
+  ///
+  /// @returns The gate equivalent to the same join of the same arguments,
+  ///          or the argument itself if it is the only one.
+  mef::Gate* Join(mef::Connective connective, std::vector<mef::Gate*> args) {
+    assert(!args.empty());
+    std::sort(args.begin(), args.end());
+    args.erase(std::unique(args.begin(), args.end()), args.end());
+    if (args.size() == 1)
+      return args.front();
+    mef::Gate*& gate = joins_[{connective, args}];
+    if (!gate) {
+      gate = MakeGate(std::make_unique<mef::Formula>(
+          connective, mef::Formula::ArgSet(args.begin(), args.end())));
+    }
+    return gate;
+  }
 
-EventTreeAnalysis::PathCollector::PathCollector(const PathCollector& other)
-    : expressions(other.expressions), set_instructions(other.set_instructions) {
-  for (const mef::FormulaPtr& formula : other.formulas)
-    formulas.push_back(std::make_unique<mef::Formula>(*formula));
-}
+  /// @param[in] set_instructions  The house-event states of a path.
+  ///
+  /// @returns The unique identifier of the set-instructions (0 if empty).
+  int Intern(const std::unordered_map<mef::Symbol, bool>& set_instructions) {
+    if (set_instructions.empty())
+      return 0;
+    Changes changes(set_instructions.begin(), set_instructions.end());
+    std::sort(changes.begin(), changes.end());
+    auto [it, is_new] = ids_.emplace(std::move(changes), changes_.size() + 1);
+    if (is_new)
+      changes_.push_back(&it->first);
+    return it->second;
+  }
 
-void EventTreeAnalysis::Analyze() noexcept {
-  assert(initiating_event_.event_tree());
-  int formula_id = 0;  // Enumeration of collected formulas turned into gates.
-  // Creates an internal gate representing the formula.
-  auto make_gate = [&formula_id, this](mef::FormulaPtr formula) {
-    std::string gate_name = "___" + initiating_event_.name() + "__formula_" +
-                            std::to_string(formula_id++) + "__";
+ private:
+  /// The set-instructions of paths sorted by the house-event symbol ids.
+  using Changes = std::vector<std::pair<mef::Symbol, bool>>;
+
+  /// Creates an internal gate representing the formula.
+  ///
+  /// @param[in] formula  The formula of the new gate.
+  ///
+  /// @returns The new gate registered in the analysis.
+  mef::Gate* MakeGate(mef::FormulaPtr formula) {
+    std::string gate_name = "___" + eta_.initiating_event_.name() +
+                            "__formula_" + std::to_string(num_gates_++) + "__";
     auto gate = std::make_unique<mef::Gate>(gate_name);
     gate->formula(std::move(formula));
     auto* address = gate.get();
-    events_.emplace_back(std::move(gate));
+    eta_.events_.emplace_back(std::move(gate));
     return address;
-  };
+  }
+
+  /// @returns The formula with the conditioned arguments,
+  ///          or nullptr if no argument is affected by the changes.
+  mef::FormulaPtr Condition(const mef::Formula& formula, int changes) {
+    if (!changes)
+      return nullptr;
+    std::vector<mef::Formula::ArgEvent> args;
+    bool conditioned = false;
+    for (const mef::Formula::Arg& arg : formula.args()) {
+      args.push_back(std::visit(
+          [this, changes](auto* event) -> mef::Formula::ArgEvent {
+            return Condition(event, changes);
+          },
+          arg.event));
+      conditioned |= args.back() != arg.event;
+    }
+    if (!conditioned)
+      return nullptr;
+    mef::Formula::ArgSet arg_set;
+    for (int i = 0; i < args.size(); ++i)
+      arg_set.Add(args[i], formula.args()[i].complement);
+    return std::make_unique<mef::Formula>(
+        formula.connective(), std::move(arg_set), formula.min_number(),
+        formula.max_number());
+  }
+
+  /// @returns The gate itself if its sub-graph is unaffected by the changes.
+  mef::Gate* Condition(mef::Gate* gate, int changes) {
+    if (auto it = ext::find(gates_, std::make_pair(gate, changes)))
+      return it->second;
+    mef::Gate* result = gate;
+    if (mef::FormulaPtr formula = Condition(gate->formula(), changes)) {
+      auto clone = std::make_unique<mef::Gate>(gate->name(),
+                                               "__clone__." + gate->id(),
+                                               mef::RoleSpecifier::kPrivate);
+      clone->formula(std::move(formula));
+      result = clone.get();
+      eta_.events_.emplace_back(std::move(clone));
+    }
+    gates_.emplace(std::make_pair(gate, changes), result);
+    return result;
+  }
+
+  /// @returns The house event with the changed state.
+  mef::HouseEvent* Condition(mef::HouseEvent* house_event, int changes) {
+    const Changes& instructions = *changes_[changes - 1];
+    mef::Symbol id = house_event->id_symbol();
+    auto it = std::lower_bound(
+        instructions.begin(), instructions.end(), id,
+        [](const auto& entry, mef::Symbol key) { return entry.first < key; });
+    if (it == instructions.end() || it->first != id ||
+        it->second == house_event->state()) {
+      return house_event;
+    }
+    mef::HouseEvent*& clone = house_events_[{house_event, it->second}];
+    if (!clone) {
+      auto event = std::make_unique<mef::HouseEvent>(
+          house_event->name(), "__clone__." + house_event->id(),
+          mef::RoleSpecifier::kPrivate);
+      event->state(it->second);
+      clone = event.get();
+      eta_.events_.emplace_back(std::move(event));
+    }
+    return clone;
+  }
 
-  SequenceCollector collector{initiating_event_, *context_};
+  /// Basic events are independent of house events.
+  mef::BasicEvent* Condition(mef::BasicEvent* basic_event, int) {
+    return basic_event;
+  }
+
+  EventTreeAnalysis& eta_;  ///< The host analysis.
+  int num_gates_ = 0;  ///< The enumeration of the collected formula gates.
+  std::map<Changes, int> ids_;  ///< The interned set-instructions.
+  std::vector<const Changes*> changes_;  ///< The set-instructions by ids.
+  /// The gates of collected formulas by their instructions and conditions.
+  std::map<std::pair<const mef::CollectFormula*, int>, mef::Gate*>
+      formula_gates_;
+  /// The joined gates by their connectives and sorted arguments.
+  std::map<std::pair<mef::Connective, std::vector<mef::Gate*>>, mef::Gate*>
+      joins_;
+  /// The conditioned gates by their sources and conditions.
+  std::map<std::pair<mef::Gate*, int>, mef::Gate*> gates_;
+  /// The house event clones by their sources and states.
+  std::map<std::pair<mef::HouseEvent*, bool>, mef::HouseEvent*> house_events_;
+};
+
+void EventTreeAnalysis::Analyze() noexcept {
+  assert(initiating_event_.event_tree());
+  Conditioner conditioner(this);
+  SequenceCollector collector{initiating_event_, *context_, conditioner};
   CollectSequences(initiating_event_.event_tree()->initial_state(), &collector);
-  for (auto& sequence : collector.sequences) {
-    auto gate = std::make_unique<mef::Gate>("__" + sequence.first->name());
-    std::vector<mef::FormulaPtr> gate_formulas;
-    std::vector<mef::Expression*> arg_expressions;
-    for (PathCollector& path_collector : sequence.second) {
-      if (path_collector.formulas.size() == 1) {
-        gate_formulas.push_back(std::move(path_collector.formulas.front()));
-      } else if (path_collector.formulas.size() > 1) {
-        mef::Formula::ArgSet arg_set;
-        for (mef::FormulaPtr& arg_formula : path_collector.formulas)
-          arg_set.Add(make_gate(std::move(arg_formula)));
-
-        gate_formulas.push_back(
-            std::make_unique<mef::Formula>(mef::kAnd, std::move(arg_set)));
-      }
-      if (path_collector.expressions.size() == 1) {
-        arg_expressions.push_back(path_collector.expressions.front());
-      } else if (path_collector.expressions.size() > 1) {
-        expressions_.push_back(
-            std::make_unique<mef::Mul>(std::move(path_collector.expressions)));
-        arg_expressions.push_back(expressions_.back().get());
-      }
+  std::unordered_map<const mef::Sequence*, mef::Expression*> expressions;
+  for (auto& [sequence, path_collector] : collector.sequences) {
+    auto gate = std::make_unique<mef::Gate>("__" + sequence->name());
+    assert(path_collector.formulas.empty() ||
+           path_collector.expressions.empty());
+    bool is_expression_only = !path_collector.expressions.empty();
+    if (!path_collector.formulas.empty()) {
+      gate->formula(std::make_unique<mef::Formula>(
+          mef::kNull, mef::Formula::ArgSet{conditioner.Join(
+                          mef::kAnd, std::move(path_collector.formulas))}));
+    } else if (!path_collector.expressions.empty()) {
+      auto event = std::make_unique<mef::BasicEvent>("__" + sequence->name());
+      event->expression(Multiply(std::move(path_collector.expressions)));
+      expressions.emplace(sequence, &event->expression());
+      gate->formula(std::make_unique<mef::Formula>(
+          mef::kNull, mef::Formula::ArgSet{event.get()}));
+      events_.push_back(std::move(event));
+    } else {
+      gate->formula(std::make_unique<mef::Formula>(
+          mef::kNull, mef::Formula::ArgSet{&mef::HouseEvent::kTrue}));
+    }
+    sequences_.push_back({*sequence, std::move(gate), is_expression_only});
+  }
+
+  std::map<std::string, std::vector<const Result*>> end_states;
+  for (const Result& result : sequences_) {
+    if (const mef::Attribute* end_state =
+            result.sequence.GetAttribute("end-state")) {
+      end_states[end_state->value()].push_back(&result);
     }
-    assert(gate_formulas.empty() || arg_expressions.empty());
-    bool is_expression_only = !arg_expressions.empty();
-    if (gate_formulas.size() == 1) {
-      gate->formula(std::move(gate_formulas.front()));
-    } else if (gate_formulas.size() > 1) {
-      mef::Formula::ArgSet arg_set;
-      for (mef::FormulaPtr& arg_formula : gate_formulas)
-        arg_set.Add(make_gate(std::move(arg_formula)));
-
-      gate->formula(
-          std::make_unique<mef::Formula>(mef::kOr, std::move(arg_set)));
-    } else if (!arg_expressions.empty()) {
-      auto event =
-          std::make_unique<mef::BasicEvent>("__" + sequence.first->name());
-      if (arg_expressions.size() == 1) {
-        event->expression(arg_expressions.front());
-      } else if (arg_expressions.size() > 1) {
-        expressions_.push_back(
-            std::make_unique<mef::Add>(std::move(arg_expressions)));
-        event->expression(expressions_.back().get());
+  }
+  for (auto& [name, results] : end_states) {
+    auto gate = std::make_unique<mef::Gate>("__end-state__" + name);
+    std::vector<const mef::Sequence*> sequences;
+    mef::Formula::ArgSet args;
+    std::vector<mef::Expression*> terms;
+    bool is_expression_only = true;
+    for (const Result* result : results) {
+      sequences.push_back(&result->sequence);
+      args.Add(result->gate.get());
+      if (result->is_expression_only) {
+        terms.push_back(expressions.at(&result->sequence));
+      } else {
+        is_expression_only = false;
       }
+    }
+    if (is_expression_only) {
+      // The paths of expression-only sequences are mutually exclusive.
+      auto event = std::make_unique<mef::BasicEvent>("__end-state__" + name);
+      event->expression(Add(std::move(terms)));
       gate->formula(std::make_unique<mef::Formula>(
           mef::kNull, mef::Formula::ArgSet{event.get()}));
       events_.push_back(std::move(event));
     } else {
       gate->formula(std::make_unique<mef::Formula>(
-          mef::kNull, mef::Formula::ArgSet{&mef::HouseEvent::kTrue}));
+          sequences.size() == 1 ? mef::kNull : mef::kOr, std::move(args)));
     }
-    sequences_.push_back(
-        {*sequence.first, std::move(gate), is_expression_only});
+    end_states_.push_back({name, std::move(sequences), std::move(gate),
+                           is_expression_only});
   }
 }
 
+mef::Expression*
+EventTreeAnalysis::Multiply(std::vector<mef::Expression*> args) noexcept {
+  assert(!args.empty());
+  if (args.size() == 1)
+    return args.front();
+  expressions_.push_back(std::make_unique<mef::Mul>(std::move(args)));
+  return expressions_.back().get();
+}
+
+mef::Expression*
+EventTreeAnalysis::Add(std::vector<mef::Expression*> args) noexcept {
+  assert(!args.empty());
+  if (args.size() == 1)
+    return args.front();
+  expressions_.push_back(std::make_unique<mef::Add>(std::move(args)));
+  return expressions_.back().get();
+}
+
 void EventTreeAnalysis::CollectSequences(const mef::Branch& initial_state,
                                          SequenceCollector* result) noexcept {
+  /// The collapsed paths to sequences from a branch.
+  using Suffix = std::unordered_map<const mef::Sequence*, PathCollector>;
+  /// The memoization key of a branch traversal:
+  /// the branch, the interned set-instructions,
+  /// and the functional-event states if the branch tests them.
+  using State = std::tuple<const mef::Branch*, int,
+                           std::vector<std::pair<std::string, std::string>>>;
+
   struct Collector {
     class Visitor : public mef::InstructionVisitor {
      public:
-      explicit Visitor(Collector* collector) : collector_(*collector) {}
+      Visitor(Collector* collector, PathCollector* segment)
+          : collector_(*collector), segment_(*segment) {}
 
       void Visit(const mef::SetHouseEvent* house_event) override {
-        collector_.path_collector_.set_instructions[house_event->name()] =
-            house_event->state();
+        segment_.set_instructions[house_event->symbol()] = house_event->state();
       }
 
       void Visit(const mef::Link* link) override {
         is_linked_ = true;
-        Collector continue_connector(collector_);
+        // The linked tree starts with its own functional-event states.
         auto save = std::move(collector_.result_->context.functional_events);
-        continue_connector(&link->event_tree().initial_state());
+        bool tests_context = collector_.tests_context_;
+        collector_.Append(segment_, collector_.Walk(
+                                        link->event_tree().initial_state(),
+                                        segment_.set_instructions));
+        collector_.tests_context_ = tests_context;
         collector_.result_->context.functional_events = std::move(save);
       }
 
       void Visit(const mef::CollectFormula* collect_formula) override {
-        // clang-format off
-        collector_.path_collector_.formulas.push_back(
-            core::Clone(collect_formula->formula(),
-                        collector_.path_collector_.set_instructions,
-                        collector_.clones_));
-        // clang-format on
+        segment_.formulas.push_back(collector_.result_->conditioner(
+            *collect_formula,
+            collector_.result_->conditioner.Intern(segment_.set_instructions)));
       }
 
       void Visit(const mef::CollectExpression* collect_expression) override {
-        collector_.path_collector_.expressions.push_back(
-            &collect_expression->expression());
+        segment_.expressions.push_back(&collect_expression->expression());
+      }
+
+      void Visit(const mef::IfThenElse* ite) override {
+        collector_.tests_context_ = true;
+        mef::InstructionVisitor::Visit(ite);
       }
 
       bool is_linked() const { return is_linked_; }
 
      private:
       Collector& collector_;
+      PathCollector& segment_;  ///< The path segment of the current branch.
       bool is_linked_ = false;  /// Indicate that sequences not be registered.
     };
 
-    void operator()(const mef::Sequence* sequence) {
-      Visitor visitor(this);
+    /// Collects the collapsed paths from the branch in the current state.
+    ///
+    /// @param[in] branch  The branch to start the traversal.
+    /// @param[in] set_instructions  The house-event states before the branch.
+    ///
+    /// @returns The memoized paths from the branch to sequences.
+    const Suffix&
+    Walk(const mef::Branch& branch,
+         const std::unordered_map<mef::Symbol, bool>& set_instructions) {
+      State state{&branch, result_->conditioner.Intern(set_instructions), {}};
+      auto it_test = tests_context_by_branch_.find(&branch);
+      if (it_test != tests_context_by_branch_.end() && it_test->second) {
+        const auto& events = result_->context.functional_events;
+        std::get<2>(state).assign(events.begin(), events.end());
+        std::sort(std::get<2>(state).begin(), std::get<2>(state).end());
+      }
+      if (auto it = ext::find(suffixes_, state)) {
+        assert(it_test != tests_context_by_branch_.end());
+        tests_context_ |= it_test->second;
+        return it->second;
+      }
+
+      Collector collector{eta_, result_, suffixes_, tests_context_by_branch_};
+      PathCollector segment;
+      segment.set_instructions = set_instructions;
+      Visitor visitor(&collector, &segment);
+      for (const mef::Instruction* instruction : branch.instructions())
+        instruction->Accept(&visitor);
+      std::visit([&collector, &segment](auto* target) {
+        collector.Continue(target, &segment);
+      }, branch.target());
+
+      if (it_test == tests_context_by_branch_.end()) {
+        tests_context_by_branch_.emplace(&branch, collector.tests_context_);
+        if (collector.tests_context_) {
+          const auto& events = result_->context.functional_events;
+          std::get<2>(state).assign(events.begin(), events.end());
+          std::sort(std::get<2>(state).begin(), std::get<2>(state).end());
+        }
+      }
+      tests_context_ |= collector.tests_context_;
+      return suffixes_.emplace(std::move(state), collector.Collapse())
+          .first->second;
+    }
+
+    void Continue(const mef::Sequence* sequence, PathCollector* segment) {
+      Visitor visitor(this, segment);
       for (const mef::Instruction* instruction : sequence->instructions())
         instruction->Accept(&visitor);
       if (!visitor.is_linked())
-        result_->sequences[sequence].push_back(std::move(path_collector_));
+        alternatives_[sequence].push_back(*segment);
     }
 
-    void operator()(const mef::Fork* fork) const {
+    void Continue(const mef::Fork* fork, PathCollector* segment) {
       const std::string& name = fork->functional_event().name();
       assert(result_->context.functional_events.count(name) == false);
       std::string& state = result_->context.functional_events[name];
       assert(state.empty());
+      // The paths of the fork share the same segment prefix.
+      Collector fork_collector{eta_, result_, suffixes_,
+                               tests_context_by_branch_};
       for (const mef::Path& fork_path : fork->paths()) {
         state = fork_path.state();
-        // clang-format off
-        Collector(*this)(&fork_path);  // NOLINT(runtime/explicit)
-        // clang-format on
+        fork_collector.Append(
+            {}, fork_collector.Walk(fork_path, segment->set_instructions));
       }
       result_->context.functional_events.erase(name);
+      tests_context_ |= fork_collector.tests_context_;
+      Append(*segment, fork_collector.Collapse());
     }
 
-    void operator()(const mef::Branch* branch) {
-      Visitor visitor(this);
-      for (const mef::Instruction* instruction : branch->instructions())
-        instruction->Accept(&visitor);
+    void Continue(const mef::NamedBranch* named_branch,
+                  PathCollector* segment) {
+      Append(*segment, Walk(*named_branch, segment->set_instructions));
+    }
 
-      std::visit(*this, branch->target());
+    /// Registers the paths continuing the prefix.
+    void Append(const PathCollector& prefix, const Suffix& suffix) {
+      for (const auto& [sequence, path_collector] : suffix) {
+        PathCollector path{prefix.expressions, prefix.formulas, {}};
+        if (path_collector.has_empty_alternative)
+          alternatives_[sequence].push_back(path);  // The prefix only.
+        path.expressions.insert(path.expressions.end(),
+                                path_collector.expressions.begin(),
+                                path_collector.expressions.end());
+        path.formulas.insert(path.formulas.end(),
+                             path_collector.formulas.begin(),
+                             path_collector.formulas.end());
+        alternatives_[sequence].push_back(std::move(path));
+      }
+    }
+
+    /// Collapses the alternative paths to each sequence into a single path
+    /// with the OR of the alternative formulas
+    /// and the sum of the alternative expressions.
+    /// Alternatives without formulas or expressions are only flagged
+    /// to continue the prefix as is.
+    Suffix Collapse() {
+      Suffix suffix;
+      for (auto& [sequence, paths] : alternatives_) {
+        PathCollector& collapsed = suffix[sequence];
+        if (paths.size() == 1) {
+          collapsed.expressions = std::move(paths.front().expressions);
+          collapsed.formulas = std::move(paths.front().formulas);
+          continue;
+        }
+        std::vector<mef::Gate*> gates;
+        std::vector<mef::Expression*> expressions;
+        for (PathCollector& path : paths) {
+          if (path.formulas.empty() && path.expressions.empty())
+            collapsed.has_empty_alternative = true;
+          if (!path.formulas.empty()) {
+            gates.push_back(
+                result_->conditioner.Join(mef::kAnd, std::move(path.formulas)));
+          }
+          if (!path.expressions.empty())
+            expressions.push_back(eta_.Multiply(std::move(path.expressions)));
+        }
+        if (!gates.empty())
+          collapsed.formulas.push_back(
+              result_->conditioner.Join(mef::kOr, std::move(gates)));
+        if (!expressions.empty())
+          collapsed.expressions.push_back(eta_.Add(std::move(expressions)));
+        if (collapsed.formulas.empty() && collapsed.expressions.empty())
+          collapsed.has_empty_alternative = false;  // The path is empty.
+      }
+      return suffix;
     }
 
+    EventTreeAnalysis& eta_;  ///< The host of new expressions.
     SequenceCollector* result_;
-    std::vector<std::unique_ptr<mef::Event>>* clones_;
-    PathCollector path_collector_;
+    std::map<State, Suffix>& suffixes_;  ///< The memoized traversals.
+    /// The branches testing functional events in their traversal.
+    std::unordered_map<const mef::Branch*, bool>& tests_context_by_branch_;
+    /// The alternative paths to sequences.
+    std::unordered_map<const mef::Sequence*, std::vector<PathCollector>>
+        alternatives_ = {};
+    bool tests_context_ = false;  ///< Functional events are tested.
   };
+  std::map<State, Suffix> suffixes;
+  std::unordered_map<const mef::Branch*, bool> tests_context_by_branch;
   context_->functional_events.clear();
   context_->initiating_event = initiating_event_.name();
-  Collector{result, &events_}(&initial_state);  // NOLINT(whitespace/braces)
+  Collector collector{*this, result, suffixes, tests_context_by_branch};
+  result->sequences = collector.Walk(initial_state, {});
 }
 
 }  // namespace scram::core
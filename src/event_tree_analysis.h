@@ -44,6 +44,16 @@ class EventTreeAnalysis : public Analysis {
     double p_sequence;  ///< To be assigned by analyses: @todo Remove
   };
 
+  /// The aggregation of sequences with the same end state.
+  /// The end state of a sequence is given by its "end-state" attribute.
+  struct EndState {
+    std::string name;  ///< The end-state attribute value.
+    std::vector<const mef::Sequence*> sequences;  ///< The aggregated sequences.
+    std::unique_ptr<mef::Gate> gate;  ///< The union of the sequence formulas.
+    bool is_expression_only;  ///< Indicator for expression only event trees.
+    double p_end_state;  ///< To be assigned by analyses.
+  };
+
   /// @param[in] initiating_event  The unique initiating event.
   /// @param[in] settings  The analysis settings.
   /// @param[in] context  The context to communicate with test-events.
@@ -66,27 +76,49 @@ class EventTreeAnalysis : public Analysis {
   std::vector<Result>& sequences() { return sequences_; }
   /// @}
 
+  /// @returns The end states of the sequences ordered by name.
+  /// @{
+  const std::vector<EndState>& end_states() const { return end_states_; }
+  std::vector<EndState>& end_states() { return end_states_; }
+  /// @}
+
  private:
+  /// Conditioning of collected formulas on house-event set-instructions.
+  class Conditioner;
+
   /// Expressions and formulas collected in an event tree path.
+  /// The collected formulas are shared between paths,
+  /// so the path is cheap to copy at forks.
+  ///
+  /// The alternative paths from the same branch to the same sequence
+  /// are collapsed into a single path
+  /// with a shared formula gate and a shared expression.
   struct PathCollector {
-    PathCollector() = default;
-    PathCollector(const PathCollector&);  ///< Must deep copy formulas.
     std::vector<mef::Expression*> expressions;  ///< Multiplication arguments.
-    std::vector<mef::FormulaPtr> formulas;  ///< AND connective formulas.
-    std::unordered_map<std::string, bool> set_instructions;  ///< House events.
+    std::vector<mef::Gate*> formulas;  ///< AND connective formula gates.
+    std::unordered_map<mef::Symbol, bool> set_instructions;  ///< House events.
+    /// The collapsed path has an alternative without formulas or expressions,
+    /// which is unconditional after a prefix.
+    bool has_empty_alternative = false;
   };
 
   /// Walks the event tree paths and collects sequences.
   struct SequenceCollector {
     const mef::InitiatingEvent& initiating_event;  ///< The analysis initiator.
     mef::Context& context;  ///< The collection context.
-    /// Sequences with collected paths.
-    std::unordered_map<const mef::Sequence*, std::vector<PathCollector>>
-        sequences;
+    Conditioner& conditioner;  ///< The provider of collected formula gates.
+    /// Sequences with their collapsed paths.
+    std::unordered_map<const mef::Sequence*, PathCollector> sequences;
   };
 
   /// Walks the branch and collects sequences with expressions if any.
   ///
+  /// The traversal of a branch is memoized on its accumulated state,
+  /// i.e., the house-event set-instructions
+  /// and the functional-event states if the branch tests any,
+  /// so the work grows with the number of distinct states
+  /// rather than with the number of paths.
+  ///
   /// @param[in] initial_state  The branch to start the traversal.
   /// @param[in,out] result  The result container for sequences.
   ///
@@ -94,8 +126,20 @@ class EventTreeAnalysis : public Analysis {
   void CollectSequences(const mef::Branch& initial_state,
                         SequenceCollector* result) noexcept;
 
+  /// @param[in] args  The non-empty factors.
+  ///
+  /// @returns The product expression owned by the analysis,
+  ///          or the only factor.
+  mef::Expression* Multiply(std::vector<mef::Expression*> args) noexcept;
+
+  /// @param[in] args  The non-empty terms.
+  ///
+  /// @returns The sum expression owned by the analysis, or the only term.
+  mef::Expression* Add(std::vector<mef::Expression*> args) noexcept;
+
   const mef::InitiatingEvent& initiating_event_;  ///< The analysis initiator.
   std::vector<Result> sequences_;  ///< Gathered sequences.
+  std::vector<EndState> end_states_;  ///< Aggregated sequences.
   /// Newly created expressions.
   std::vector<std::unique_ptr<mef::Expression>> expressions_;
   std::vector<std::unique_ptr<mef::Event>> events_;  ///< Newly created events.
@@ -51,6 +51,10 @@ bool Expression::IsDeviate() noexcept {
   return ext::any_of(args_, [](Expression* arg) { return arg->IsDeviate(); });
 }
 
+bool Expression::IsConstant() noexcept {
+  return ext::all_of(args_, [](Expression* arg) { return arg->IsConstant(); });
+}
+
 namespace detail {
 
 void EnsureMultivariateArgs(std::vector<Expression*> args) {
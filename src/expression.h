@@ -105,6 +105,15 @@ class Expression : private boost::noncopyable {
   ///          may yield silent failure.
   virtual bool IsDeviate() noexcept;
 
+  /// Determines if the value of the expression is constant after validation.
+  /// The default logic is to check all the arguments.
+  /// Derived expression classes must decide
+  /// if their value depends on the mission time, sampling,
+  /// extern functions, or the analysis context.
+  ///
+  /// @returns true if the expression can be folded into its value.
+  virtual bool IsConstant() noexcept;
+
   /// @returns A sampled value of this expression.
   double Sample() noexcept;
 
@@ -178,6 +178,10 @@ double PeriodicTest::InstantRepair::Sample() noexcept {
                  time_.Sample());
 }
 
+double PeriodicTest::InstantRepair::Apply(const double* args) noexcept {
+  return Compute(args[0], args[1], args[2], args[3]);
+}
+
 double PeriodicTest::InstantTest::Compute(double lambda, double mu, double tau,
                                           double theta, double time) noexcept {
   if (time <= theta)  // No test has been performed.
@@ -216,6 +220,10 @@ double PeriodicTest::InstantTest::Sample() noexcept {
                  time_.Sample());
 }
 
+double PeriodicTest::InstantTest::Apply(const double* args) noexcept {
+  return Compute(args[0], args[1], args[2], args[3], args[4]);
+}
+
 double PeriodicTest::Complete::Compute(double lambda, double lambda_test,
                                        double mu, double tau, double theta,
                                        double gamma, double test_duration,
@@ -303,4 +311,9 @@ double PeriodicTest::Complete::Sample() noexcept {
                  sigma_.Sample(), omega_.Sample(), time_.Sample());
 }
 
+double PeriodicTest::Complete::Apply(const double* args) noexcept {
+  return Compute(args[0], args[1], args[2], args[3], args[4], args[5], args[6],
+                 args[7], args[8], args[9], args[10]);
+}
+
 }  // namespace scram::mef
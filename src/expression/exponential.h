@@ -156,6 +156,13 @@ class PeriodicTest : public Expression {
   double value() noexcept override { return flavor_->value(); }
   Interval interval() noexcept override { return Interval::closed(0, 1); }
 
+  /// Computes the expression with the given argument values.
+  ///
+  /// @param[in] args  The argument values in the order of construction.
+  ///
+  /// @returns The probability at the mission time argument value.
+  double Compute(const double* args) noexcept { return flavor_->Apply(args); }
+
  private:
   double DoSample() noexcept override { return flavor_->Sample(); }
 
@@ -168,6 +175,8 @@ class PeriodicTest : public Expression {
     virtual double value() noexcept = 0;
     /// @copydoc Expression::Sample
     virtual double Sample() noexcept = 0;
+    /// @copydoc PeriodicTest::Compute
+    virtual double Apply(const double* args) noexcept = 0;
   };
 
   /// The tests and repairs are instantaneous and always successful.
@@ -181,6 +190,7 @@ class PeriodicTest : public Expression {
     void Validate() const override;
     double value() noexcept override;
     double Sample() noexcept override;
+    double Apply(const double* args) noexcept override;
 
    protected:
     Expression& lambda_;  ///< The failure rate when functioning.
@@ -206,6 +216,7 @@ class PeriodicTest : public Expression {
     void Validate() const override;
     double value() noexcept override;
     double Sample() noexcept override;
+    double Apply(const double* args) noexcept override;
 
    protected:
     Expression& mu_;  ///< The repair rate.
@@ -235,6 +246,7 @@ class PeriodicTest : public Expression {
     void Validate() const override;
     double value() noexcept override;
     double Sample() noexcept override;
+    double Apply(const double* args) noexcept override;
 
    private:
     /// Computes the expression value.
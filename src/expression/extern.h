@@ -20,8 +20,12 @@
 
 #pragma once
 
+#include <algorithm>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -78,6 +82,20 @@ class ExternLibrary : public Element, public Usage {
     }
   }
 
+  /// @tparam F  The C free function type.
+  ///
+  /// @param[in] symbol  The optional function symbol in the library.
+  ///
+  /// @returns The function pointer resolved from the symbol.
+  ///          nullptr if the library does not provide the symbol.
+  template <typename F>
+  std::enable_if_t<std::is_function_v<F>, std::add_pointer_t<F>>
+  find(const std::string& symbol) const noexcept {
+    if (!lib_handle_.has(symbol))
+      return nullptr;
+    return lib_handle_.get<F>(symbol);
+  }
+
  private:
   boost::dll::shared_library lib_handle_;  ///< Shared Library abstraction.
 };
@@ -117,6 +135,14 @@ using ExternFunctionBase = ExternFunction<void>;  ///< To help Doxygen.
 
 /// Extern function abstraction to be referenced by expressions.
 ///
+/// In addition to the scalar C function,
+/// the library may export the optional batch variant
+/// under the same symbol with "_batch" suffix:
+///
+///     void symbol_batch(int n, R* results, const Args*... args);
+///
+/// The batch variant computes the results over n contiguous argument values.
+///
 /// @tparam R  Numeric return type.
 /// @tparam Args  Numeric argument types.
 ///
@@ -126,23 +152,66 @@ class ExternFunction : public ExternFunctionBase {
   static_assert(std::is_arithmetic_v<R>, "Numeric type functions only.");
 
   using Pointer = R (*)(Args...);  ///< The function pointer type.
+  using BatchPointer = void (*)(int, R*, const Args*...);  ///< The batch ABI.
 
  public:
+  /// The maximum number of memoized results for pure functions.
+  static constexpr int kMaxCacheSize = 1 << 16;
+
   /// Loads a function from a library for further usage.
   ///
   /// @copydoc Element::Element
   ///
   /// @param[in] symbol  The symbol name for the function in the library.
   /// @param[in] library  The dynamic library to lookup the function.
+  /// @param[in] pure  The function results depend only on the arguments,
+  ///                  so they can be memoized.
   ///
   /// @throws DLError  There is no such symbol in the library.
   ExternFunction(std::string name, const std::string& symbol,
-                 const ExternLibrary& library)
+                 const ExternLibrary& library, bool pure = false)
       : ExternFunctionBase(std::move(name)),
-        fptr_(library.get<R(Args...)>(symbol)) {}
+        fptr_(library.get<R(Args...)>(symbol)),
+        batch_fptr_(library.find<void(int, R*, const Args*...)>(symbol +
+                                                                "_batch")),
+        pure_(pure) {}
+
+  /// @returns true if the function results can be memoized.
+  bool pure() const { return pure_; }
+
+  /// @returns true if the library provides the batch variant of the function.
+  bool batched() const { return batch_fptr_ != nullptr; }
 
   /// Calls the library function with the given numeric arguments.
-  R operator()(Args... args) const noexcept { return fptr_(args...); }
+  R operator()(Args... args) const noexcept {
+    if (!pure_)
+      return fptr_(args...);
+
+    std::tuple<Args...> key(args...);
+    {
+      std::lock_guard<std::mutex> lock(cache_mutex_);
+      if (auto it = cache_.find(key); it != cache_.end())
+        return it->second;
+    }
+    R result = fptr_(args...);
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    if (cache_.size() >= kMaxCacheSize)
+      cache_.clear();  // Keep memory bounded for continuous arguments.
+    cache_.emplace(std::move(key), result);
+    return result;
+  }
+
+  /// Calls the batch variant of the library function.
+  ///
+  /// @param[in] n  The number of argument values in each array.
+  /// @param[out] results  The destination array for n results.
+  /// @param[in] args  The arrays of n argument values.
+  ///
+  /// @pre The library provides the batch variant.
+  void operator()(int n, R* results, const Args*... args) const noexcept {
+    assert(batch_fptr_ && "The batch variant is not provided.");
+    batch_fptr_(n, results, args...);
+  }
 
   /// @copydoc ExternFunction<void>::apply
   std::unique_ptr<Expression>
@@ -150,6 +219,34 @@ class ExternFunction : public ExternFunctionBase {
 
  private:
   const Pointer fptr_;  ///< The pointer to the extern function in a library.
+  const BatchPointer batch_fptr_;  ///< The optional batch function pointer.
+  const bool pure_;  ///< Indication of the memoizable function.
+  /// The memoized results of the pure function.
+  mutable std::map<std::tuple<Args...>, R> cache_;
+  mutable std::mutex cache_mutex_;  ///< Guards the cache across threads.
+};
+
+/// Type-erased interface to evaluate extern expressions
+/// over blocks of argument values (e.g., samples or time points).
+class ExternBatch {
+ public:
+  virtual ~ExternBatch() = default;
+
+  /// @returns true if the extern function provides the batch variant.
+  virtual bool batched() const = 0;
+
+  /// @returns true if the extern function results depend only on arguments.
+  virtual bool pure() const = 0;
+
+  /// Computes the extern function over blocks of argument values.
+  ///
+  /// @param[in] n  The number of values in each block.
+  /// @param[in] args  The blocks of argument values in the argument order.
+  /// @param[out] results  The destination block for n results.
+  ///
+  /// @pre The extern function provides the batch variant.
+  virtual void Compute(int n, const double* const* args,
+                       double* results) noexcept = 0;
 };
 
 /// Expression evaluating an extern function with expression arguments.
@@ -158,7 +255,8 @@ class ExternFunction : public ExternFunctionBase {
 /// @tparam Args  Numeric argument types.
 template <typename R, typename... Args>
 class ExternExpression
-    : public ExpressionFormula<ExternExpression<R, Args...>> {
+    : public ExpressionFormula<ExternExpression<R, Args...>>,
+      public ExternBatch {
  public:
   /// @param[in] extern_function  The library function.
   /// @param[in] args  The argument expression for the function.
@@ -173,6 +271,19 @@ class ExternExpression
           ValidityError("The number of function arguments does not match."));
   }
 
+  /// Only pure extern functions can be simplified.
+  bool IsConstant() noexcept override {
+    return extern_function_.pure() && Expression::IsConstant();
+  }
+
+  bool batched() const override { return extern_function_.batched(); }
+  bool pure() const override { return extern_function_.pure(); }
+
+  void Compute(int n, const double* const* args,
+               double* results) noexcept override {
+    MarshalBatch(n, args, results, std::index_sequence_for<Args...>());
+  }
+
   /// Computes the extern function with the given evaluator for arguments.
   template <typename F>
   double Compute(F&& eval) noexcept {
@@ -197,6 +308,39 @@ class ExternExpression
     return extern_function_(eval(Expression::args()[Is])...);
   }
 
+  /// Converts the argument blocks to the function parameter types
+  /// and calls the batch variant of the extern function.
+  ///
+  /// @tparam Is  The index sequence for the arguments.
+  ///
+  /// @param[in] n  The number of values in each block.
+  /// @param[in] args  The blocks of argument values.
+  /// @param[out] results  The destination block for n results.
+  template <std::size_t... Is>
+  void MarshalBatch(int n, const double* const* args, double* results,
+                    std::index_sequence<Is...>) noexcept {
+    // The buffers are local for concurrent evaluations of the expression.
+    std::tuple<std::vector<Args>...> buffers;
+    auto convert = [n](const double* values, auto* buffer) {
+      using T = typename std::decay_t<decltype(*buffer)>::value_type;
+      if constexpr (std::is_same_v<T, double>) {
+        return values;  // No conversion is necessary.
+      } else {
+        buffer->assign(values, values + n);
+        return static_cast<const T*>(buffer->data());
+      }
+    };
+    if constexpr (std::is_same_v<R, double>) {
+      extern_function_(n, results,
+                       convert(args[Is], &std::get<Is>(buffers))...);
+    } else {
+      std::vector<R> result_buffer(n);
+      extern_function_(n, result_buffer.data(),
+                       convert(args[Is], &std::get<Is>(buffers))...);
+      std::copy_n(result_buffer.data(), n, results);
+    }
+  }
+
   const ExternFunction<R, Args...>& extern_function_;  ///< The source function.
 };
 
@@ -36,7 +36,35 @@
 
 namespace scram::mef {
 
-std::mt19937 RandomDeviate::rng_;
+RandomDeviate::Generator RandomDeviate::generator_;
+unsigned RandomDeviate::seed_ = std::mt19937::default_seed;
+std::uint64_t RandomDeviate::trial_ = 0;
+
+std::uint64_t RandomDeviate::MakeKey(std::string_view owner,
+                                     int position) noexcept {
+  // 64-bit FNV-1a is portable, unlike std::hash.
+  std::uint64_t key = 0xcbf29ce484222325;
+  auto mix = [&key](std::uint8_t byte) {
+    key ^= byte;
+    key *= 0x100000001b3;
+  };
+  for (char symbol : owner)
+    mix(symbol);
+  for (int i = 0; i < 4; ++i)
+    mix(static_cast<std::uint32_t>(position) >> (8 * i));
+  return key;
+}
+
+RandomDeviate::Generator& RandomDeviate::rng() noexcept {
+  if (generator_.counter_based) {
+    generator_.philox = ext::philox4x32(
+        {static_cast<std::uint32_t>(key_),
+         static_cast<std::uint32_t>(key_ >> 32)},
+        {static_cast<std::uint32_t>(trial_),
+         static_cast<std::uint32_t>(trial_ >> 32), seed_, 0});
+  }
+  return generator_;
+}
 
 UniformDeviate::UniformDeviate(Expression* min, Expression* max)
     : RandomDeviate({min, max}), min_(*min), max_(*max) {}
@@ -21,43 +21,120 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <memory>
 #include <random>
+#include <string_view>
 #include <vector>
 
 #include <boost/range/iterator_range.hpp>
 
 #include "src/expression.h"
+#include "src/ext/philox.h"
+#include "src/settings.h"
 
 namespace scram::mef {
 
 /// Abstract base class for all deviate expressions.
 /// These expressions provide quantification for uncertainty and sensitivity.
 ///
-/// @note Only single RNG is embedded for convenience.
-///       All the distributions share this RNG.
-///       This is not suitable for parallelized simulations!!!
+/// The deviates share the random number generator
+/// with the engine selected for all deviates.
+/// The sequential Mersenne Twister engine samples
+/// in the order of sampling calls across all deviates.
+/// The counter-based Philox engine makes the sample of deviate j in trial i
+/// a pure function of (seed, j, i),
+/// where j is the stable key of the deviate in the model,
+/// and i is the index of the current Monte Carlo trial.
+///
+/// @note The generator state is static and shared by all deviates.
+///       This is not suitable for concurrent sampling!!!
 ///
 /// @todo Parametrize with RNG (requires mef::Expression interface change).
 class RandomDeviate : public Expression {
  public:
-  using Expression::Expression;
+  /// @copydoc Expression::Expression
+  explicit RandomDeviate(std::vector<Expression*> args = {})
+      : Expression(std::move(args)) {}
 
   bool IsDeviate() noexcept override { return true; }
+  bool IsConstant() noexcept override { return false; }
+
+  /// Derives the stable key of a deviate in the model.
+  ///
+  /// @param[in] owner  The unique designation of the model element
+  ///                   defining the deviate expression.
+  /// @param[in] position  The order of the deviate
+  ///                      among the deviates of the owner definition.
+  ///
+  /// @returns The key independent of the construction of other deviates.
+  static std::uint64_t MakeKey(std::string_view owner, int position) noexcept;
+
+  /// @returns The key of the deviate stream for the counter-based engine.
+  std::uint64_t key() const { return key_; }
+
+  /// @param[in] key  The stable key of the deviate in the model.
+  void key(std::uint64_t key) { key_ = key; }
 
   /// Sets the seed of the underlying random number generator.
   ///
   /// @param[in] seed  The seed for RNGs.
   ///
   /// @note This is static! Used by all the deriving deviates.
-  static void seed(unsigned seed) noexcept { rng_.seed(seed); }
+  static void seed(unsigned seed) noexcept {
+    generator_.mt19937.seed(seed);
+    seed_ = seed;
+  }
+
+  /// Sets the Monte Carlo trial of the next samples
+  /// for the counter-based engine.
+  ///
+  /// @param[in] trial  The index of the trial.
+  ///
+  /// @note This is static! Used by all the deriving deviates.
+  static void trial(std::uint64_t trial) noexcept { trial_ = trial; }
+
+  /// Selects the engine of the underlying random number generator.
+  ///
+  /// @param[in] engine  The engine for all the deviates.
+  static void engine(core::RngEngine engine) noexcept {
+    generator_.counter_based = engine == core::RngEngine::kPhilox;
+  }
 
  protected:
-  /// @returns RNG to be used by derived classes.
-  std::mt19937& rng() { return rng_; }
+  /// The uniform random bit generator dispatching to the selected engine.
+  struct Generator {
+    using result_type = std::uint32_t;  ///< The common output of the engines.
+
+    /// @returns The minimum output value.
+    static constexpr result_type min() { return ext::philox4x32::min(); }
+
+    /// @returns The maximum output value.
+    static constexpr result_type max() { return ext::philox4x32::max(); }
+
+    /// @returns The next random output of the selected engine.
+    result_type operator()() noexcept {
+      return counter_based ? philox() : static_cast<result_type>(mt19937());
+    }
+
+    bool counter_based = false;  ///< The selection of the Philox engine.
+    std::mt19937 mt19937;  ///< The sequential engine.
+    ext::philox4x32 philox;  ///< The stream of the current deviate sample.
+  };
+
+  /// @returns RNG to be used by derived classes
+  ///          positioned for the sample of this deviate in the current trial.
+  ///
+  /// @pre The RNG is requested once per sample.
+  Generator& rng() noexcept;
 
  private:
-  static std::mt19937 rng_;  ///< The random number generator.
+  static Generator generator_;  ///< The random number generator.
+  static unsigned seed_;  ///< The seed for the counter-based engine streams.
+  static std::uint64_t trial_;  ///< The current Monte Carlo trial.
+
+  std::uint64_t key_ = 0;  ///< The stable key of the deviate in the model.
 };
 
 /// Uniform distribution.
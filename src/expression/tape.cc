@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2014-2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the expression tape compiler and evaluator.
+
+#include "tape.h"
+
+#include <cmath>
+
+#include <algorithm>
+#include <optional>
+#include <unordered_set>
+
+#include "constant.h"
+#include "exponential.h"
+#include "extern.h"
+#include "numerical.h"
+#include "random_deviate.h"
+#include "src/parameter.h"
+
+namespace scram::mef {
+
+namespace {
+
+/// Finds the mission time expression in the arguments of called expressions.
+///
+/// @param[in] expression  The expression to search.
+/// @param[in,out] visited  The expressions already searched.
+///
+/// @returns The mission time expression if any.
+MissionTime* FindMissionTime(Expression* expression,
+                             std::unordered_set<Expression*>* visited) {
+  if (auto* mission_time = dynamic_cast<MissionTime*>(expression))
+    return mission_time;
+  if (visited->insert(expression).second == false)
+    return nullptr;
+  for (Expression* arg : expression->args()) {
+    if (MissionTime* mission_time = FindMissionTime(arg, visited))
+      return mission_time;
+  }
+  return nullptr;
+}
+
+/// @returns true if the expression is of the given type.
+template <class T>
+bool Is(Expression* expression) {
+  return dynamic_cast<T*>(expression) != nullptr;
+}
+
+/// @returns The tape operation implementing the expression formula.
+///          kCall if the expression is not lowered into the tape.
+ExpressionTape::Opcode GetOpcode(Expression* expression) {
+  using Opcode = ExpressionTape::Opcode;
+  if (Is<Exponential>(expression))
+    return Opcode::kExponential;
+  if (Is<Glm>(expression))
+    return Opcode::kGlm;
+  if (Is<Weibull>(expression))
+    return Opcode::kWeibull;
+  if (Is<PeriodicTest>(expression))
+    return Opcode::kPeriodicTest;
+  if (auto* extern_batch = dynamic_cast<ExternBatch*>(expression))
+    return extern_batch->batched() ? Opcode::kExtern : Opcode::kCall;
+  if (Is<Mul>(expression))
+    return Opcode::kMul;
+  if (Is<Add>(expression))
+    return Opcode::kAdd;
+  if (Is<Sub>(expression))
+    return Opcode::kSub;
+  if (Is<Div>(expression))
+    return Opcode::kDiv;
+  if (Is<Neg>(expression))
+    return Opcode::kNeg;
+  if (Is<Min>(expression))
+    return Opcode::kMin;
+  if (Is<Max>(expression))
+    return Opcode::kMax;
+  if (Is<Mean>(expression))
+    return Opcode::kMean;
+  if (Is<Abs>(expression))
+    return Opcode::kAbs;
+  if (Is<Exp>(expression))
+    return Opcode::kExp;
+  if (Is<Log>(expression))
+    return Opcode::kLog;
+  if (Is<Sqrt>(expression))
+    return Opcode::kSqrt;
+  if (Is<Pow>(expression))
+    return Opcode::kPow;
+  return Opcode::kCall;
+}
+
+}  // namespace
+
+ExpressionTape::ExpressionTape(const std::vector<Expression*>& roots)
+    : sources_(roots) {
+  roots_.reserve(roots.size());
+  for (Expression* root : roots)
+    roots_.push_back(Compile(root));
+  registry_.clear();  // Only needed for compilation.
+  dependencies_.clear();
+
+  std::unordered_set<Expression*> visited;
+  for (int call : calls_) {
+    if (mission_time_)
+      break;
+    mission_time_ = FindMissionTime(instructions_[call].expression, &visited);
+  }
+}
+
+int ExpressionTape::Compile(Expression* expression) noexcept {
+  if (auto it = registry_.find(expression); it != registry_.end())
+    return it->second;
+
+  int result = [this, expression] {
+    if (auto* parameter = dynamic_cast<Parameter*>(expression)) {
+      assert(parameter->args().size() == 1);
+      return Compile(parameter->args().front());  // Aliasing.
+    }
+    if (auto* mission_time = dynamic_cast<MissionTime*>(expression)) {
+      assert((!mission_time_ || mission_time_ == mission_time) &&
+             "Only one mission time per model.");
+      mission_time_ = mission_time;
+      return Emit(Opcode::kMissionTime, expression, kTimeDependency);
+    }
+    if (expression->IsConstant())
+      return Fold(expression->value());
+
+    Opcode opcode = GetOpcode(expression);
+    if (opcode != Opcode::kCall)
+      return Emit(opcode, expression, expression->args());
+
+    // Opaque expressions are conservatively assumed to vary with everything
+    // unless they are known to depend only on the mission time or deviates.
+    std::unordered_set<Expression*> visited;
+    std::uint8_t dependency =
+        (FindMissionTime(expression, &visited) ? kTimeDependency : 0) |
+        (expression->IsDeviate() ? kSampleDependency : 0);
+    if (!dependency)
+      dependency = kTimeDependency | kSampleDependency;
+    calls_.push_back(instructions_.size());
+    return Emit(Opcode::kCall, expression, dependency);
+  }();
+  registry_.emplace(expression, result);
+  return result;
+}
+
+int ExpressionTape::Emit(Opcode opcode, Expression* expression,
+                         const std::vector<Expression*>& args) noexcept {
+  std::vector<int> operands;
+  operands.reserve(args.size());
+  std::uint8_t dependency = 0;
+  for (Expression* arg : args) {
+    operands.push_back(Compile(arg));  // Topological order of instructions.
+    dependency |= dependencies_[operands.back()];
+  }
+  if (opcode == Opcode::kExtern &&
+      !dynamic_cast<ExternBatch*>(expression)->pure())
+    dependency = kTimeDependency | kSampleDependency;  // Opaque side effects.
+  if (!dependency)
+    return Fold(expression->value());
+
+  if (opcode == Opcode::kExtern && operands.size() > extern_args_.size())
+    extern_args_.resize(operands.size());
+  int first_operand = operands_.size();
+  operands_.insert(operands_.end(), operands.begin(), operands.end());
+  instructions_.push_back({opcode, dependency, num_registers_, first_operand,
+                           static_cast<int>(operands.size()), expression});
+  dependencies_.push_back(dependency);
+  return num_registers_++;
+}
+
+int ExpressionTape::Emit(Opcode opcode, Expression* expression,
+                         std::uint8_t dependency) noexcept {
+  instructions_.push_back(
+      {opcode, dependency, num_registers_, 0, 0, expression});
+  dependencies_.push_back(dependency);
+  return num_registers_++;
+}
+
+int ExpressionTape::Fold(double value) noexcept {
+  constants_.emplace_back(num_registers_, value);
+  dependencies_.push_back(0);
+  return num_registers_++;
+}
+
+void ExpressionTape::Resize(int num_lanes) noexcept {
+  assert(num_lanes > 0);
+  if (num_lanes == num_lanes_)
+    return;
+  num_lanes_ = num_lanes;
+  registers_.assign(num_registers_ * num_lanes_, 0);
+  for (const std::pair<int, double>& constant : constants_) {
+    double* lanes = &registers_[constant.first * num_lanes_];
+    std::fill(lanes, lanes + num_lanes_, constant.second);
+  }
+}
+
+template <class F>
+void ExpressionTape::Run(std::uint8_t varying, F&& eval) noexcept {
+  for (const Instruction& instruction : instructions_) {
+    // Lane-invariant instructions are computed in the first lane only.
+    const int n = (instruction.dependency & varying) ? num_lanes_ : 1;
+    double* out = &registers_[instruction.result * num_lanes_];
+    auto arg = [this, &instruction](int i) -> const double* {
+      assert(i < instruction.num_operands);
+      return &registers_[operands_[instruction.first_operand + i] *
+                         num_lanes_];
+    };
+    // Applies the binary operation over the operands (left fold).
+    auto fold = [&instruction, &arg, out, n](auto&& op) {
+      const double* first = arg(0);
+      std::copy(first, first + n, out);
+      for (int i = 1; i < instruction.num_operands; ++i) {
+        const double* next = arg(i);
+        for (int j = 0; j < n; ++j)  // This should get vectorized.
+          out[j] = op(out[j], next[j]);
+      }
+    };
+    auto map = [&arg, out, n](auto&& op) {
+      const double* x = arg(0);
+      for (int j = 0; j < n; ++j)
+        out[j] = op(x[j]);
+    };
+
+    switch (instruction.opcode) {
+      case Opcode::kCall:
+      case Opcode::kMissionTime:
+        eval(instruction, out, n);
+        break;
+      case Opcode::kNeg:
+        map([](double x) { return -x; });
+        break;
+      case Opcode::kAdd:
+        fold([](double x, double y) { return x + y; });
+        break;
+      case Opcode::kSub:
+        fold([](double x, double y) { return x - y; });
+        break;
+      case Opcode::kMul:
+        fold([](double x, double y) { return x * y; });
+        break;
+      case Opcode::kDiv:
+        fold([](double x, double y) { return x / y; });
+        break;
+      case Opcode::kMin:
+        fold([](double x, double y) { return std::fmin(x, y); });
+        break;
+      case Opcode::kMax:
+        fold([](double x, double y) { return std::fmax(x, y); });
+        break;
+      case Opcode::kMean: {
+        fold([](double x, double y) { return x + y; });
+        double num_args = instruction.num_operands;
+        for (int j = 0; j < n; ++j)
+          out[j] /= num_args;
+        break;
+      }
+      case Opcode::kAbs:
+        map([](double x) { return std::abs(x); });
+        break;
+      case Opcode::kExp:
+        map([](double x) { return std::exp(x); });
+        break;
+      case Opcode::kLog:
+        map([](double x) { return std::log(x); });
+        break;
+      case Opcode::kSqrt:
+        map([](double x) { return std::sqrt(x); });
+        break;
+      case Opcode::kPow:
+        fold([](double x, double y) { return std::pow(x, y); });
+        break;
+      case Opcode::kExponential: {
+        auto& formula = static_cast<Exponential&>(*instruction.expression);
+        const double* lambda = arg(0);
+        const double* time = arg(1);
+        for (int j = 0; j < n; ++j)
+          out[j] = formula.Compute(lambda[j], time[j]);
+        break;
+      }
+      case Opcode::kGlm: {
+        auto& formula = static_cast<Glm&>(*instruction.expression);
+        const double* gamma = arg(0);
+        const double* lambda = arg(1);
+        const double* mu = arg(2);
+        const double* time = arg(3);
+        for (int j = 0; j < n; ++j)
+          out[j] = formula.Compute(gamma[j], lambda[j], mu[j], time[j]);
+        break;
+      }
+      case Opcode::kWeibull: {
+        auto& formula = static_cast<Weibull&>(*instruction.expression);
+        const double* alpha = arg(0);
+        const double* beta = arg(1);
+        const double* t0 = arg(2);
+        const double* time = arg(3);
+        for (int j = 0; j < n; ++j)
+          out[j] = formula.Compute(alpha[j], beta[j], t0[j], time[j]);
+        break;
+      }
+      case Opcode::kPeriodicTest: {
+        auto& formula = static_cast<PeriodicTest&>(*instruction.expression);
+        double args[11];  // The maximum number of periodic-test arguments.
+        assert(instruction.num_operands <= 11);
+        for (int j = 0; j < n; ++j) {
+          for (int i = 0; i < instruction.num_operands; ++i)
+            args[i] = arg(i)[j];
+          out[j] = formula.Compute(args);
+        }
+        break;
+      }
+      case Opcode::kExtern: {
+        auto& formula = dynamic_cast<ExternBatch&>(*instruction.expression);
+        assert(instruction.num_operands <= extern_args_.size());
+        for (int i = 0; i < instruction.num_operands; ++i)
+          extern_args_[i] = arg(i);
+        formula.Compute(n, extern_args_.data(), out);
+        break;
+      }
+    }
+    if (n < num_lanes_)
+      std::fill(out + n, out + num_lanes_, out[0]);
+  }
+}
+
+void ExpressionTape::Evaluate() noexcept {
+  Resize(1);
+  Run(0, [](const Instruction& instruction, double* out, int) {
+    *out = instruction.expression->value();
+  });
+}
+
+void ExpressionTape::Evaluate(const std::vector<double>& time_points) noexcept {
+  assert(!time_points.empty());
+  Resize(time_points.size());
+  // The mission time is swept in the calling thread only
+  // to keep concurrent analyses of the same model independent.
+  std::optional<double> init_time;
+  if (mission_time_)
+    init_time = mission_time_->local_value();
+  Run(kTimeDependency, [this, &time_points](const Instruction& instruction,
+                                            double* out, int num_lanes) {
+    if (instruction.opcode == Opcode::kMissionTime) {
+      std::copy(time_points.begin(), time_points.end(), out);
+      return;
+    }
+    for (int j = 0; j < num_lanes; ++j) {
+      if (mission_time_)
+        mission_time_->local_value(time_points[j]);
+      out[j] = instruction.expression->value();
+    }
+  });
+  if (mission_time_)
+    mission_time_->local_value(init_time);
+}
+
+void ExpressionTape::Sample(int num_trials,
+                            std::uint64_t first_trial) noexcept {
+  Resize(num_trials);
+  // The root expressions are sampled trial by trial in their order
+  // as the sequential engines need the same order of random number draws
+  // regardless of the tape layout.
+  // Only the root registers are filled.
+  for (int j = 0; j < num_lanes_; ++j) {
+    RandomDeviate::trial(first_trial + j);
+    for (Expression* root : sources_)
+      root->Reset();
+    for (int i = 0; i < sources_.size(); ++i)
+      registers_[roots_[i] * num_lanes_ + j] = sources_[i]->Sample();
+  }
+}
+
+}  // namespace scram::mef
@@ -0,0 +1,217 @@
+/*
+ * Copyright (C) 2014-2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Compilation of expression DAGs into flat evaluation tapes.
+
+#pragma once
+
+#include <cstdint>
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/expression.h"
+
+namespace scram::mef {
+
+class MissionTime;
+
+/// Flat, topologically ordered program
+/// lowered from the DAG of expressions reachable from a set of roots.
+///
+/// Every unique expression node gets a single register,
+/// so shared sub-expressions (e.g., parameters) are evaluated only once.
+/// Expressions with known formulas are lowered into tape instructions;
+/// the rest (deviates, conditionals, extern functions, etc.)
+/// are called through their virtual interface.
+/// Constant sub-expressions are folded into registers at compilation,
+/// and instructions are marked with their dependencies
+/// so that only the varying instructions are re-evaluated in every lane.
+///
+/// The tape evaluates in lanes over independent points
+/// (mission time points or Monte Carlo trials).
+/// The lanes of a register are stored contiguously,
+/// so instruction loops over lanes are amenable to vectorization.
+///
+/// @pre The expressions are validated and free of cycles.
+/// @pre The expressions are not changed for the lifetime of the tape.
+class ExpressionTape : private boost::noncopyable {
+ public:
+  /// Operation codes of the tape instructions.
+  enum class Opcode : std::uint8_t {
+    kCall = 0,  ///< Call to the source expression virtual interface.
+    kMissionTime,  ///< Load of the system mission time.
+    kNeg,
+    kAdd,
+    kSub,
+    kMul,
+    kDiv,
+    kMin,
+    kMax,
+    kMean,
+    kAbs,
+    kExp,
+    kLog,
+    kSqrt,
+    kPow,
+    kExponential,
+    kGlm,
+    kWeibull,
+    kPeriodicTest,
+    kExtern  ///< Batch call to an extern function.
+  };
+
+  /// The sources of variation in instruction values between lanes.
+  enum Dependency : std::uint8_t {
+    kTimeDependency = 1 << 0,  ///< Varies with the mission time.
+    kSampleDependency = 1 << 1  ///< Varies between Monte Carlo trials.
+  };
+
+  /// The tape instruction writing into its own register.
+  struct Instruction {
+    Opcode opcode;  ///< The operation to perform.
+    std::uint8_t dependency;  ///< The Dependency flags of the result.
+    int result;  ///< The destination register.
+    int first_operand;  ///< The start of operand registers in the operand list.
+    int num_operands;  ///< The number of operand registers.
+    Expression* expression;  ///< The source expression of the instruction.
+  };
+
+  /// Compiles the expression DAG into a tape.
+  ///
+  /// @param[in] roots  The root expressions to be evaluated by the tape.
+  explicit ExpressionTape(const std::vector<Expression*>& roots);
+
+  /// @returns The instructions in the topological order.
+  const std::vector<Instruction>& instructions() const { return instructions_; }
+
+  /// @returns The total number of registers including constants.
+  int num_registers() const { return num_registers_; }
+
+  /// @returns The number of lanes evaluated in the last run.
+  int num_lanes() const { return num_lanes_; }
+
+  /// @returns The mission time expression reachable from the roots.
+  ///          nullptr if the roots are independent of the mission time.
+  MissionTime* mission_time() const { return mission_time_; }
+
+  /// Evaluates the mean values of the roots in a single lane.
+  void Evaluate() noexcept;
+
+  /// Evaluates the mean values of the roots at the given mission time points.
+  /// Each time point gets its own lane.
+  ///
+  /// @param[in] time_points  The non-empty collection of non-negative times.
+  ///
+  /// @post The mission time expression has its original value.
+  void Evaluate(const std::vector<double>& time_points) noexcept;
+
+  /// Samples the roots in independent Monte Carlo trials.
+  /// Each trial gets its own lane.
+  ///
+  /// The roots are sampled through their expressions in the root order,
+  /// so the random numbers are drawn in the same order
+  /// as in the sampling of the expressions one by one.
+  ///
+  /// @param[in] num_trials  The number of trials to sample.
+  /// @param[in] first_trial  The Monte Carlo trial index of the first lane
+  ///                         for the counter-based random deviates.
+  void Sample(int num_trials = 1, std::uint64_t first_trial = 0) noexcept;
+
+  /// @param[in] root  The index of the root in the construction order.
+  /// @param[in] lane  The lane of the evaluation.
+  ///
+  /// @returns The value of the root expression from the last run.
+  double value(int root, int lane = 0) const {
+    assert(root < static_cast<int>(roots_.size()) && lane < num_lanes_);
+    return registers_[roots_[root] * num_lanes_ + lane];
+  }
+
+ private:
+  /// Lowers an expression and its arguments into instructions.
+  /// Constant expressions are folded into constant registers.
+  ///
+  /// @param[in] expression  The expression to compile.
+  ///
+  /// @returns The register holding the value of the expression.
+  int Compile(Expression* expression) noexcept;
+
+  /// Adds an instruction with its arguments compiled as operands.
+  /// The instruction with constant operands is folded instead.
+  ///
+  /// @param[in] opcode  The operation of the instruction.
+  /// @param[in] expression  The source expression.
+  /// @param[in] args  The argument expressions to be compiled as operands.
+  ///
+  /// @returns The result register of the new instruction.
+  int Emit(Opcode opcode, Expression* expression,
+           const std::vector<Expression*>& args) noexcept;
+
+  /// Adds an instruction without operands.
+  ///
+  /// @param[in] opcode  The operation of the instruction.
+  /// @param[in] expression  The source expression.
+  /// @param[in] dependency  The Dependency flags of the instruction.
+  ///
+  /// @returns The result register of the new instruction.
+  int Emit(Opcode opcode, Expression* expression,
+           std::uint8_t dependency) noexcept;
+
+  /// Allocates a constant register.
+  ///
+  /// @param[in] value  The value of the register in all lanes.
+  ///
+  /// @returns The constant register.
+  int Fold(double value) noexcept;
+
+  /// Prepares the registers for evaluation in the given number of lanes.
+  void Resize(int num_lanes) noexcept;
+
+  /// Runs the instructions over all lanes.
+  /// Instructions independent of the varying sources
+  /// are computed once and broadcast to all lanes.
+  ///
+  /// @tparam F  The evaluator of called expressions and the mission time.
+  ///
+  /// @param[in] varying  The Dependency flags that vary between lanes.
+  /// @param[in] eval  The evaluator: (const Instruction&, double* lanes,
+  ///                                   int num_lanes).
+  template <class F>
+  void Run(std::uint8_t varying, F&& eval) noexcept;
+
+  std::vector<Expression*> sources_;  ///< The root expressions.
+  std::vector<int> roots_;  ///< The registers of the root expressions.
+  std::vector<Instruction> instructions_;  ///< The tape program.
+  std::vector<int> operands_;  ///< The operand registers of instructions.
+  std::vector<int> calls_;  ///< The instructions calling expressions.
+  std::vector<std::pair<int, double>> constants_;  ///< {register, value}.
+  std::unordered_map<Expression*, int> registry_;  ///< Expression registers.
+  std::vector<std::uint8_t> dependencies_;  ///< The flags of registers.
+  std::vector<double> registers_;  ///< The registers with contiguous lanes.
+  /// The argument lanes of the extern function calls
+  /// sized for the largest call at compilation.
+  std::vector<const double*> extern_args_;
+  int num_registers_ = 0;  ///< The number of allocated registers.
+  int num_lanes_ = 0;  ///< The current number of lanes per register.
+  MissionTime* mission_time_ = nullptr;  ///< The optional mission time.
+};
+
+}  // namespace scram::mef
@@ -42,6 +42,7 @@ class TestEvent : public Expression {
 
   Interval interval() noexcept override { return Interval::closed(0, 1); }
   bool IsDeviate() noexcept override { return false; }
+  bool IsConstant() noexcept override { return false; }
 
  protected:
   const Context& context_;  ///< The evaluation context.
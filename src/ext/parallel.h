@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Work-stealing execution of independent tasks.
+
+#pragma once
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ext {
+
+/// Runs independent indexed tasks on a pool of threads.
+///
+/// Every worker starts with an equal contiguous range of task indices
+/// and executes it from the front.
+/// An idle worker steals the back half of the largest remaining range,
+/// so tasks of uneven cost get balanced between the workers.
+///
+/// @tparam F  The task callable: (int index) -> void.
+///
+/// @param[in] num_tasks  The number of tasks indexed [0, num_tasks).
+/// @param[in] num_threads  The maximum number of threads to use.
+/// @param[in] task  The task to execute for every index exactly once.
+///
+/// @throws The first exception thrown by the tasks.
+///         The remaining tasks are abandoned,
+///         and the exception is rethrown after all the workers stop.
+///
+/// @note The calling thread is one of the workers.
+///       With a single thread, the tasks are executed in the index order.
+template <class F>
+void parallel_for(int num_tasks, int num_threads, F&& task) {
+  assert(num_tasks >= 0 && num_threads > 0);
+  num_threads = std::min(num_threads, num_tasks);
+  if (num_threads <= 1) {
+    for (int i = 0; i < num_tasks; ++i)
+      task(i);
+    return;
+  }
+
+  /// The remaining task indices [begin, end) of a worker.
+  struct Range {
+    std::mutex mutex;  ///< Guards the range against thieves.
+    int begin;  ///< The next task to execute by the owner.
+    int end;  ///< The end of the tasks, moved back by thieves.
+  };
+  std::vector<Range> ranges(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    ranges[i].begin = static_cast<long>(num_tasks) * i / num_threads;
+    ranges[i].end = static_cast<long>(num_tasks) * (i + 1) / num_threads;
+  }
+
+  /// Steals the back half of the largest range of other workers.
+  auto steal = [&ranges, num_threads](int thief) {
+    for (;;) {
+      int victim = -1;
+      int max_size = 0;
+      for (int i = 0; i < num_threads; ++i) {
+        if (i == thief)
+          continue;
+        std::lock_guard<std::mutex> lock(ranges[i].mutex);
+        if (int size = ranges[i].end - ranges[i].begin; size > max_size) {
+          max_size = size;
+          victim = i;
+        }
+      }
+      if (victim < 0)
+        return false;
+      std::scoped_lock lock(ranges[victim].mutex, ranges[thief].mutex);
+      int size = ranges[victim].end - ranges[victim].begin;
+      if (size <= 0)
+        continue;  // Lost the race to other thieves.
+      int middle = ranges[victim].end - (size + 1) / 2;
+      ranges[thief].begin = middle;
+      ranges[thief].end = ranges[victim].end;
+      ranges[victim].end = middle;
+      return true;
+    }
+  };
+
+  // The first failure of the tasks abandons the remaining tasks.
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  std::atomic<bool> failed = false;
+  auto work = [&ranges, &steal, &task, &error, &error_mutex,
+               &failed](int worker) {
+    Range& range = ranges[worker];
+    try {
+      do {
+        for (;;) {
+          int index;
+          {
+            std::lock_guard<std::mutex> lock(range.mutex);
+            if (range.begin == range.end || failed)
+              break;
+            index = range.begin++;
+          }
+          task(index);
+        }
+      } while (!failed && steal(worker));
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(error_mutex);
+      if (!error)
+        error = std::current_exception();
+      failed = true;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+  for (int i = 1; i < num_threads; ++i)
+    threads.emplace_back(work, i);
+  work(0);
+  for (std::thread& thread : threads)
+    thread.join();
+  if (error)
+    std::rethrow_exception(error);
+}
+
+}  // namespace ext
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Counter-based Philox random number engine.
+
+#pragma once
+
+#include <cstdint>
+
+#include <array>
+#include <limits>
+
+namespace ext {
+
+/// Philox4x32-10 counter-based random number engine
+/// (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", 2011).
+///
+/// The engine output is a pure function of the key and counter,
+/// so any position of any stream is accessible in constant time
+/// without sequential state advancement.
+///
+/// The engine satisfies the UniformRandomBitGenerator requirements.
+/// The last counter word is incremented for every block of 4 outputs.
+class philox4x32 {
+ public:
+  using result_type = std::uint32_t;  ///< The output type.
+  using counter_type = std::array<std::uint32_t, 4>;  ///< The block counter.
+  using key_type = std::array<std::uint32_t, 2>;  ///< The stream key.
+
+  /// @returns The minimum output value.
+  static constexpr result_type min() { return 0; }
+
+  /// @returns The maximum output value.
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  /// Computes the random block for the counter and key.
+  ///
+  /// @param[in] counter  The position of the block.
+  /// @param[in] key  The stream key.
+  ///
+  /// @returns The block of 4 random outputs.
+  static counter_type generate(counter_type counter, key_type key) noexcept {
+    for (int i = 0; i < kNumRounds; ++i) {
+      if (i) {
+        key[0] += kWeyl[0];
+        key[1] += kWeyl[1];
+      }
+      std::uint64_t first = static_cast<std::uint64_t>(kMultiplier[0]) *
+                            counter[0];
+      std::uint64_t second = static_cast<std::uint64_t>(kMultiplier[1]) *
+                             counter[2];
+      counter = {static_cast<std::uint32_t>(second >> 32) ^ counter[1] ^ key[0],
+                 static_cast<std::uint32_t>(second),
+                 static_cast<std::uint32_t>(first >> 32) ^ counter[3] ^ key[1],
+                 static_cast<std::uint32_t>(first)};
+    }
+    return counter;
+  }
+
+  /// @param[in] key  The stream key.
+  /// @param[in] counter  The position of the first block in the stream.
+  explicit philox4x32(key_type key = {}, counter_type counter = {}) noexcept
+      : key_(key), counter_(counter) {}
+
+  /// @returns The next random output in the stream.
+  result_type operator()() noexcept {
+    if (index_ == block_.size()) {
+      block_ = generate(counter_, key_);
+      ++counter_.back();
+      index_ = 0;
+    }
+    return block_[index_++];
+  }
+
+ private:
+  static constexpr int kNumRounds = 10;  ///< The recommended number of rounds.
+  /// The round multipliers.
+  static constexpr std::uint32_t kMultiplier[] = {0xD2511F53, 0xCD9E8D57};
+  /// The key schedule increments (golden ratio and sqrt(3) - 1).
+  static constexpr std::uint32_t kWeyl[] = {0x9E3779B9, 0xBB67AE85};
+
+  key_type key_;  ///< The stream key.
+  counter_type counter_;  ///< The position of the next block.
+  counter_type block_ = {};  ///< The current block of outputs.
+  std::size_t index_ = block_.size();  ///< The next output in the block.
+};
+
+}  // namespace ext
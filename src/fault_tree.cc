@@ -24,12 +24,12 @@
 
 namespace scram::mef {
 
-Component::Component(std::string name, std::string base_path,
+Component::Component(std::string_view name, std::string_view base_path,
                      RoleSpecifier role)
-    : Element(std::move(name)), Role(role, std::move(base_path)) {}
+    : Element(name), Role(role, base_path) {}
 
 void Component::Add(CcfGroup* ccf_group) {
-  if (ccf_groups().count(ccf_group->name())) {
+  if (ccf_groups().count(ccf_group->name_symbol())) {
     SCRAM_THROW(DuplicateElementError())
         << errinfo_element(ccf_group->name(), "CCF group");
   }
@@ -49,16 +49,16 @@ void Component::GatherGates(std::unordered_set<Gate*>* gates) {
 }
 
 void Component::CheckDuplicateEvent(const Event& event) {
-  const std::string& name = event.name();
+  Symbol name = event.name_symbol();
   if (gates().count(name) || basic_events().count(name) ||
       house_events().count(name)) {
     SCRAM_THROW(DuplicateElementError())
-        << errinfo_element(name, "event")
+        << errinfo_element(event.name(), "event")
         << errinfo_container(Element::name(), kTypeString);
   }
 }
 
-FaultTree::FaultTree(const std::string& name) : Component(name) {}
+FaultTree::FaultTree(std::string_view name) : Component(name) {}
 
 void FaultTree::CollectTopEvents() {
   top_events_.clear();
@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <vector>
 
@@ -60,7 +61,7 @@ class Component
   ///
   /// @throws LogicError  The name is empty.
   /// @throws ValidityError  The name or reference paths are malformed.
-  explicit Component(std::string name, std::string base_path = "",
+  explicit Component(std::string_view name, std::string_view base_path = "",
                      RoleSpecifier role = RoleSpecifier::kPublic);
 
   virtual ~Component() = default;
@@ -129,7 +130,7 @@ class FaultTree : public Component {
   /// Fault trees are assumed to be public and belong to the root model.
   ///
   /// @param[in] name  The name identifier of this fault tree.
-  explicit FaultTree(const std::string& name);
+  explicit FaultTree(std::string_view name);
 
   /// @returns The collected top events of this fault tree.
   const std::vector<const Gate*>& top_events() const { return top_events_; }
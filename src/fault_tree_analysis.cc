@@ -28,6 +28,8 @@
 
 #include "event.h"
 #include "logger.h"
+#include "progress.h"
+#include "resources.h"
 
 namespace scram::core {
 
@@ -117,11 +119,18 @@ FaultTreeAnalysis::FaultTreeAnalysis(const mef::Gate& root,
                                      const mef::Model* model)
     : Analysis(settings), top_event_(root), model_(model) {}
 
-void FaultTreeAnalysis::Analyze() noexcept {
+void FaultTreeAnalysis::Analyze() {
   CLOCK(analysis_time);
-  graph_ = std::make_unique<Pdag>(top_event_,
-                                  Analysis::settings().ccf_analysis(), model_);
+  TRACE("Fault tree analysis");
+  ResourceMeter meter(&Analysis::resources());
+  Progress* progress = Analysis::settings().progress();
+  if (!graph_) {
+    graph_ = std::make_unique<Pdag>(
+        top_event_, Analysis::settings().ccf_analysis(), model_);
+  }
+  CheckCancellation(progress);
   this->Preprocess(graph_.get());
+  CheckCancellation(progress);
 #ifndef NDEBUG
   if (Analysis::settings().preprocessor)
     return;  // Preprocessor only option.
@@ -131,10 +140,12 @@ void FaultTreeAnalysis::Analyze() noexcept {
   const Zbdd& products = this->GenerateProducts(graph_.get());
   LOG(DEBUG2) << "The algorithm finished in " << DUR(algo_time);
   LOG(DEBUG2) << "# of products: " << products.size();
+  CheckCancellation(progress);
 
   Analysis::AddAnalysisTime(DUR(analysis_time));
   CLOCK(store_time);
   Store(products, *graph_);
+  Analysis::resources().products = products_->size();
   LOG(DEBUG2) << "Stored the result for reporting in " << DUR(store_time);
 }
 
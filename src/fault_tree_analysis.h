@@ -215,6 +215,19 @@ class FaultTreeAnalysis : public Analysis {
   /// @returns The top gate that is passed to the analysis.
   const mef::Gate& top_event() const { return top_event_; }
 
+  /// Provides the PDAG of the top event built before the analysis
+  /// (e.g., to identify the analysis inputs)
+  /// so that the analysis does not build it again.
+  ///
+  /// @param[in] graph  The unpreprocessed PDAG of the top event
+  ///                   with the same settings and model.
+  ///
+  /// @pre The analysis is not done.
+  void graph(std::unique_ptr<Pdag> graph) {
+    assert(!products_ && "The analysis is done!");
+    graph_ = std::move(graph);
+  }
+
   /// Analyzes the fault tree and performs computations.
   /// This function must be called
   /// only after initializing the fault tree
@@ -228,7 +241,9 @@ class FaultTreeAnalysis : public Analysis {
   /// @warning If the fault tree structure has changed
   ///          since the construction of the analysis,
   ///          the analysis will be invalid or fail.
-  void Analyze() noexcept;
+  ///
+  /// @throws CancelError  The cancellation is requested in the settings.
+  void Analyze();
 
   /// @returns A collection of Boolean products as the analysis results.
   ///
@@ -248,7 +263,7 @@ class FaultTreeAnalysis : public Analysis {
   /// @param[in,out] graph  A valid PDAG for analysis.
   ///
   /// @post The graph transformation is semantically equivalent/isomorphic.
-  virtual void Preprocess(Pdag* graph) noexcept = 0;
+  virtual void Preprocess(Pdag* graph) = 0;
 
   /// Generates a sum of products from a preprocessed PDAG.
   ///
@@ -259,7 +274,7 @@ class FaultTreeAnalysis : public Analysis {
   /// @pre The graph is specifically preprocessed for the algorithm.
   ///
   /// @post The result ZBDD lives as long as the host analysis.
-  virtual const Zbdd& GenerateProducts(const Pdag* graph) noexcept = 0;
+  virtual const Zbdd& GenerateProducts(const Pdag* graph) = 0;
 
   /// Stores resultant sets of products for future reporting.
   ///
@@ -290,11 +305,11 @@ class FaultTreeAnalyzer : public FaultTreeAnalysis {
   /// @}
 
  private:
-  void Preprocess(Pdag* graph) noexcept override {
+  void Preprocess(Pdag* graph) override {
     CustomPreprocessor<Algorithm>{graph}();
   }
 
-  const Zbdd& GenerateProducts(const Pdag* graph) noexcept override {
+  const Zbdd& GenerateProducts(const Pdag* graph) override {
     algorithm_ = std::make_unique<Algorithm>(graph, Analysis::settings());
     algorithm_->Analyze(graph);
     return algorithm_->products();
@@ -25,6 +25,7 @@
 
 #include "event.h"
 #include "logger.h"
+#include "resources.h"
 #include "zbdd.h"
 
 namespace scram::core {
@@ -34,6 +35,8 @@ ImportanceAnalysis::ImportanceAnalysis(const ProbabilityAnalysis* prob_analysis)
 
 void ImportanceAnalysis::Analyze() noexcept {
   CLOCK(imp_time);
+  TRACE("Importance analysis");
+  ResourceMeter meter(&Analysis::resources());
   LOG(DEBUG3) << "Calculating importance factors...";
   double p_total = this->p_total();
   const std::vector<const mef::BasicEvent*>& basic_events =
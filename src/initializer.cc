@@ -20,7 +20,10 @@
 
 #include "initializer.h"
 
+#include <algorithm>
+#include <exception>
 #include <functional>  // std::mem_fn
+#include <optional>
 #include <sstream>
 #include <type_traits>
 
@@ -43,12 +46,32 @@
 #include "expression/test_event.h"
 #include "ext/algorithm.h"
 #include "ext/find_iterator.h"
+#include "ext/parallel.h"
 #include "logger.h"
 
 namespace scram::mef {
 
 namespace {  // Helper function and wrappers for MEF initializations.
 
+/// Visits the XML element and its descendant elements in pre-order.
+///
+/// @tparam F  The visitor type: (const xml::Element&) -> bool.
+///
+/// @param[in] element  The element to start the traversal from.
+/// @param[in] visitor  The visitor returning false to stop the traversal.
+///
+/// @returns false if the traversal has been stopped.
+template <class F>
+bool VisitPreOrder(const xml::Element& element, F&& visitor) {
+  if (!visitor(element))
+    return false;
+  for (const xml::Element& child : element.children()) {
+    if (!VisitPreOrder(child, visitor))
+      return false;
+  }
+  return true;
+}
+
 /// Maps string to the role specifier.
 ///
 /// @param[in] s  Non-empty, valid role specifier string.
@@ -83,7 +106,7 @@ void AttachLabelAndAttributes(const xml::Element& xml_element,
                               Element* element) {
   if (std::optional<xml::Element> label = xml_element.child("label")) {
     assert(element->label().empty() && "Resetting element label.");
-    element->label(std::string(label->text()));
+    element->label(label->text());
   }
 
   std::optional<xml::Element> attributes = xml_element.child("attributes");
@@ -106,8 +129,7 @@ void AttachLabelAndAttributes(const xml::Element& xml_element,
 template <class T>
 std::enable_if_t<std::is_base_of_v<Element, T>, std::unique_ptr<T>>
 ConstructElement(const xml::Element& xml_element) {
-  auto element =
-      std::make_unique<T>(std::string(xml_element.attribute("name")));
+  auto element = std::make_unique<T>(xml_element.attribute("name"));
   AttachLabelAndAttributes(xml_element, element.get());
   return element;
 }
@@ -118,7 +140,7 @@ std::enable_if_t<std::is_base_of_v<Role, T>, std::unique_ptr<T>>
 ConstructElement(const xml::Element& xml_element, const std::string& base_path,
                  RoleSpecifier base_role) {
   auto element =
-      std::make_unique<T>(std::string(xml_element.attribute("name")), base_path,
+      std::make_unique<T>(xml_element.attribute("name"), base_path,
                           GetRole(xml_element.attribute("role"), base_role));
   AttachLabelAndAttributes(xml_element, element.get());
   return element;
@@ -165,6 +187,15 @@ Initializer::Initializer(const std::vector<std::string>& xml_files,
   ProcessInputFiles(xml_files);
 }
 
+Initializer::Initializer(const Snapshot& snapshot, core::Settings settings,
+                         bool allow_extern)
+    : settings_(std::move(settings)),
+      allow_extern_(allow_extern),
+      extra_validator_(nullptr) {
+  BLOG(WARNING, allow_extern_) << "Enabling external dynamic libraries";
+  ProcessSnapshot(snapshot);
+}
+
 void Initializer::CheckFileExistence(
     const std::vector<std::string>& xml_files) {
   for (auto& xml_file : xml_files) {
@@ -192,28 +223,53 @@ void Initializer::ProcessInputFiles(const std::vector<std::string>& xml_files) {
   static xml::Validator validator(env::input_schema());
 
   CLOCK(input_time);
+  TRACE("Processing input files");
   LOG(DEBUG1) << "Processing input files";
   CheckFileExistence(xml_files);
   CheckDuplicateFiles(xml_files);
-  for (const auto& xml_file : xml_files) {
-    CLOCK(parse_time);
-    LOG(DEBUG3) << "Parsing " << xml_file << " ...";
-    xml::Document document(xml_file, &validator);
-    if (extra_validator_)
-      extra_validator_->validate(document);
-    documents_.emplace_back(std::move(document));
-    LOG(DEBUG3) << "Parsed " << xml_file << " in " << DUR(parse_time);
-  }
   CLOCK(def_time);
-  for (const xml::Document& document : documents_) {
-    try {
-      ProcessInputFile(document);
-    } catch (ValidityError& err) {
-      err << boost::errinfo_file_name(document.root().filename());
-      throw;
+  if (!extra_validator_ && settings_.targets().empty() &&
+      (xml_files.size() == 1 || settings_.num_threads() == 1)) {
+    // The elements are registered while the documents are streamed
+    // and defined while the documents are streamed again,
+    // so only one definition is in memory at a time.
+    for (const auto& xml_file : xml_files) {
+      CLOCK(parse_time);
+      TRACE("Parsing", xml_file);
+      LOG(DEBUG3) << "Parsing " << xml_file << " ...";
+      xml::Reader reader(xml_file, &validator);
+      try {
+        ProcessInputFile(&reader);
+      } catch (ValidityError& err) {
+        err << boost::errinfo_file_name(xml_file);
+        throw;
+      }
+      documents_.emplace_back(std::move(reader).document());
+      LOG(DEBUG3) << "Parsed " << xml_file << " in " << DUR(parse_time);
+    }
+    DefineExternFunctions();
+    int num_definitions = 0;
+    int num_tbd = 0;
+    for (const auto& xml_file : xml_files) {
+      xml::Reader reader(xml_file);  // Already validated.
+      DefineInputFile(&reader, &num_definitions, &num_tbd);
+    }
+    assert(num_tbd == tbd_.size() && "Undefined streamed elements.");
+    tbd_.clear();  // The XML elements are released by the readers.
+    streamed_.clear();
+    tbd_positions_.clear();
+  } else {
+    ParseInputFiles(xml_files, &validator);
+    for (const xml::Document& document : documents_) {
+      try {
+        ProcessInputFile(document);
+      } catch (ValidityError& err) {
+        err << boost::errinfo_file_name(document.root().filename());
+        throw;
+      }
     }
+    ProcessTbdElements();
   }
-  ProcessTbdElements();
   LOG(DEBUG2) << "Element definition time " << DUR(def_time);
   LOG(DEBUG1) << "Input files are processed in " << DUR(input_time);
 
@@ -232,6 +288,67 @@ void Initializer::ProcessInputFiles(const std::vector<std::string>& xml_files) {
   LOG(DEBUG1) << "Setup time " << DUR(setup_time);
 }
 
+void Initializer::ProcessSnapshot(const Snapshot& snapshot) {
+  CLOCK(input_time);
+  TRACE("Processing the snapshot");
+  LOG(DEBUG1) << "Processing the snapshot";
+  documents_ = snapshot.documents();
+  CLOCK(def_time);
+  for (const xml::Document& document : documents_)
+    ProcessInputFile(document);
+  ProcessTbdElements();
+  LOG(DEBUG2) << "Element definition time " << DUR(def_time);
+  LOG(DEBUG1) << "The snapshot is processed in " << DUR(input_time);
+
+  // The snapshot is taken only from the validated initialization;
+  // however, the expression domains depend on the current settings
+  // (e.g., the mission time).
+  CLOCK(valid_time);
+  ValidateExpressions();
+  LOG(DEBUG1) << "Expression validation is finished in " << DUR(valid_time);
+
+  CLOCK(setup_time);
+  LOG(DEBUG1) << "Setting up for the analysis";
+  SetupForAnalysis();
+  EnsureNoCcfSubstitutions();
+  EnsureSubstitutionsWithApproximations();
+  LOG(DEBUG1) << "Setup time " << DUR(setup_time);
+}
+
+void Initializer::ParseInputFiles(const std::vector<std::string>& xml_files,
+                                  xml::Validator* validator) {
+  std::vector<std::optional<xml::Document>> documents(xml_files.size());
+  std::vector<std::exception_ptr> errors(xml_files.size());
+  // Each reader has its own validation context for the shared schema.
+  ext::parallel_for(
+      xml_files.size(), settings_.num_threads(),
+      [&xml_files, validator, &documents, &errors](int i) {
+        CLOCK(parse_time);
+        TRACE("Parsing", xml_files[i]);
+        LOG(DEBUG3) << "Parsing " << xml_files[i] << " ...";
+        try {
+          xml::Reader reader(xml_files[i], validator);
+          while (reader.Next()) {
+            reader.Expand();
+            reader.Keep();
+          }
+          documents[i] = std::move(reader).document();
+        } catch (...) {  // Reported in the order of the files.
+          errors[i] = std::current_exception();
+          return;
+        }
+        LOG(DEBUG3) << "Parsed " << xml_files[i] << " in " << DUR(parse_time);
+      });
+
+  for (int i = 0; i < xml_files.size(); ++i) {
+    if (errors[i])
+      std::rethrow_exception(errors[i]);
+    if (extra_validator_)
+      extra_validator_->validate(*documents[i]);
+    documents_.push_back(std::move(*documents[i]));
+  }
+}
+
 template <class T>
 void Initializer::Register(std::unique_ptr<T> element,
                            const xml::Element& xml_element) {
@@ -351,60 +468,140 @@ Sequence* Initializer::Register(const xml::Element& xml_node,
 void Initializer::ProcessInputFile(const xml::Document& document) {
   xml::Element root = document.root();
   assert(root.name() == "opsa-mef");
+  DefineModel(root);
+  for (const xml::Element& node : root.children())
+    ProcessDefinition(node);
+}
+
+void Initializer::ProcessInputFile(xml::Reader* reader) {
+  assert(reader->root().name() == "opsa-mef");
+  DefineModel(reader->root());
+  while (std::optional<xml::Element> node = reader->Next()) {
+    if (node->name() == "define-fault-tree") {
+      DefineFaultTree(reader);
+    } else if (node->name() == "model-data") {
+      reader->Enter();
+      while (reader->Next()) {
+        RegisterStreamed(reader, [this](const xml::Element& datum) {
+          ProcessModelDatum(datum);
+        });
+      }
+    } else if (node->name() == "define-extern-function") {
+      reader->Expand();
+      reader->Keep();  // Defined before all the other elements.
+      streamed_.push_back(0);
+    } else {
+      RegisterStreamed(reader, [this](const xml::Element& definition) {
+        ProcessDefinition(definition);
+      });
+    }
+  }
+}
+
+template <class F>
+void Initializer::RegisterStreamed(xml::Reader* reader, F&& registration) {
+  std::size_t num_tbd = tbd_.size();
+  xml::Element definition = reader->Expand();
+  registration(definition);
+  streamed_.push_back(tbd_.size() - num_tbd);
+  if (tbd_.size() == num_tbd)
+    return;  // Nothing refers to the completely defined element.
+  // The XML elements of the TBD elements are released with the definition,
+  // so they are found by their positions in the second reading.
+  tbd_positions_.resize(tbd_.size());
+  int position = 0;
+  std::size_t num_left = tbd_.size() - num_tbd;
+  VisitPreOrder(definition, [&](const xml::Element& node) {
+    for (std::size_t i = num_tbd; i < tbd_.size(); ++i) {
+      if (tbd_[i].second.get() == node.get()) {
+        tbd_positions_[i] = position;
+        --num_left;
+      }
+    }
+    ++position;
+    return num_left != 0;
+  });
+  assert(num_left == 0 && "TBD elements outside of the definition.");
+}
+
+void Initializer::DefineInputFile(xml::Reader* reader, int* num_definitions,
+                                  int* num_tbd) {
+  while (std::optional<xml::Element> node = reader->Next()) {
+    if (node->name() == "define-fault-tree" ||
+        node->name() == "define-component" || node->name() == "model-data") {
+      reader->Enter();
+      DefineInputFile(reader, num_definitions, num_tbd);
+      continue;
+    }
+    assert(*num_definitions < streamed_.size());
+    int end = *num_tbd + streamed_[(*num_definitions)++];
+    if (end == *num_tbd)
+      continue;  // Skipped without expansion.
+    int last = *std::max_element(tbd_positions_.begin() + *num_tbd,
+                                 tbd_positions_.begin() + end);
+    std::vector<xml::Element> nodes;
+    VisitPreOrder(reader->Expand(), [&nodes, last](const xml::Element& child) {
+      nodes.push_back(child);
+      return nodes.size() <= last;
+    });
+    for (; *num_tbd < end; ++*num_tbd)
+      DefineTbdEntry(*num_tbd, nodes[tbd_positions_[*num_tbd]]);
+  }
+}
 
+void Initializer::DefineModel(const xml::Element& root) {
   if (!model_) {  // Create only one model for multiple files.
     model_ = ConstructElement<Model>(root);
     model_->mission_time().value(settings_.mission_time());
   }
+}
 
-  for (const xml::Element& node : root.children()) {
-    if (node.name() == "define-initiating-event") {
-      std::unique_ptr<InitiatingEvent> initiating_event =
-          ConstructElement<InitiatingEvent>(node);
-      auto* ref_ptr = initiating_event.get();
-      Register(std::move(initiating_event), node);
-      tbd_.emplace_back(ref_ptr, node);
+void Initializer::ProcessDefinition(const xml::Element& node) {
+  if (node.name() == "define-initiating-event") {
+    std::unique_ptr<InitiatingEvent> initiating_event =
+        ConstructElement<InitiatingEvent>(node);
+    auto* ref_ptr = initiating_event.get();
+    Register(std::move(initiating_event), node);
+    tbd_.emplace_back(ref_ptr, node);
 
-    } else if (node.name() == "define-rule") {
-      std::unique_ptr<Rule> rule = ConstructElement<Rule>(node);
-      auto* ref_ptr = rule.get();
-      Register(std::move(rule), node);
-      tbd_.emplace_back(ref_ptr, node);
+  } else if (node.name() == "define-rule") {
+    std::unique_ptr<Rule> rule = ConstructElement<Rule>(node);
+    auto* ref_ptr = rule.get();
+    Register(std::move(rule), node);
+    tbd_.emplace_back(ref_ptr, node);
 
-    } else if (node.name() == "define-event-tree") {
-      DefineEventTree(node);
+  } else if (node.name() == "define-event-tree") {
+    DefineEventTree(node);
 
-    } else if (node.name() == "define-fault-tree") {
-      DefineFaultTree(node);
+  } else if (node.name() == "define-fault-tree") {
+    DefineFaultTree(node);
 
-    } else if (node.name() == "define-CCF-group") {
-      Register<CcfGroup>(node, "", RoleSpecifier::kPublic);
+  } else if (node.name() == "define-CCF-group") {
+    Register<CcfGroup>(node, "", RoleSpecifier::kPublic);
 
-    } else if (node.name() == "define-alignment") {
-      std::unique_ptr<Alignment> alignment = ConstructElement<Alignment>(node);
-      auto* address = alignment.get();
-      Register(std::move(alignment), node);
-      tbd_.emplace_back(address, node);
+  } else if (node.name() == "define-alignment") {
+    std::unique_ptr<Alignment> alignment = ConstructElement<Alignment>(node);
+    auto* address = alignment.get();
+    Register(std::move(alignment), node);
+    tbd_.emplace_back(address, node);
 
-    } else if (node.name() == "define-substitution") {
-      std::unique_ptr<Substitution> substitution =
-          ConstructElement<Substitution>(node);
-      auto* address = substitution.get();
-      Register(std::move(substitution), node);
-      tbd_.emplace_back(address, node);
+  } else if (node.name() == "define-substitution") {
+    std::unique_ptr<Substitution> substitution =
+        ConstructElement<Substitution>(node);
+    auto* address = substitution.get();
+    Register(std::move(substitution), node);
+    tbd_.emplace_back(address, node);
 
-    } else if (node.name() == "model-data") {
-      ProcessModelData(node);
+  } else if (node.name() == "model-data") {
+    ProcessModelData(node);
 
-    } else if (node.name() == "define-extern-library") {
-      if (!allow_extern_) {
-        SCRAM_THROW(
-            IllegalOperation("Loading external libraries is disallowed!"))
-            << boost::errinfo_file_name(node.filename())
-            << boost::errinfo_at_line(node.line());
-      }
-      DefineExternLibraries(node);
+  } else if (node.name() == "define-extern-library") {
+    if (!allow_extern_) {
+      SCRAM_THROW(IllegalOperation("Loading external libraries is disallowed!"))
+          << boost::errinfo_file_name(node.filename())
+          << boost::errinfo_at_line(node.line());
     }
+    DefineExternLibraries(node);
   }
 }
 
@@ -473,7 +670,7 @@ template <>
 void Initializer::Define(const xml::Element& et_node, EventTree* event_tree) {
   for (const xml::Element& node : et_node.children("define-branch")) {
     auto it = ext::find(event_tree->table<NamedBranch>(),
-                        std::string(node.attribute("name")));
+                        Symbol(node.attribute("name")));
     assert(it);
     DefineBranch(GetNonAttributeElements(node), event_tree, &*it);
   }
@@ -489,7 +686,7 @@ void Initializer::Define(const xml::Element& xml_node,
   std::string_view event_tree_name = xml_node.attribute("event-tree");
   if (!event_tree_name.empty()) {
     try {
-      auto& event_tree = model_->Get<EventTree>(event_tree_name);
+      auto& event_tree = *Require(&model_->Get<EventTree>(event_tree_name));
       initiating_event->event_tree(&event_tree);
       initiating_event->usage(true);
       event_tree.usage(true);
@@ -590,7 +787,30 @@ void Initializer::Define(const xml::Element& xml_node,
 }
 /// @}
 
-void Initializer::ProcessTbdElements() {
+template <class T>
+void Initializer::DefineTbdElement(const xml::Element& xml_node, T* element) {
+  deviate_owner_ = T::kTypeString;
+  deviate_owner_ += ' ';
+  deviate_owner_ += Id::unique_name(*element);
+  num_owner_deviates_ = 0;
+  Define(xml_node, element);
+}
+
+void Initializer::DefineTbdEntry(std::size_t index,
+                                 const xml::Element& xml_element) {
+  try {
+    std::visit(
+        [this, &xml_element](auto* tbd_construct) {
+          this->DefineTbdElement(xml_element, tbd_construct);
+        },
+        tbd_[index].first);
+  } catch (ValidityError& err) {
+    err << boost::errinfo_file_name(xml_element.filename());
+    throw;
+  }
+}
+
+void Initializer::DefineExternFunctions() {
   for (const xml::Document& document : documents_) {
     xml::Element root = document.root();
     for (const xml::Element& node : root.children("define-extern-function")) {
@@ -602,19 +822,140 @@ void Initializer::ProcessTbdElements() {
       }
     }
   }
+}
 
-  for (const auto& [tbd_element, xml_element] : tbd_) {
-    try {
-      std::visit(
-          [this, &xml_element](auto* tbd_construct) {
-            this->Define(xml_element, tbd_construct);
-          },
-          tbd_element);
-    } catch (ValidityError& err) {
-      err << boost::errinfo_file_name(xml_element.filename());
-      throw;
+void Initializer::ProcessTbdElements() {
+  DefineExternFunctions();
+
+  if (!settings_.targets().empty()) {
+    ProcessReachableElements();
+    return;
+  }
+
+  for (std::size_t i = 0; i < tbd_.size(); ++i)
+    DefineTbdEntry(i, tbd_[i].second);
+}
+
+void Initializer::ProcessReachableElements() {
+  assert(!settings_.targets().empty());
+  for (int i = 0; i < static_cast<int>(tbd_.size()); ++i) {
+    unreachable_.emplace(
+        std::visit([](const Element* element) { return element; },
+                   tbd_[i].first),
+        i);
+  }
+  for (CcfGroup& ccf_group : model_->table<CcfGroup>()) {
+    for (BasicEvent* member : ccf_group.members())
+      ccf_members_.emplace(member, &ccf_group);
+  }
+
+  // The model-wide analysis constructs apply to any target.
+  for (Alignment& alignment : model_->table<Alignment>())
+    Require(&alignment);
+  for (Substitution& substitution : model_->table<Substitution>())
+    Require(&substitution);
+
+  for (const std::string& target : settings_.targets()) {
+    if (auto it = ext::find(model_->table<InitiatingEvent>(), Symbol(target))) {
+      Require(&*it);
+    } else {
+      GetGate(target, "");  // Throws if the target is not a gate.
     }
   }
+
+  // The definitions discover more reachable elements on the go.
+  for (std::size_t i = 0; i < reachable_.size(); ++i)
+    DefineTbdEntry(reachable_[i], tbd_[reachable_[i]].second);
+  LOG(DEBUG2) << "Defined " << reachable_.size() << " reachable elements; "
+              << unreachable_.size() << " unreachable elements are removed";
+  RemoveUnreachableElements();
+}
+
+template <class T>
+T* Initializer::Require(T* element) {
+  if (settings_.targets().empty())
+    return element;  // All elements are defined unconditionally.
+
+  if constexpr (std::is_same_v<T, BasicEvent>) {  // Not TBD if in CCF.
+    if (auto it = ccf_members_.find(element); it != ccf_members_.end())
+      Require(it->second);
+  }
+
+  auto it = unreachable_.find(element);
+  if (it == unreachable_.end())
+    return element;  // Already reached or defined w/o the TBD stage.
+  reachable_.push_back(it->second);
+  unreachable_.erase(it);
+
+  if constexpr (std::is_same_v<T, EventTree>) {
+    for (Sequence& sequence : element->template table<Sequence>())
+      Require(&sequence);
+  }
+  return element;
+}
+
+void Initializer::RemoveUnreachableElements() {
+  std::unordered_set<const Element*> garbage;
+  for (const auto& entry : unreachable_)
+    garbage.insert(entry.first);
+  std::vector<BasicEvent*> ccf_events;
+  for (const auto& [member, ccf_group] : ccf_members_) {
+    if (garbage.count(ccf_group)) {
+      garbage.insert(member);
+      ccf_events.push_back(const_cast<BasicEvent*>(member));
+    }
+  }
+
+  // Components only refer to the elements owned by the model.
+  std::function<void(Component*)> prune = [&garbage, &prune](
+                                              Component* component) {
+    auto remove = [&garbage, component](auto table) {
+      std::vector<std::decay_t<decltype(*table.begin())>*> elements;
+      for (auto& element : table) {
+        if (garbage.count(&element))
+          elements.push_back(&element);
+      }
+      for (auto* element : elements)
+        component->Remove(element);
+    };
+    remove(component->table<Gate>());
+    remove(component->table<BasicEvent>());
+    remove(component->table<Parameter>());
+    remove(component->table<CcfGroup>());
+    for (Component& child : component->table<Component>())
+      prune(&child);
+  };
+  for (FaultTree& fault_tree : model_->table<FaultTree>())
+    prune(&fault_tree);
+
+  for (BasicEvent* member : ccf_events) {
+    path_basic_events_.erase(member->full_path());
+    model_->Remove(member);
+  }
+  std::vector<bool> removed(tbd_.size());
+  for (const auto& [unreachable, position] : unreachable_) {
+    removed[position] = true;
+    std::visit(
+        [this](auto* element) {
+          using T = std::decay_t<decltype(*element)>;
+          if constexpr (std::is_same_v<T, Gate>) {
+            path_gates_.erase(element->full_path());
+          } else if constexpr (std::is_same_v<T, BasicEvent>) {
+            path_basic_events_.erase(element->full_path());
+          } else if constexpr (std::is_same_v<T, Parameter>) {
+            path_parameters_.erase(element->full_path());
+          }
+          model_->Remove(element);
+        },
+        tbd_[position].first);
+  }
+  int num_tbd = 0;
+  for (std::size_t i = 0; i < tbd_.size(); ++i) {
+    if (!removed[i])
+      tbd_[num_tbd++] = std::move(tbd_[i]);
+  }
+  tbd_.erase(tbd_.begin() + num_tbd, tbd_.end());
+  unreachable_.clear();
 }
 
 void Initializer::DefineEventTree(const xml::Element& et_node) {
@@ -651,6 +992,13 @@ void Initializer::DefineFaultTree(const xml::Element& ft_node) {
   Register(std::move(fault_tree), ft_node);
 }
 
+void Initializer::DefineFaultTree(xml::Reader* reader) {
+  xml::Element ft_node = reader->Enter();
+  std::unique_ptr<FaultTree> fault_tree = ConstructElement<FaultTree>(ft_node);
+  RegisterFaultTreeData(reader, fault_tree->name(), fault_tree.get());
+  Register(std::move(fault_tree), ft_node);
+}
+
 std::unique_ptr<Component> Initializer::DefineComponent(
     const xml::Element& component_node, const std::string& base_path,
     RoleSpecifier container_role) {
@@ -661,26 +1009,22 @@ std::unique_ptr<Component> Initializer::DefineComponent(
   return component;
 }
 
+std::unique_ptr<Component> Initializer::DefineComponent(
+    xml::Reader* reader, const std::string& base_path,
+    RoleSpecifier container_role) {
+  xml::Element component_node = reader->Enter();
+  std::unique_ptr<Component> component =
+      ConstructElement<Component>(component_node, base_path, container_role);
+  RegisterFaultTreeData(reader, base_path + "." + component->name(),
+                        component.get());
+  return component;
+}
+
 void Initializer::RegisterFaultTreeData(const xml::Element& ft_node,
                                         const std::string& base_path,
                                         Component* component) {
   for (const xml::Element& node : ft_node.children()) {
-    if (node.name() == "define-basic-event") {
-      component->Add(Register<BasicEvent>(node, base_path, component->role()));
-
-    } else if (node.name() == "define-parameter") {
-      component->Add(Register<Parameter>(node, base_path, component->role()));
-
-    } else if (node.name() == "define-gate") {
-      component->Add(Register<Gate>(node, base_path, component->role()));
-
-    } else if (node.name() == "define-house-event") {
-      component->Add(Register<HouseEvent>(node, base_path, component->role()));
-
-    } else if (node.name() == "define-CCF-group") {
-      component->Add(Register<CcfGroup>(node, base_path, component->role()));
-
-    } else if (node.name() == "define-component") {
+    if (node.name() == "define-component") {
       std::unique_ptr<Component> sub =
           DefineComponent(node, base_path, component->role());
       try {
@@ -689,22 +1033,69 @@ void Initializer::RegisterFaultTreeData(const xml::Element& ft_node,
         err << boost::errinfo_at_line(node.line());
         throw;
       }
+    } else {
+      RegisterFaultTreeDatum(node, base_path, component);
     }
   }
 }
 
-void Initializer::ProcessModelData(const xml::Element& model_data) {
-  for (const xml::Element& node : model_data.children()) {
-    if (node.name() == "define-basic-event") {
-      Register<BasicEvent>(node, "", RoleSpecifier::kPublic);
-    } else if (node.name() == "define-parameter") {
-      Register<Parameter>(node, "", RoleSpecifier::kPublic);
-    } else if (node.name() == "define-house-event") {
-      Register<HouseEvent>(node, "", RoleSpecifier::kPublic);
+void Initializer::RegisterFaultTreeData(xml::Reader* reader,
+                                        const std::string& base_path,
+                                        Component* component) {
+  while (std::optional<xml::Element> node = reader->Next()) {
+    if (node->name() == "define-component") {
+      int line = node->line();
+      std::unique_ptr<Component> sub =
+          DefineComponent(reader, base_path, component->role());
+      try {
+        component->Add(std::move(sub));
+      } catch (ValidityError& err) {
+        err << boost::errinfo_at_line(line);
+        throw;
+      }
+    } else {
+      RegisterStreamed(reader, [&](const xml::Element& datum) {
+        RegisterFaultTreeDatum(datum, base_path, component);
+      });
     }
   }
 }
 
+void Initializer::RegisterFaultTreeDatum(const xml::Element& node,
+                                         const std::string& base_path,
+                                         Component* component) {
+  if (node.name() == "define-basic-event") {
+    component->Add(Register<BasicEvent>(node, base_path, component->role()));
+
+  } else if (node.name() == "define-parameter") {
+    component->Add(Register<Parameter>(node, base_path, component->role()));
+
+  } else if (node.name() == "define-gate") {
+    component->Add(Register<Gate>(node, base_path, component->role()));
+
+  } else if (node.name() == "define-house-event") {
+    component->Add(Register<HouseEvent>(node, base_path, component->role()));
+
+  } else if (node.name() == "define-CCF-group") {
+    component->Add(Register<CcfGroup>(node, base_path, component->role()));
+  }
+}
+
+void Initializer::ProcessModelData(const xml::Element& model_data) {
+  for (const xml::Element& node : model_data.children())
+    ProcessModelDatum(node);
+}
+
+void Initializer::ProcessModelDatum(const xml::Element& node) {
+  if (node.name() == "define-basic-event") {
+    Register<BasicEvent>(node, "", RoleSpecifier::kPublic);
+  } else if (node.name() == "define-parameter") {
+    Register<Parameter>(node, "", RoleSpecifier::kPublic);
+  } else if (node.name() == "define-house-event") {
+    Register<HouseEvent>(node, "", RoleSpecifier::kPublic);
+  }
+}
+
 std::unique_ptr<Formula> Initializer::GetFormula(
     const xml::Element& formula_node, const std::string& base_path) {
   Connective formula_type = [&formula_node]() {
@@ -808,7 +1199,8 @@ void Initializer::DefineBranchTarget(const xml::Element& target_node,
         throw;
       }
     } else if (target_node.name() == "sequence") {
-      auto& sequence = model_->Get<Sequence>(target_node.attribute("name"));
+      auto& sequence = *Require(
+          &model_->Get<Sequence>(target_node.attribute("name")));
       branch->target(&sequence);
       sequence.usage(true);
     } else {
@@ -854,7 +1246,7 @@ Instruction* Initializer::GetInstruction(const xml::Element& xml_element) {
 
   if (node_name == "rule") {
     return invoke([&xml_element, this] {
-      auto& rule = model_->Get<Rule>(xml_element.attribute("name"));
+      auto& rule = *Require(&model_->Get<Rule>(xml_element.attribute("name")));
       rule.usage(true);
       return &rule;
     });
@@ -868,7 +1260,8 @@ Instruction* Initializer::GetInstruction(const xml::Element& xml_element) {
 
   if (node_name == "event-tree") {
     return invoke([&] {
-      auto& event_tree = model_->Get<EventTree>(xml_element.attribute("name"));
+      auto& event_tree =
+          *Require(&model_->Get<EventTree>(xml_element.attribute("name")));
       event_tree.usage(true);
       links_.push_back(static_cast<Link*>(
           register_instruction(std::make_unique<Link>(event_tree))));
@@ -908,7 +1301,7 @@ Instruction* Initializer::GetInstruction(const xml::Element& xml_element) {
 
   if (node_name == "set-house-event") {
     std::string_view name = xml_element.attribute("name");
-    if (!model_->house_events().count(name)) {
+    if (!model_->house_events().count(Symbol(name))) {
       SCRAM_THROW(UndefinedElement())
           << errinfo_element(std::string(name), "house event")
           << boost::errinfo_at_line(xml_element.line());
@@ -1216,8 +1609,14 @@ Expression* Initializer::GetExpression(const xml::Element& expr_element,
   try {
     Expression* expression = register_expression(kExpressionExtractors_.at(
         expr_type)(expr_element.children(), base_path, this));
+    if (auto* deviate = dynamic_cast<RandomDeviate*>(expression)) {
+      deviate->key(
+          RandomDeviate::MakeKey(deviate_owner_, num_owner_deviates_++));
+    }
     // Register for late validation after ensuring no cycles.
-    expressions_.emplace_back(expression, expr_element);
+    expressions_.push_back(
+        {expression,
+         {Symbol::Intern(expr_element.filename()), expr_element.line()}});
     return expression;
   } catch (ValidityError& err) {
     err << boost::errinfo_at_line(expr_element.line());
@@ -1321,13 +1720,14 @@ T* Initializer::GetEntity(std::string_view entity_reference,
   if (!base_path.empty()) {  // Check the local scope.
     std::string full_path = base_path + ".";
     full_path.append(entity_reference.data(), entity_reference.size());
-    if (auto it = ext::find(path_container, full_path))
-      return &*it;
+    if (auto it = ext::find(path_container, Symbol(full_path)))
+      return Require(&*it);
   }
 
-  auto at = [&entity_reference, &base_path](const auto& reference_container) {
-    if (auto it = ext::find(reference_container, entity_reference))
-      return &*it;
+  auto at = [this, &entity_reference,
+             &base_path](const auto& reference_container) {
+    if (auto it = ext::find(reference_container, Symbol(entity_reference)))
+      return Require(&*it);
     SCRAM_THROW(UndefinedElement())
         << errinfo_reference(std::string(entity_reference))
         << errinfo_base_path(base_path) << errinfo_element_type(T::kTypeString);
@@ -1343,11 +1743,11 @@ T* Initializer::GetEntity(std::string_view entity_reference,
 #define GET_EVENT(gates, basic_events, house_events, path_reference) \
   do {                                                               \
     if (auto it = ext::find(gates, path_reference))                  \
-      return &*it;                                                   \
+      return Require(&*it);                                          \
     if (auto it = ext::find(basic_events, path_reference))           \
-      return &*it;                                                   \
+      return Require(&*it);                                          \
     if (auto it = ext::find(house_events, path_reference))           \
-      return &*it;                                                   \
+      return Require(&*it);                                          \
   } while (false)
 
 Formula::ArgEvent Initializer::GetEvent(std::string_view entity_reference,
@@ -1359,16 +1759,18 @@ Formula::ArgEvent Initializer::GetEvent(std::string_view entity_reference,
   if (!base_path.empty()) {  // Check the local scope.
     std::string full_path = base_path + ".";
     full_path.append(entity_reference.data(), entity_reference.size());
+    Symbol path_key(full_path);
     GET_EVENT(TableRange(path_gates_), TableRange(path_basic_events_),
-              TableRange(path_house_events_), full_path);
+              TableRange(path_house_events_), path_key);
   }
 
+  Symbol key(entity_reference);  // One lookup for all the event tables.
   if (entity_reference.find('.') == std::string_view::npos) {  // Public entity.
     GET_EVENT(model_->table<Gate>(), model_->table<BasicEvent>(),
-              model_->table<HouseEvent>(), entity_reference);
+              model_->table<HouseEvent>(), key);
   } else {  // Direct access.
     GET_EVENT(TableRange(path_gates_), TableRange(path_basic_events_),
-              TableRange(path_house_events_), entity_reference);
+              TableRange(path_house_events_), key);
   }
   SCRAM_THROW(UndefinedElement())
       << errinfo_reference(std::string(entity_reference))
@@ -1461,7 +1863,8 @@ constexpr int Encode(int base_power = 1) noexcept {
 
 using ExternFunctionExtractor = ExternFunctionPtr (*)(std::string,
                                                       const std::string&,
-                                                      const ExternLibrary&);
+                                                      const ExternLibrary&,
+                                                      bool);
 using ExternFunctionExtractorMap =
     std::unordered_map<int, ExternFunctionExtractor>;
 
@@ -1480,9 +1883,9 @@ void GenerateExternFunctionExtractor(ExternFunctionExtractorMap* function_map) {
     function_map->emplace(
         Encode<Ts...>(),
         [](std::string name, const std::string& symbol,
-           const ExternLibrary& library) -> ExternFunctionPtr {
-          return std::make_unique<ExternFunction<Ts...>>(std::move(name),
-                                                         symbol, library);
+           const ExternLibrary& library, bool pure) -> ExternFunctionPtr {
+          return std::make_unique<ExternFunction<Ts...>>(
+              std::move(name), symbol, library, pure);
         });
   } else {
     GenerateExternFunctionExtractor<0, Ts...>(function_map);
@@ -1527,10 +1930,12 @@ void Initializer::DefineExternFunction(const xml::Element& xml_element) {
           << boost::errinfo_at_line(xml_element.line());
     }
     int encoding = Encode(args);
+    std::optional<bool> pure = xml_element.attribute<bool>("pure");
     try {
       return function_extractors.at(encoding)(
           std::string(xml_element.attribute("name")),
-          std::string(xml_element.attribute("symbol")), library);
+          std::string(xml_element.attribute("symbol")), library,
+          pure ? *pure : false);
     } catch (Error& err) {
       err << boost::errinfo_at_line(xml_element.line());
       throw;
@@ -1800,12 +2205,12 @@ void Initializer::ValidateExpressions() {
   cycle::CheckCycle<Parameter>(model_->table<Parameter>(), "parameter");
 
   // Validate expressions.
-  for (const std::pair<Expression*, xml::Element>& expression : expressions_) {
+  for (const auto& [expression, location] : expressions_) {
     try {
-      expression.first->Validate();
+      expression->Validate();
     } catch (ValidityError& err) {
-      err << boost::errinfo_file_name(expression.second.filename())
-          << boost::errinfo_at_line(expression.second.line());
+      err << boost::errinfo_file_name(location.file.str())
+          << boost::errinfo_at_line(location.line);
       throw;
     }
   }
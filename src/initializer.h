@@ -46,7 +46,9 @@
 #include "model.h"
 #include "parameter.h"
 #include "settings.h"
+#include "snapshot.h"
 #include "substitution.h"
+#include "symbol.h"
 #include "xml.h"
 
 namespace scram::mef {
@@ -82,6 +84,20 @@ class Initializer : private boost::noncopyable {
               core::Settings settings, bool allow_extern = false,
               xml::Validator* extra_validator = nullptr);
 
+  /// Initializes the analysis model from the snapshot of valid input files.
+  /// Only the validation depending on the settings is performed.
+  ///
+  /// @param[in] snapshot  The snapshot of the input files.
+  /// @param[in] settings  Analysis settings.
+  /// @param[in] allow_extern  Allow external libraries in the input.
+  ///
+  /// @throws IOError  The snapshot is inconsistent.
+  /// @throws mef::ValidityError  The model is invalid for the settings.
+  ///
+  /// @warning Processing external libraries from XML input is **UNSAFE**.
+  Initializer(const Snapshot& snapshot, core::Settings settings,
+              bool allow_extern = false);
+
   /// @returns The model built from the input files.
   std::unique_ptr<Model> model() && { return std::move(model_); }
 
@@ -101,9 +117,8 @@ class Initializer : private boost::noncopyable {
   template <typename T>
   using PathTable = boost::multi_index_container<
       T*, boost::multi_index::indexed_by<boost::multi_index::hashed_unique<
-              boost::multi_index::const_mem_fun<Id, std::string_view,
-                                                &Id::full_path>,
-              std::hash<std::string_view>>>>;
+              boost::multi_index::const_mem_fun<Id, Symbol, &Id::full_path>,
+              std::hash<Symbol>>>>;
 
   /// @tparam T  Type of an expression.
   /// @tparam N  The number of arguments for the expression.
@@ -157,6 +172,24 @@ class Initializer : private boost::noncopyable {
   /// @throws IOError  Input contains duplicate files.
   void ProcessInputFiles(const std::vector<std::string>& xml_files);
 
+  /// Defines the model from the documents of the snapshot.
+  ///
+  /// @param[in] snapshot  The snapshot of valid input files.
+  ///
+  /// @throws ValidityError  The expressions are invalid for the settings.
+  void ProcessSnapshot(const Snapshot& snapshot);
+
+  /// Parses and validates the input files concurrently.
+  /// The documents are stored in the order of the files.
+  ///
+  /// @param[in] xml_files  The XML input files.
+  /// @param[in] validator  The validator with the input schema.
+  ///
+  /// @throws xml::Error  The first error in the order of the files.
+  /// @throws IOError  One of the input files is not accessible.
+  void ParseInputFiles(const std::vector<std::string>& xml_files,
+                       xml::Validator* validator);
+
   /// Reads one input XML file document with the structure of analysis entities.
   /// Initializes the analysis from the given document.
   /// Puts all events into their appropriate containers.
@@ -172,6 +205,58 @@ class Initializer : private boost::noncopyable {
   /// @throws IllegalOperation  Loading external libraries is disallowed.
   void ProcessInputFile(const xml::Document& document);
 
+  /// @copybrief ProcessInputFile(const xml::Document&)
+  /// The definitions are registered one at a time
+  /// while the document is being read,
+  /// and all of them but the extern functions are discarded.
+  /// Only the positions of the elements left to be defined are recorded
+  /// for the second reading of the document.
+  ///
+  /// @param[in,out] reader  The streaming reader of a model input file.
+  ///
+  /// @throws xml::Error  The document is malformed or invalid.
+  /// @throws ValidityError  The input model contains errors.
+  /// @throws IllegalOperation  Loading external libraries is disallowed.
+  void ProcessInputFile(xml::Reader* reader);
+
+  /// Registers the current definition read from the stream
+  /// and records the positions of its elements left to be defined.
+  ///
+  /// @tparam F  The registration type: (const xml::Element&) -> void.
+  ///
+  /// @param[in,out] reader  The reader at the definition.
+  /// @param[in] registration  The registration of the expanded definition.
+  ///
+  /// @throws ValidityError  The definition contains errors.
+  template <class F>
+  void RegisterStreamed(xml::Reader* reader, F&& registration);
+
+  /// Defines the elements registered from the input file
+  /// while the (already validated) document is read the second time.
+  /// The definitions without elements to define are skipped unexpanded.
+  ///
+  /// @param[in,out] reader  The reader inside the entered element.
+  /// @param[in,out] num_definitions  The number of the streamed definitions
+  ///                                 read so far in all the files.
+  /// @param[in,out] num_tbd  The number of the elements defined so far.
+  ///
+  /// @throws ValidityError  The elements contain undefined dependencies.
+  void DefineInputFile(xml::Reader* reader, int* num_definitions,
+                       int* num_tbd);
+
+  /// Creates the model from the root of the first input document.
+  ///
+  /// @param[in] root  The root element with the model name and label.
+  void DefineModel(const xml::Element& root);
+
+  /// Processes a top-level definition of an input document.
+  ///
+  /// @param[in] node  The child element of the document root.
+  ///
+  /// @throws ValidityError  The input model contains errors.
+  /// @throws IllegalOperation  Loading external libraries is disallowed.
+  void ProcessDefinition(const xml::Element& node);
+
   /// Processes definitions of elements
   /// that are left to be determined later.
   /// This late definition happens primarily due to unregistered dependencies.
@@ -179,6 +264,48 @@ class Initializer : private boost::noncopyable {
   /// @throws ValidityError  The elements contain undefined dependencies.
   void ProcessTbdElements();
 
+  /// Defines the extern functions of all the documents
+  /// before the elements that may call them.
+  ///
+  /// @throws ValidityError  The extern functions contain errors.
+  void DefineExternFunctions();
+
+  /// Defines the element left to be determined later.
+  ///
+  /// @param[in] index  The position of the element in the TBD container.
+  /// @param[in] xml_element  The XML element defining the element.
+  ///
+  /// @throws ValidityError  The element contains undefined dependencies.
+  void DefineTbdEntry(std::size_t index, const xml::Element& xml_element);
+
+  /// Defines only the elements reachable from the analysis targets
+  /// through formulas, expressions, event-tree links, and substitutions.
+  /// The unreachable elements are removed from the model,
+  /// so the validation, CCF expansion, and analysis skip them.
+  ///
+  /// @throws UndefinedElement  The analysis target is not in the model.
+  /// @throws ValidityError  The reachable elements contain errors.
+  ///
+  /// @pre The analysis targets are given in the settings.
+  void ProcessReachableElements();
+
+  /// Marks the element as reachable from the analysis targets
+  /// to be defined later if it is not yet defined.
+  /// Reaching a member of a CCF group reaches the whole group,
+  /// and reaching an event tree reaches all its sequences.
+  ///
+  /// @tparam T  The element type.
+  ///
+  /// @param[in] element  The element referenced by a reachable element.
+  ///
+  /// @returns The given element.
+  template <class T>
+  T* Require(T* element);
+
+  /// Removes the elements unreachable from the analysis targets
+  /// from the model and its fault trees.
+  void RemoveUnreachableElements();
+
   /// Registers an element into the model.
   ///
   /// @tparam T  The element type.
@@ -217,6 +344,18 @@ class Initializer : private boost::noncopyable {
   template <class T>
   void Define(const xml::Element& xml_node, T* element);
 
+  /// Defines the registered element
+  /// keying the random deviates of the definition on the element.
+  ///
+  /// @tparam T  The Element type.
+  ///
+  /// @param[in] xml_node  XML element defining the element.
+  /// @param[in,out] element  Registered element ready to be defined.
+  ///
+  /// @throws ValidityError  Issues with the additional data.
+  template <class T>
+  void DefineTbdElement(const xml::Element& xml_node, T* element);
+
   /// Defines an event tree for the analysis.
   ///
   /// @param[in] et_node  XML element defining the event tree.
@@ -234,6 +373,11 @@ class Initializer : private boost::noncopyable {
   ///                        like gates and events.
   void DefineFaultTree(const xml::Element& ft_node);
 
+  /// @copydoc DefineFaultTree(const xml::Element&)
+  ///
+  /// @param[in,out] reader  The reader at the fault tree element to enter.
+  void DefineFaultTree(xml::Reader* reader);
+
   /// Defines a component container.
   ///
   /// @param[in] component_node  XML element defining the component.
@@ -249,6 +393,21 @@ class Initializer : private boost::noncopyable {
                                              const std::string& base_path,
                                              RoleSpecifier container_role);
 
+  /// @copybrief DefineComponent(const xml::Element&, const std::string&,
+  ///                            RoleSpecifier)
+  ///
+  /// @param[in,out] reader  The reader at the component element to enter.
+  /// @param[in] base_path  Series of ancestor containers in the path with dots.
+  /// @param[in] container_role  The parent container's role.
+  ///
+  /// @returns Component that is ready for registration.
+  ///
+  /// @throws ValidityError  There are issues with registering
+  ///                        the component and its data.
+  std::unique_ptr<Component> DefineComponent(xml::Reader* reader,
+                                             const std::string& base_path,
+                                             RoleSpecifier container_role);
+
   /// Registers fault tree and component data
   /// like gates, events, parameters.
   ///
@@ -263,11 +422,38 @@ class Initializer : private boost::noncopyable {
                              const std::string& base_path,
                              Component* component);
 
+  /// @copybrief RegisterFaultTreeData(const xml::Element&,
+  ///                                  const std::string&, Component*)
+  ///
+  /// @param[in,out] reader  The reader inside the entered container.
+  /// @param[in] base_path  Series of ancestor containers in the path with dots.
+  /// @param[in,out] component  The owner container of the data.
+  ///
+  /// @throws ValidityError  There are issues with registering the data.
+  void RegisterFaultTreeData(xml::Reader* reader, const std::string& base_path,
+                             Component* component);
+
+  /// Registers a gate, event, parameter, or CCF group of the container.
+  ///
+  /// @param[in] node  XML element defining the container datum.
+  /// @param[in] base_path  Series of ancestor containers in the path with dots.
+  /// @param[in,out] component  The owner container of the datum.
+  ///
+  /// @throws ValidityError  There are issues with registering the datum.
+  void RegisterFaultTreeDatum(const xml::Element& node,
+                              const std::string& base_path,
+                              Component* component);
+
   /// Processes model data with definitions of events and analysis.
   ///
   /// @param[in] model_data  XML node with model data description.
   void ProcessModelData(const xml::Element& model_data);
 
+  /// Registers a public event or parameter of the model data.
+  ///
+  /// @param[in] node  XML element defining the event or parameter.
+  void ProcessModelDatum(const xml::Element& node);
+
   /// Creates a Boolean formula from the XML elements
   /// describing the formula with events and other nested formulas.
   ///
@@ -515,8 +701,33 @@ class Initializer : private boost::noncopyable {
                InitiatingEvent, Rule, Alignment, Substitution>
       tbd_;
 
+  /// Positions of the TBD elements that are not reachable (yet)
+  /// from the analysis targets.
+  std::unordered_map<const Element*, int> unreachable_;
+  /// Positions of the reachable TBD elements in the order of discovery.
+  std::vector<int> reachable_;
+  /// The CCF groups of the member basic events.
+  std::unordered_map<const BasicEvent*, CcfGroup*> ccf_members_;
+
+  /// The designation of the element being defined for random deviate keys.
+  std::string deviate_owner_;
+  /// The number of random deviates in the element definition so far.
+  int num_owner_deviates_ = 0;
+
+  /// The numbers of the elements left to be defined
+  /// in the definitions streamed from the input files in the document order.
+  std::vector<int> streamed_;
+  /// The pre-order positions of the TBD elements' XML elements
+  /// in their streamed definitions.
+  std::vector<int> tbd_positions_;
+
+  /// The source location of an XML element.
+  struct Location {
+    Symbol file;  ///< The input file.
+    int line;  ///< The line in the file.
+  };
   /// Container of defined expressions for later validation due to cycles.
-  std::vector<std::pair<Expression*, xml::Element>> expressions_;
+  std::vector<std::pair<Expression*, Location>> expressions_;
   /// Container for event tree links to check for cycles.
   std::vector<Link*> links_;
 
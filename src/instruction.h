@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <boost/noncopyable.hpp>
@@ -56,17 +57,20 @@ class SetHouseEvent : public Visitable<SetHouseEvent> {
  public:
   /// @param[in] name  Non-empty public house-event name.
   /// @param[in] state  The new state for the given house-event.
-  SetHouseEvent(std::string name, bool state)
-      : name_(std::move(name)), state_(state) {}
+  SetHouseEvent(std::string_view name, bool state)
+      : name_(Symbol::Intern(name)), state_(state) {}
 
   /// @returns The name of the house-event to apply this instruction.
-  const std::string& name() const { return name_; }
+  const std::string& name() const { return name_.str(); }
+
+  /// @returns The interned name to look up the house-event.
+  Symbol symbol() const { return name_; }
 
   /// @returns The state of the target house-event to be changed into.
   bool state() const { return state_; }
 
  private:
-  std::string name_;  ///< The public name of the house event.
+  Symbol name_;  ///< The public name of the house event.
   bool state_;  ///< The state for the house event.
 };
 
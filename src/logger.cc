@@ -17,12 +17,24 @@
 
 /// @file
 /// Initializing static members and member functions of Logger class.
+/// Implementation of the trace timeline recording.
 
 #include "logger.h"
 
+#include <cerrno>
 #include <cstdio>
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
+
+#include <boost/exception/errinfo_errno.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/exception/errinfo_file_open_mode.hpp>
+
+#include "error.h"
 
 namespace scram {
 
@@ -44,4 +56,127 @@ std::ostringstream& Logger::Get(LogLevel level) {
   return os_;
 }
 
+bool Tracer::enabled_ = false;
+
+namespace {  // The storage of the trace records.
+
+/// The complete span of the trace.
+struct TraceEvent {
+  const char* name;  ///< The static name of the span.
+  std::string detail;  ///< The optional identifier of the work.
+  std::uint64_t start;  ///< The time stamp of the beginning.
+  std::uint64_t end;  ///< The time stamp of the end.
+};
+
+/// The trace records of a single thread.
+struct TraceBuffer {
+  int tid;  ///< The sequential identifier of the thread in the trace.
+  std::vector<TraceEvent> events;  ///< The spans in the order of completion.
+};
+
+/// The buffers of all the recording threads.
+/// The buffers outlive their threads to be written after joins.
+struct TraceRegistry {
+  std::mutex mutex;  ///< Guards the registration of the thread buffers.
+  std::vector<std::unique_ptr<TraceBuffer>> buffers;  ///< Stable storage.
+  std::uint64_t origin = 0;  ///< The time stamp of the tracing start.
+};
+
+TraceRegistry g_trace_registry;  ///< The process-wide trace storage.
+thread_local TraceBuffer* t_trace_buffer = nullptr;  ///< The thread buffer.
+
+/// Writes a JSON string literal with escaped special characters.
+///
+/// @param[in] value  The string to be quoted.
+/// @param[in,out] fp  The output stream.
+void PutJsonString(const char* value, std::FILE* fp) {
+  std::fputc('"', fp);
+  for (; *value; ++value) {
+    switch (*value) {
+      case '"':
+        std::fputs("\\\"", fp);
+        break;
+      case '\\':
+        std::fputs("\\\\", fp);
+        break;
+      default:
+        if (static_cast<unsigned char>(*value) < 0x20) {
+          std::fprintf(fp, "\\u%04x", *value);
+        } else {
+          std::fputc(*value, fp);
+        }
+    }
+  }
+  std::fputc('"', fp);
+}
+
+}  // namespace
+
+void Tracer::Start() noexcept {
+  std::lock_guard<std::mutex> lock(g_trace_registry.mutex);
+  for (std::unique_ptr<TraceBuffer>& buffer : g_trace_registry.buffers)
+    buffer->events.clear();
+  g_trace_registry.origin = TIME_STAMP();
+  enabled_ = true;
+}
+
+void Tracer::Record(const char* name, const std::string* detail,
+                    std::uint64_t start, std::uint64_t end) noexcept {
+  if (!t_trace_buffer) {
+    std::lock_guard<std::mutex> lock(g_trace_registry.mutex);
+    int tid = g_trace_registry.buffers.size() + 1;
+    t_trace_buffer = g_trace_registry.buffers
+                         .emplace_back(new TraceBuffer{tid, {}})
+                         .get();
+  }
+  t_trace_buffer->events.push_back(
+      {name, detail ? *detail : std::string(), start, end});
+}
+
+void Tracer::Write(const std::string& file) {
+  enabled_ = false;
+  std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+      std::fopen(file.c_str(), "w"), &std::fclose);
+  if (!fp) {
+    SCRAM_THROW(IOError("Cannot open the trace file."))
+        << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("w")
+        << boost::errinfo_file_name(file);
+  }
+  std::lock_guard<std::mutex> lock(g_trace_registry.mutex);
+  std::uint64_t origin = g_trace_registry.origin;
+  const char* separator = "\n";
+  std::fputs("{\"traceEvents\": [", fp.get());
+  for (const std::unique_ptr<TraceBuffer>& buffer : g_trace_registry.buffers) {
+    if (buffer->events.empty())
+      continue;
+    std::fprintf(fp.get(),
+                 "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+                 "\"tid\": %d, \"args\": {\"name\": \"thread %d\"}}",
+                 separator, buffer->tid, buffer->tid);
+    separator = ",\n";
+    for (const TraceEvent& event : buffer->events) {
+      std::fprintf(fp.get(), ",\n{\"name\": ");
+      PutJsonString(event.name, fp.get());
+      // Spans started before the tracing are clipped.
+      std::uint64_t start = std::max(event.start, origin);
+      std::fprintf(fp.get(),
+                   ", \"cat\": \"scram\", \"ph\": \"X\", \"pid\": 1, "
+                   "\"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+                   buffer->tid, (start - origin) * 1e-3,
+                   (event.end - start) * 1e-3);
+      if (!event.detail.empty()) {
+        std::fputs(", \"args\": {\"id\": ", fp.get());
+        PutJsonString(event.detail.c_str(), fp.get());
+        std::fputc('}', fp.get());
+      }
+      std::fputc('}', fp.get());
+    }
+  }
+  std::fputs("\n], \"displayTimeUnit\": \"ms\"}\n", fp.get());
+  if (std::fflush(fp.get()) || std::ferror(fp.get())) {
+    SCRAM_THROW(IOError("Cannot write the trace file."))
+        << boost::errinfo_errno(errno) << boost::errinfo_file_name(file);
+  }
+}
+
 }  // namespace scram
@@ -25,6 +25,10 @@
 ///
 /// The timing facilities are inspired by
 /// the talk of Bryce Adelstein "Benchmarking C++ Code" at CppCon 2015.
+///
+/// The timers and trace spans are recorded into a timeline
+/// in the Chrome Trace Event format (chrome://tracing, Perfetto)
+/// if the tracing is started.
 
 #pragma once
 
@@ -32,6 +36,7 @@
 
 #include <chrono>
 #include <sstream>
+#include <string>
 
 #include <boost/noncopyable.hpp>
 #include <boost/preprocessor/cat.hpp>
@@ -52,9 +57,13 @@ namespace scram {
 #define DUR(var) (TIME_STAMP() - var) * 1e-9
 
 /// Creates an automatic unique logging timer for a scope.
+/// The timer is also recorded as a trace span.
 #define TIMER(level, ...) \
   Timer<level> BOOST_PP_CAT(timer_, __LINE__)(__VA_ARGS__)
 
+/// Creates an automatic unique trace span for a scope.
+#define TRACE(...) scram::TraceSpan BOOST_PP_CAT(trace_, __LINE__)(__VA_ARGS__)
+
 // clang-format off
 /// Logging with a level.
 #define LOG(level) \
@@ -128,6 +137,71 @@ class Logger : private boost::noncopyable {
   std::ostringstream os_;  ///< Main stringstream to gather the logs.
 };
 
+/// Recorder of the nested time spans of all threads
+/// into a timeline in the Chrome Trace Event format.
+///
+/// The spans are buffered per thread without synchronization.
+/// If the tracing is not started,
+/// the spans cost a check of a global flag.
+class Tracer {
+ public:
+  /// @returns true if the spans are being recorded.
+  static bool enabled() { return enabled_; }
+
+  /// Discards the previous records and starts recording the spans.
+  ///
+  /// @pre No spans are being recorded concurrently.
+  static void Start() noexcept;
+
+  /// Records a complete span on the current thread.
+  ///
+  /// @param[in] name  The name of the span with static storage duration.
+  /// @param[in] detail  The optional identifier of the spanned work.
+  /// @param[in] start  The time stamp of the beginning of the span.
+  /// @param[in] end  The time stamp of the end of the span.
+  static void Record(const char* name, const std::string* detail,
+                     std::uint64_t start, std::uint64_t end) noexcept;
+
+  /// Stops the recording and writes the timeline in JSON.
+  ///
+  /// @param[in] file  The destination file for the timeline.
+  ///
+  /// @throws IOError  The file cannot be written.
+  ///
+  /// @pre All the recording threads have finished.
+  static void Write(const std::string& file);
+
+ private:
+  static bool enabled_;  ///< The indicator of the recording.
+};
+
+/// Automatic (scoped) span in the trace timeline.
+class TraceSpan : private boost::noncopyable {
+ public:
+  /// @param[in] name  The name of the span with static storage duration.
+  explicit TraceSpan(const char* name)
+      : name_(name), start_(Tracer::enabled() ? TIME_STAMP() : 0) {}
+
+  /// @param[in] name  The name of the span with static storage duration.
+  /// @param[in] detail  The identifier of the spanned work
+  ///                    that outlives the span.
+  TraceSpan(const char* name, const std::string& detail)
+      : TraceSpan(name) {
+    detail_ = &detail;
+  }
+
+  /// Records the span if the tracing is enabled.
+  ~TraceSpan() {
+    if (start_)
+      Tracer::Record(name_, detail_, start_, TIME_STAMP());
+  }
+
+ private:
+  const char* name_;  ///< The name of the span.
+  const std::string* detail_ = nullptr;  ///< The optional identifier.
+  std::uint64_t start_;  ///< The start time or 0 if not tracing.
+};
+
 /// Automatic (scoped) timer to log process duration.
 template <LogLevel Level>
 class Timer {
@@ -138,9 +212,11 @@ class Timer {
     LOG(Level) << process_name_ << "...";
   }
 
-  /// Puts the accumulated time into the logs.
+  /// Puts the accumulated time into the logs and the trace.
   ~Timer() {
     LOG(Level) << "Finished " << process_name_ << " in " << DUR(process_time_);
+    if (Tracer::enabled())
+      Tracer::Record(process_name_, nullptr, process_time_, TIME_STAMP());
   }
 
  private:
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the read-only memory mapping of files.
+
+#include "mapped_file.h"
+
+#include <cerrno>
+
+#include <boost/exception/errinfo_errno.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/exception/errinfo_file_open_mode.hpp>
+#include <boost/predef/os.h>
+
+#if BOOST_OS_UNIX || BOOST_OS_MACOS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+#include "error.h"
+#include "ext/scope_guard.h"
+
+namespace scram {
+
+void MappedFile::Release::operator()(const char* data) const noexcept {
+#if BOOST_OS_UNIX || BOOST_OS_MACOS
+  if (mapped) {
+    ::munmap(const_cast<char*>(data), size);
+    return;
+  }
+#endif
+  delete[] data;
+}
+
+MappedFile::MappedFile(const std::string& path) {
+  try {
+#if BOOST_OS_UNIX || BOOST_OS_MACOS
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      SCRAM_THROW(IOError("Cannot open the file."))
+          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("r");
+    }
+    SCOPE_EXIT([fd] { ::close(fd); });
+    struct stat status {};
+    if (::fstat(fd, &status)) {
+      SCRAM_THROW(IOError("Cannot stat the file."))
+          << boost::errinfo_errno(errno);
+    }
+    std::size_t size = status.st_size;
+    if (!size)
+      return;  // Empty files cannot be mapped.
+    void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      SCRAM_THROW(IOError("Cannot map the file into memory."))
+          << boost::errinfo_errno(errno);
+    }
+    data_ = std::unique_ptr<const char, Release>(static_cast<const char*>(data),
+                                                 Release{size, true});
+#else
+    std::ifstream stream(path, std::ios::binary | std::ios::ate);
+    if (!stream) {
+      SCRAM_THROW(IOError("Cannot open the file."))
+          << boost::errinfo_file_open_mode("r");
+    }
+    std::size_t size = stream.tellg();
+    if (!size)
+      return;
+    char* data = new char[size];
+    data_ = std::unique_ptr<const char, Release>(data, Release{size, false});
+    if (!stream.seekg(0).read(data, size))
+      SCRAM_THROW(IOError("Cannot read the file."));
+#endif
+  } catch (IOError& err) {
+    err << boost::errinfo_file_name(path);
+    throw;
+  }
+}
+
+}  // namespace scram
@@ -0,0 +1,61 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Read-only memory mapping of whole files.
+
+#pragma once
+
+#include <cstddef>
+
+#include <memory>
+#include <string>
+
+namespace scram {
+
+/// Read-only view of the whole file contents.
+///
+/// The file is memory-mapped where the platform supports it;
+/// otherwise, the contents are read into a buffer.
+class MappedFile {
+ public:
+  /// @param[in] path  The path to the file.
+  ///
+  /// @throws IOError  The file is not accessible.
+  explicit MappedFile(const std::string& path);
+
+  /// @returns The beginning of the file contents.
+  const char* data() const { return data_ ? data_.get() : ""; }
+
+  /// @returns The size of the file in bytes.
+  std::size_t size() const { return data_.get_deleter().size; }
+
+ private:
+  /// Releases the file contents either mapped or read into memory.
+  struct Release {
+    /// @param[in] data  The beginning of the file contents.
+    void operator()(const char* data) const noexcept;
+
+    std::size_t size;  ///< The size of the contents.
+    bool mapped;  ///< The contents are memory-mapped rather than read.
+  };
+
+  /// The contents or nullptr for empty files.
+  std::unique_ptr<const char, Release> data_{nullptr, Release{0, false}};
+};
+
+}  // namespace scram
@@ -28,6 +28,7 @@
 #include "mocus.h"
 
 #include "logger.h"
+#include "progress.h"
 
 namespace scram::core {
 
@@ -36,7 +37,7 @@ Mocus::Mocus(const Pdag* graph, const Settings& settings)
   assert(!graph->complement() && "Complements must be propagated.");
 }
 
-void Mocus::Analyze(const Pdag*) noexcept {
+void Mocus::Analyze(const Pdag*) {
   if (graph_->IsTrivial()) {
     LOG(DEBUG2) << "The PDAG is trivial!";
     zbdd_ = std::make_unique<Zbdd>(graph_, kSettings_);
@@ -50,9 +51,10 @@ void Mocus::Analyze(const Pdag*) noexcept {
 }
 
 std::unique_ptr<zbdd::CutSetContainer>
-Mocus::AnalyzeModule(const Gate& gate, const Settings& settings) noexcept {
+Mocus::AnalyzeModule(const Gate& gate, const Settings& settings) {
   assert(gate.module() && "Expected only module gates.");
   CLOCK(gen_time);
+  TRACE("Cut set generation from module");
   LOG(DEBUG3) << "Finding cut sets from module: G" << gate.index();
   LOG(DEBUG4) << "Limit on product order: " << settings.limit_order();
   std::unordered_map<int, const Gate*> gates;
@@ -67,6 +69,7 @@ Mocus::AnalyzeModule(const Gate& gate, const Settings& settings) noexcept {
       kSettings_, gate.index(), kMaxVariableIndex);
   container->Merge(container->ConvertGate(gate));
   while (int next_gate_index = container->GetNextGate()) {
+    CheckCancellation(settings.progress());
     LOG(DEBUG5) << "Expanding gate G" << next_gate_index;
     const Gate* next_gate = gates.find(next_gate_index)->second;
     add_gates(next_gate->args<Gate>());
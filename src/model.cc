@@ -26,24 +26,25 @@
 
 namespace scram::mef {
 
-Model::Model(std::string name)
-    : Element(name.empty() ? kDefaultName : std::move(name)),
+Model::Model(std::string_view name)
+    : Element(name.empty() ? kDefaultName : name),
       mission_time_(std::make_unique<MissionTime>()) {}
 
 void Model::CheckDuplicateEvent(const Event& event) {
-  const std::string& id = event.id();
+  Symbol id = event.id_symbol();
   if (gates().count(id) || basic_events().count(id) || house_events().count(id))
     SCRAM_THROW(DuplicateElementError())
-        << errinfo_element(id, "event")
+        << errinfo_element(event.id(), "event")
         << errinfo_container(Element::name(), kTypeString);
 }
 
 Formula::ArgEvent Model::GetEvent(std::string_view id) {
-  if (auto it = ext::find(table<BasicEvent>(), id))
+  Symbol key(id);
+  if (auto it = ext::find(table<BasicEvent>(), key))
     return &*it;
-  if (auto it = ext::find(table<Gate>(), id))
+  if (auto it = ext::find(table<Gate>(), key))
     return &*it;
-  if (auto it = ext::find(table<HouseEvent>(), id))
+  if (auto it = ext::find(table<HouseEvent>(), key))
     return &*it;
   SCRAM_THROW(UndefinedElement())
       << errinfo_element(std::string(id), "event")
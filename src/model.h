@@ -62,7 +62,7 @@ class Model
   /// @param[in] name  The optional name for the model.
   ///
   /// @throws ValidityError  The name is malformed.
-  explicit Model(std::string name = "");
+  explicit Model(std::string_view name = "");
 
   /// @returns true if the model name has not been set.
   bool HasDefaultName() const { return Element::name() == kDefaultName; }
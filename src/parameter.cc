@@ -20,10 +20,20 @@
 
 #include "parameter.h"
 
+#include <cassert>
+
 #include "error.h"
 
 namespace scram::mef {
 
+namespace {
+
+/// The mission time with the override in the current thread.
+thread_local const MissionTime* t_local_owner = nullptr;
+thread_local double t_local_time = 0;  ///< The override value.
+
+}  // namespace
+
 MissionTime::MissionTime(double time, Units unit) : unit_(unit) { value(time); }
 
 void MissionTime::value(double time) {
@@ -32,6 +42,22 @@ void MissionTime::value(double time) {
   value_ = time;
 }
 
+std::optional<double> MissionTime::local_value() const noexcept {
+  if (t_local_owner == this)
+    return t_local_time;
+  return {};
+}
+
+void MissionTime::local_value(std::optional<double> time) noexcept {
+  assert((!time || *time >= 0) && "Mission time cannot be negative.");
+  t_local_owner = time ? this : nullptr;
+  t_local_time = time.value_or(0);
+}
+
+double MissionTime::value() noexcept {
+  return t_local_owner == this ? t_local_time : value_;
+}
+
 void Parameter::expression(Expression* expression) {
   if (expression_)
     SCRAM_THROW(LogicError("Parameter expression is already set."));
@@ -22,6 +22,8 @@
 
 #include <cstdint>
 
+#include <optional>
+
 #include "element.h"
 #include "expression.h"
 
@@ -67,12 +69,23 @@ class MissionTime : public Expression {
   /// @throws LogicError  The time value is negative.
   void value(double time);
 
-  double value() noexcept override { return value_; }
-  Interval interval() noexcept override { return Interval::closed(0, value_); }
+  /// @returns The mission time override in the calling thread if any.
+  std::optional<double> local_value() const noexcept;
+
+  /// Overrides the mission time value in the calling thread only,
+  /// so that concurrent analyses can sweep the mission time independently.
+  ///
+  /// @param[in] time  The non-negative time in hours
+  ///                  or nullopt to fall back to the shared value.
+  void local_value(std::optional<double> time) noexcept;
+
+  double value() noexcept override;
+  Interval interval() noexcept override { return Interval::closed(0, value()); }
   bool IsDeviate() noexcept override { return false; }
+  bool IsConstant() noexcept override { return false; }
 
  private:
-  double DoSample() noexcept override { return value_; }
+  double DoSample() noexcept override { return value(); }
 
   Units unit_;  ///< Units of this parameter.
   double value_;  ///< The universal value to represent int, bool, double.
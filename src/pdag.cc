@@ -36,6 +36,7 @@
 #include "ext/algorithm.h"
 #include "logger.h"
 #include "model.h"
+#include "resources.h"
 #include "substitution.h"
 
 namespace scram::core {
@@ -52,9 +53,11 @@ Node::Node(Pdag* graph) noexcept
       opti_value_(0),
       pos_count_(0),
       neg_count_(0),
-      graph_(*graph) {}
+      graph_(*graph) {
+  ResourceMeter::Acquire(Resource::kPdagNode, sizeof(Node));
+}
 
-Node::~Node() = default;
+Node::~Node() { ResourceMeter::Release(Resource::kPdagNode); }
 
 Gate::Gate(Connective type, Pdag* graph) noexcept
     : Node(graph),
@@ -66,7 +69,9 @@ Gate::Gate(Connective type, Pdag* graph) noexcept
       descendant_(0),
       ancestor_(0),
       min_time_(0),
-      max_time_(0) {}
+      max_time_(0) {
+  ResourceMeter::Allocate(sizeof(Gate) - sizeof(Node));
+}
 
 void Gate::type(Connective type) {  // Don't use in Gate constructor!
   /// @todo Find the inefficient resets.
@@ -454,7 +459,8 @@ Pdag::Pdag() noexcept
       register_null_gates_(true),
       constant_(new Constant(this)) {}
 
-Pdag::Pdag(const mef::Gate& root, bool ccf, const mef::Model* model) noexcept
+Pdag::Pdag(const mef::Gate& root, bool ccf, const mef::Model* model,
+           bool symbolic) noexcept
     : Pdag() {
   TIMER(DEBUG2, "PDAG Construction");
   ProcessedNodes nodes;
@@ -463,6 +469,12 @@ Pdag::Pdag(const mef::Gate& root, bool ccf, const mef::Model* model) noexcept
     for (const mef::Substitution& substitution : model->substitutions())
       GatherVariables(substitution, ccf, &nodes);
   }
+  if (symbolic) {  // The house event variables follow the basic events.
+    for (const mef::HouseEvent* house_event : house_events_)
+      nodes.house_events[house_event] = std::make_shared<Variable>(this);
+  } else {
+    house_events_.clear();
+  }
 
   root_ = ConstructGate(root.formula(), ccf, &nodes);
 
@@ -483,6 +495,62 @@ Pdag::Pdag(const mef::Gate& root, bool ccf, const mef::Model* model) noexcept
   }
 }
 
+std::unique_ptr<Pdag> Pdag::Specialize() const noexcept {
+  TIMER(DEBUG2, "PDAG Specialization");
+  auto graph = std::make_unique<Pdag>();
+  std::vector<VariablePtr> variables;
+  for (const mef::BasicEvent* basic_event : basic_events_) {
+    graph->basic_events_.push_back(basic_event);
+    variables.push_back(std::make_shared<Variable>(graph.get()));
+  }
+  for (const Substitution& substitution : substitutions_)
+    graph->substitutions_.push_back(substitution);
+
+  std::vector<GatePtr> gates(node_index_ + 1);  // Clones by original indices.
+  auto specialize = [&graph, &variables, &gates, this](
+                        auto& self, const Gate& gate) -> GatePtr {
+    GatePtr& clone = gates[gate.index()];
+    if (clone)
+      return clone;
+    clone = std::make_shared<Gate>(gate.type(), graph.get());
+    clone->min_number(gate.min_number());
+    clone->coherent(gate.coherent());
+    if (gate.module())
+      clone->module(true);
+    if (gate.constant()) {
+      clone->AddArg(graph->constant_, *gate.args().begin() < 0);
+      return clone;
+    }
+    if (gate.type() == kNull)
+      graph->null_gates_.push_back(clone);
+
+    for (const auto& arg : gate.args<Gate>())
+      clone->AddArg(self(self, arg.second), arg.first < 0);
+
+    for (const auto& arg : gate.args<Variable>()) {
+      int index = arg.second.index() - kVariableStartIndex;
+      if (index < variables.size()) {
+        clone->AddArg(variables[index], arg.first < 0);
+        continue;
+      }
+      const mef::HouseEvent& house_event =
+          *house_events_[index - variables.size()];
+      auto null_gate = std::make_shared<Gate>(kNull, graph.get());
+      null_gate->AddArg(graph->constant_,
+                        (arg.first < 0) ^ !house_event.state());
+      clone->AddArg(null_gate);
+      graph->null_gates_.push_back(null_gate);
+    }
+    return clone;
+  };
+
+  graph->root_ = specialize(specialize, *root_);
+  graph->complement_ = complement_;
+  graph->coherent_ = coherent_;
+  graph->normal_ = normal_;
+  return graph;
+}
+
 void Pdag::Print() {
   Clear<kVisit>();
   std::cerr << "\n" << this << std::endl;
@@ -512,7 +580,10 @@ void Pdag::GatherVariables(const mef::Formula& formula, bool ccf,
         graph->GatherVariables(mef_gate->formula(), ccf, nodes);
       }
     }
-    void operator()(const mef::HouseEvent*) {}
+    void operator()(const mef::HouseEvent* arg) {
+      if (nodes->house_events.emplace(arg, nullptr).second)
+        graph->house_events_.push_back(arg);
+    }
 
     Pdag* graph;
     bool ccf;
@@ -556,7 +627,12 @@ void Pdag::AddArg(const GatePtr& parent, const T& event, bool complement,
                   bool ccf, ProcessedNodes* nodes) noexcept {
   if constexpr (std::is_same_v<T, mef::HouseEvent>) {
     (void)ccf;
-    (void)nodes;
+    auto it = nodes->house_events.find(&event);
+    assert(it != nodes->house_events.end() && "Ungathered house event.");
+    if (it->second) {  // Symbolic house event.
+      parent->AddArg(it->second, complement);
+      return;
+    }
     // Create unique pass-through gates to hold the construction invariant.
     auto null_gate = std::make_shared<Gate>(kNull, this);
     null_gate->AddArg(constant_, complement ^ !event.state());
@@ -840,6 +840,10 @@ class Pdag : private boost::noncopyable {
   /// @param[in] root  The top gate of the fault tree.
   /// @param[in] ccf  Incorporation of CCF gates and events for CCF groups.
   /// @param[in] model  The Model containing substitutions if any.
+  /// @param[in] symbolic  Keep house events as Variables
+  ///                      instead of constants of their current states.
+  ///                      The house event Variables follow the basic events,
+  ///                      and the graph is only a template for Specialize.
   ///
   /// @pre No new Variable nodes are introduced after the construction.
   ///
@@ -859,7 +863,22 @@ class Pdag : private boost::noncopyable {
   ///
   /// @post All Gate indices >= (num of vars + kVariableStartIndex).
   explicit Pdag(const mef::Gate& root, bool ccf = false,
-                const mef::Model* model = nullptr) noexcept;
+                const mef::Model* model = nullptr,
+                bool symbolic = false) noexcept;
+
+  /// Creates a graph with the current states of the house events
+  /// from this graph with symbolic house events.
+  /// The structure of this graph is copied as is,
+  /// so the preprocessing of this graph is shared by its specializations.
+  ///
+  /// @returns The specialized graph with pass-through constant gates
+  ///          in place of the house event Variables.
+  ///
+  /// @pre The graph is constructed with symbolic house events.
+  ///
+  /// @post The specialized graph is valid for analysis
+  ///       with the same basic events as the non-symbolic construction.
+  std::unique_ptr<Pdag> Specialize() const noexcept;
 
   /// @returns Non-declarative substitutions to be applied by analysis.
   const std::vector<Substitution>& substitutions() const {
@@ -1012,9 +1031,11 @@ class Pdag : private boost::noncopyable {
   struct ProcessedNodes {  /// @{
     std::unordered_map<const mef::Gate*, GatePtr> gates;
     std::unordered_map<const mef::BasicEvent*, VariablePtr> variables;
+    std::unordered_map<const mef::HouseEvent*, VariablePtr> house_events;
   };  /// @}
 
   /// Gathers and initializes Variables from Basic Events.
+  /// House events are gathered for symbolic Variables.
   /// The gates are gathered but not initialized
   /// to give the sequential indices for the Variables
   /// for establishing the construction invariant.
@@ -1133,6 +1154,8 @@ class Pdag : private boost::noncopyable {
   ConstantPtr constant_;  ///< The single constant TRUE for the whole graph.
   /// Mapping for basic events and their Variable indices.
   IndexMap<const mef::BasicEvent*> basic_events_;
+  /// The symbolic house events with Variable indices after the basic events.
+  std::vector<const mef::HouseEvent*> house_events_;
   /// Container for NULL type gates to be tracked and cleaned by algorithms.
   /// NULL type gates are created by gates with only one argument.
   std::vector<GateWeakPtr> null_gates_;
@@ -2366,6 +2366,8 @@ void Preprocessor::GatherNodes(const GatePtr& gate, std::vector<GatePtr>* gates,
   }
 }
 
+void CustomPreprocessor<Pdag>::Run() noexcept { Preprocessor::Run(); }
+
 void CustomPreprocessor<Bdd>::Run() noexcept {
   Preprocessor::Run();
   pdag::Transform(graph_, &pdag::MarkCoherence, &pdag::TopologicalOrder);
@@ -1002,6 +1002,21 @@ class Preprocessor : private boost::noncopyable {
 template <class Algorithm>
 class CustomPreprocessor;
 
+/// Specialization of preprocessing for graphs with symbolic house events.
+/// The preprocessing is independent of analysis algorithms
+/// and is shared by the specializations of the graph
+/// with the house event states of different contexts.
+template <>
+class CustomPreprocessor<Pdag> : public Preprocessor {
+ public:
+  using Preprocessor::Preprocessor;
+
+ private:
+  /// Performs only the default preprocessing
+  /// since the specialized graphs are preprocessed for analysis separately.
+  void Run() noexcept override;
+};
+
 class Bdd;
 
 /// Specialization of preprocessing for BDD based analyses.
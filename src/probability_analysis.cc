@@ -24,8 +24,10 @@
 #include <boost/range/algorithm/find_if.hpp>
 
 #include "event.h"
+#include "expression/tape.h"
 #include "logger.h"
 #include "parameter.h"
+#include "resources.h"
 #include "settings.h"
 #include "zbdd.h"
 
@@ -33,10 +35,15 @@ namespace scram::core {
 
 ProbabilityAnalysis::ProbabilityAnalysis(const FaultTreeAnalysis* fta,
                                          mef::MissionTime* mission_time)
-    : Analysis(fta->settings()), p_total_(0), mission_time_(mission_time) {}
+    : Analysis(fta->settings()), p_total_(0), mission_time_(mission_time) {
+  // The qualitative analysis may come from a phase with another mission time.
+  Analysis::settings().mission_time(mission_time->value());
+}
 
 void ProbabilityAnalysis::Analyze() noexcept {
   CLOCK(p_time);
+  TRACE("Probability analysis");
+  ResourceMeter meter(&Analysis::resources());
   LOG(DEBUG3) << "Calculating probabilities...";
   // Get the total probability.
   p_total_ = this->CalculateTotalProbability();
@@ -186,9 +193,19 @@ double McubCalculator::Calculate(
 }
 
 void ProbabilityAnalyzerBase::ExtractVariableProbabilities() {
-  p_vars_.reserve(graph_->basic_events().size());
+  std::vector<mef::Expression*> expressions;
+  expressions.reserve(graph_->basic_events().size());
   for (const mef::BasicEvent* event : graph_->basic_events())
-    p_vars_.push_back(event->p());
+    expressions.push_back(&event->expression());
+  tape_ = std::make_unique<mef::ExpressionTape>(expressions);
+  tape_->Evaluate();
+  p_vars_.resize(expressions.size());
+  LoadVariableProbabilities();
+}
+
+void ProbabilityAnalyzerBase::LoadVariableProbabilities(int lane) noexcept {
+  for (int i = 0; i < static_cast<int>(p_vars_.size()); ++i)
+    p_vars_[Pdag::kVariableStartIndex + i] = tape_->value(i, lane);
 }
 
 std::vector<std::pair<double, double>>
@@ -202,20 +219,79 @@ ProbabilityAnalyzerBase::CalculateProbabilityOverTime() noexcept {
          ProbabilityAnalysis::mission_time().value());
   double total_time = ProbabilityAnalysis::mission_time().value();
 
-  auto update = [this, &p_time](double time) {
-    mission_time().value(time);
-    auto it_p = p_vars_.begin();
-    for (const mef::BasicEvent* event : graph_->basic_events())
-      *it_p++ = event->p();
-    p_time.emplace_back(this->CalculateTotalProbability(p_vars_), time);
-  };
-
+  std::vector<double> time_points;
   for (double time = 0; time < total_time; time += time_step)
-    update(time);
-  update(total_time);  // Handle cases when total_time is not divisible by step.
+    time_points.push_back(time);
+  // Handle cases when total_time is not divisible by step.
+  time_points.push_back(total_time);
+
+  // All the variable probabilities are evaluated up front in a batch.
+  tape_->Evaluate(time_points);
+  p_time.reserve(time_points.size());
+  for (int i = 0; i < tape_->num_lanes(); ++i) {
+    LoadVariableProbabilities(i);
+    p_time.emplace_back(this->CalculateTotalProbability(p_vars_),
+                        time_points[i]);
+  }
   return p_time;
 }
 
+namespace {
+
+/// Calculates exact probability
+/// of a function graph represented by its root BDD vertex.
+///
+/// @param[in] bdd  The host BDD with modules.
+/// @param[in] vertex  The root vertex of a function graph.
+/// @param[in] mark  A flag to mark traversed vertices.
+/// @param[in] p_vars  The probabilities of the variables
+///                    mapped by their indices.
+///
+/// @returns Probability value.
+///
+/// @warning If a vertex is already marked with the input mark,
+///          it will not be traversed and updated with a probability value.
+double CalculateProbability(const Bdd& bdd, const Bdd::VertexPtr& vertex,
+                            bool mark,
+                            const Pdag::IndexMap<double>& p_vars) noexcept {
+  if (vertex->terminal())
+    return 1;
+  Ite& ite = Ite::Ref(vertex);
+  if (ite.mark() == mark)
+    return ite.p();
+  ite.mark(mark);
+  double p_var = 0;
+  if (ite.module()) {
+    const Bdd::Function& res = bdd.modules().find(ite.index())->second;
+    p_var = CalculateProbability(bdd, res.vertex, mark, p_vars);
+    if (res.complement)
+      p_var = 1 - p_var;
+  } else {
+    p_var = p_vars[ite.index()];
+  }
+  double high = CalculateProbability(bdd, ite.high(), mark, p_vars);
+  double low = CalculateProbability(bdd, ite.low(), mark, p_vars);
+  if (ite.complement_edge())
+    low = 1 - low;
+  ite.p(p_var * high + (1 - p_var) * low);
+  return ite.p();
+}
+
+}  // namespace
+
+std::vector<double> CalculateProbabilities(
+    Bdd* bdd, const Pdag::IndexMap<double>& p_vars) noexcept {
+  std::vector<double> probabilities;
+  probabilities.reserve(bdd->roots().size());
+  // The vertices shared by the roots are calculated only once.
+  for (const Bdd::Function& root : bdd->roots()) {
+    double prob = CalculateProbability(*bdd, root.vertex, true, p_vars);
+    probabilities.push_back(root.complement ? 1 - prob : prob);
+  }
+  bdd->ClearMarks(false);
+  return probabilities;
+}
+
 ProbabilityAnalyzer<Bdd>::ProbabilityAnalyzer(FaultTreeAnalyzer<Bdd>* fta,
                                               mef::MissionTime* mission_time)
     : ProbabilityAnalyzerBase(fta, mission_time), owner_(false) {
@@ -235,8 +311,8 @@ double ProbabilityAnalyzer<Bdd>::CalculateTotalProbability(
   CLOCK(calc_time);  // BDD based calculation time.
   LOG(DEBUG4) << "Calculating probability with BDD...";
   current_mark_ = !current_mark_;
-  double prob =
-      CalculateProbability(bdd_graph_->root().vertex, current_mark_, p_vars);
+  double prob = CalculateProbability(*bdd_graph_, bdd_graph_->root().vertex,
+                                     current_mark_, p_vars);
   if (bdd_graph_->root().complement)
     prob = 1 - prob;
   LOG(DEBUG4) << "Calculated probability " << prob << " in " << DUR(calc_time);
@@ -244,8 +320,10 @@ double ProbabilityAnalyzer<Bdd>::CalculateTotalProbability(
 }
 
 void ProbabilityAnalyzer<Bdd>::CreateBdd(
-    const FaultTreeAnalysis& fta) noexcept {
+    const FaultTreeAnalysis& fta) {
   CLOCK(total_time);
+  TRACE("BDD for probability analysis");
+  ResourceMeter meter(&Analysis::resources());
 
   CLOCK(ft_creation);
   Pdag graph(fta.top_event(), Analysis::settings().ccf_analysis());
@@ -264,30 +342,4 @@ void ProbabilityAnalyzer<Bdd>::CreateBdd(
   Analysis::AddAnalysisTime(DUR(total_time));
 }
 
-double ProbabilityAnalyzer<Bdd>::CalculateProbability(
-    const Bdd::VertexPtr& vertex, bool mark,
-    const Pdag::IndexMap<double>& p_vars) noexcept {
-  if (vertex->terminal())
-    return 1;
-  Ite& ite = Ite::Ref(vertex);
-  if (ite.mark() == mark)
-    return ite.p();
-  ite.mark(mark);
-  double p_var = 0;
-  if (ite.module()) {
-    const Bdd::Function& res = bdd_graph_->modules().find(ite.index())->second;
-    p_var = CalculateProbability(res.vertex, mark, p_vars);
-    if (res.complement)
-      p_var = 1 - p_var;
-  } else {
-    p_var = p_vars[ite.index()];
-  }
-  double high = CalculateProbability(ite.high(), mark, p_vars);
-  double low = CalculateProbability(ite.low(), mark, p_vars);
-  if (ite.complement_edge())
-    low = 1 - low;
-  ite.p(p_var * high + (1 - p_var) * low);
-  return ite.p();
-}
-
 }  // namespace scram::core
@@ -20,11 +20,13 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include "analysis.h"
 #include "bdd.h"
+#include "expression/tape.h"
 #include "fault_tree_analysis.h"
 #include "pdag.h"
 
@@ -229,18 +231,24 @@ class ProbabilityAnalyzerBase : public ProbabilityAnalysis {
   CalculateProbabilityOverTime() noexcept final;
 
   /// Upon construction of the probability analysis,
-  /// stores the variable probabilities in a continuous container
+  /// compiles the probability expressions of the variables into a tape
+  /// and stores the variable probabilities in a continuous container
   /// for retrieval by their indices instead of pointers.
   ///
-  /// @note This function may seem redundant,
-  ///       for it's super-short and simple to do it inline in the constructor.
-  ///       The main benefit of the out-of-line implementation
-  ///       is compile-time decoupling from the input BasicEvent classes.
+  /// @note The out-of-line implementation provides
+  ///       compile-time decoupling from the input BasicEvent classes.
   void ExtractVariableProbabilities();
 
+  /// Loads the variable probabilities from the last tape evaluation.
+  ///
+  /// @param[in] lane  The evaluation lane of the tape.
+  void LoadVariableProbabilities(int lane = 0) noexcept;
+
   const Pdag* graph_;  ///< PDAG from the fault tree analysis.
   const Zbdd& products_;  ///< A collection of products.
   Pdag::IndexMap<double> p_vars_;  ///< Variable probabilities.
+  /// The compiled probability expressions of the variables.
+  std::unique_ptr<mef::ExpressionTape> tape_;
 };
 
 /// Fault-tree-analysis-aware probability analyzer.
@@ -261,6 +269,19 @@ class ProbabilityAnalyzer : public ProbabilityAnalyzerBase {
   Calculator calc_;  ///< Provider of the calculation logic.
 };
 
+/// Calculates exact probabilities of the root functions of a BDD,
+/// e.g., a BDD shared by the sequences of an event tree.
+///
+/// @param[in,out] bdd  The BDD with clear vertex marks.
+/// @param[in] p_vars  The probabilities of the BDD variables
+///                    mapped by their indices.
+///
+/// @returns The probabilities of the roots in the order of the roots.
+///
+/// @post The vertex marks are clear.
+std::vector<double> CalculateProbabilities(
+    Bdd* bdd, const Pdag::IndexMap<double>& p_vars) noexcept;
+
 /// Specialization of probability analyzer with Binary Decision Diagrams.
 /// The quantitative analysis is done with BDD.
 template <>
@@ -308,22 +329,7 @@ class ProbabilityAnalyzer<Bdd> : public ProbabilityAnalyzerBase {
   /// @param[in] fta  The fault tree analysis providing the root gate.
   ///
   /// @pre The function is called in the constructor only once.
-  void CreateBdd(const FaultTreeAnalysis& fta) noexcept;
-
-  /// Calculates exact probability
-  /// of a function graph represented by its root BDD vertex.
-  ///
-  /// @param[in] vertex  The root vertex of a function graph.
-  /// @param[in] mark  A flag to mark traversed vertices.
-  /// @param[in] p_vars  The probabilities of the variables
-  ///                    mapped by their indices.
-  ///
-  /// @returns Probability value.
-  ///
-  /// @warning If a vertex is already marked with the input mark,
-  ///          it will not be traversed and updated with a probability value.
-  double CalculateProbability(const Bdd::VertexPtr& vertex, bool mark,
-                              const Pdag::IndexMap<double>& p_vars) noexcept;
+  void CreateBdd(const FaultTreeAnalysis& fta);
 
   Bdd* bdd_graph_;  ///< The main BDD graph for analysis.
   bool current_mark_;  ///< To keep track of BDD current mark.
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the progress reporting channel.
+
+#include "progress.h"
+
+namespace scram::core {
+
+void Progress::Report(std::string_view stage, int completed, int total) {
+  Check();
+  if (!observer_)
+    return;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto now = std::chrono::steady_clock::now();
+  if (stage != stage_) {
+    stage_ = stage;
+    start_ = now;
+  }
+  double elapsed = std::chrono::duration<double>(now - start_).count();
+  double remaining = -1;
+  if (total && completed)  // The linear estimate.
+    remaining = elapsed * (total - completed) / completed;
+  observer_({stage, completed, total, elapsed, remaining});
+}
+
+}  // namespace scram::core
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Cooperative cancellation and progress reporting of analyses.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string_view>
+
+#include <boost/noncopyable.hpp>
+
+#include "error.h"
+
+namespace scram::core {
+
+/// The communication channel between long running analyses
+/// and their controller (GUI, job scheduler, signal handlers, etc.).
+///
+/// The analyses report their progress in stages of countable work units
+/// and poll the cancellation request at the unit boundaries.
+/// The cancellation is honored by throwing CancelError
+/// that unwinds the analyses and restores the model.
+///
+/// @note All the member functions are safe to call concurrently.
+class Progress : private boost::noncopyable {
+ public:
+  /// The snapshot of the analysis progress.
+  struct Status {
+    std::string_view stage;  ///< The current stage of the analysis.
+    int completed;  ///< The number of completed work units in the stage.
+    int total;  ///< The total number of work units; 0 if unknown.
+    double elapsed;  ///< The time in seconds since the start of the stage.
+    /// The estimated time in seconds to finish the stage;
+    /// negative if unknown.
+    double remaining;
+  };
+
+  /// The observer of the progress reports.
+  /// The observer is called serially from the analysis threads,
+  /// so it must be quick and must not call back into the analyses.
+  using Observer = std::function<void(const Status&)>;
+
+  /// @param[in] observer  The optional observer of the progress reports.
+  explicit Progress(Observer observer = {}) : observer_(std::move(observer)) {}
+
+  /// Requests the cancellation of the analysis.
+  ///
+  /// @note This function is async-signal-safe.
+  void Cancel() noexcept { cancelled_.store(true, std::memory_order_relaxed); }
+
+  /// @returns true if the cancellation has been requested.
+  bool cancelled() const noexcept {
+    return cancelled_.load(std::memory_order_relaxed);
+  }
+
+  /// Polls the cancellation request.
+  ///
+  /// @throws CancelError  The cancellation has been requested.
+  void Check() const {
+    if (cancelled())
+      SCRAM_THROW(CancelError("The analysis is cancelled."));
+  }
+
+  /// Reports the progress of the current stage to the observer
+  /// and polls the cancellation request.
+  ///
+  /// @param[in] stage  The name of the stage with static storage duration.
+  /// @param[in] completed  The number of completed units.
+  /// @param[in] total  The total number of units, 0 if unknown.
+  ///
+  /// @throws CancelError  The cancellation has been requested.
+  void Report(std::string_view stage, int completed, int total = 0);
+
+ private:
+  std::atomic<bool> cancelled_ = false;  ///< The cancellation request.
+  Observer observer_;  ///< The optional observer of progress reports.
+  std::mutex mutex_;  ///< Serializes the observer calls.
+  std::string_view stage_;  ///< The last reported stage.
+  /// The start time of the last reported stage.
+  std::chrono::steady_clock::time_point start_;
+};
+
+/// Polls the cancellation request of an optional progress channel.
+///
+/// @param[in] progress  The progress channel from the analysis settings.
+///
+/// @throws CancelError  The cancellation has been requested.
+inline void CheckCancellation(const Progress* progress) {
+  if (progress)
+    progress->Check();
+}
+
+/// Reports progress through an optional progress channel.
+///
+/// @copydetails Progress::Report
+/// @param[in] progress  The progress channel from the analysis settings.
+inline void ReportProgress(Progress* progress, std::string_view stage,
+                           int completed, int total = 0) {
+  if (progress)
+    progress->Report(stage, completed, total);
+}
+
+}  // namespace scram::core
@@ -192,6 +192,9 @@ void Project::SetLimits(const xml::Element& limits) {
 
     } else if (name == "seed") {
       settings_.seed(limit.text<int>());
+
+    } else if (name == "rng-engine") {
+      settings_.rng_engine(limit.text());
     }
   }
 }
@@ -27,9 +27,7 @@
 #include <vector>
 
 #include <boost/algorithm/string/join.hpp>
-#include <boost/exception/errinfo_errno.hpp>
 #include <boost/exception/errinfo_file_name.hpp>
-#include <boost/exception/errinfo_file_open_mode.hpp>
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 
@@ -56,6 +54,13 @@ void PutId(const core::RiskAnalysis::Result::Id& id,
       report_->SetAttribute("initiating-event", sequence.first.name());
       report_->SetAttribute("name", sequence.second.name());
     }
+    void operator()(
+        const std::pair<const mef::InitiatingEvent&,
+                        const core::EventTreeAnalysis::EndState&>& end_state) {
+      report_->SetAttribute("initiating-event", end_state.first.name());
+      report_->SetAttribute("name", end_state.second.name);
+      report_->SetAttribute("type", "end-state");
+    }
     xml::StreamElement* report_;
   } extractor{report};
   std::visit(extractor, id.target);
@@ -71,7 +76,24 @@ void PutId(const core::RiskAnalysis::Result::Id& id,
 void Reporter::Report(const core::RiskAnalysis& risk_an, std::FILE* out,
                       bool indent) {
   xml::Stream xml_stream(out, indent);
-  xml::StreamElement report = xml_stream.root("report");
+  Report(risk_an, &xml_stream);
+}
+
+void Reporter::Report(const core::RiskAnalysis& risk_an,
+                      const std::string& file, bool indent) {
+  try {
+    xml::Stream xml_stream(xml::Output::Open(file, /*background=*/true),
+                           indent);
+    Report(risk_an, &xml_stream);
+  } catch (IOError& err) {
+    err << boost::errinfo_file_name(file);
+    throw;
+  }
+}
+
+void Reporter::Report(const core::RiskAnalysis& risk_an,
+                      xml::Stream* xml_stream) {
+  xml::StreamElement report = xml_stream->root("report");
   ReportInformation(risk_an, &report);
 
   if (risk_an.results().empty() && risk_an.event_tree_results().empty())
@@ -85,38 +107,70 @@ void Reporter::Report(const core::RiskAnalysis& risk_an, std::FILE* out,
     }
   }
 
-  for (const core::RiskAnalysis::Result& result : risk_an.results()) {
-    if (result.fault_tree_analysis)
-      ReportResults(result.id, *result.fault_tree_analysis,
-                    result.probability_analysis.get(), &results);
+  for (const core::RiskAnalysis::Result& result : risk_an.results())
+    ReportTarget(result, &results);
+}
 
-    if (result.probability_analysis)
-      ReportResults(result.id, *result.probability_analysis, &results);
+/// The results element is started upon the first reported result
+/// because the report cannot have empty results.
+class Reporter::ResultStream : public core::RiskAnalysis::Sink {
+ public:
+  /// @param[in,out] reporter  The reporter of the results.
+  /// @param[in] settings  The analysis settings.
+  /// @param[in,out] report  The root element of the document.
+  ResultStream(Reporter* reporter, const core::Settings& settings,
+               xml::StreamElement* report)
+      : reporter_(*reporter), settings_(settings), report_(*report) {}
+
+  void Consume(const core::RiskAnalysis::EtaResult& result) override {
+    if (settings_.probability_analysis())
+      reporter_.ReportResults(result, results());
+  }
 
-    if (result.importance_analysis)
-      ReportResults(result.id, *result.importance_analysis, &results);
+  void Consume(const core::RiskAnalysis::Result& result) override {
+    reporter_.ReportTarget(result, results());
+  }
 
-    if (result.uncertainty_analysis)
-      ReportResults(result.id, *result.uncertainty_analysis, &results);
+ private:
+  /// @returns The results element of the report.
+  xml::StreamElement* results() {
+    if (!results_)
+      results_.reset(new xml::StreamElement(report_.AddChild("results")));
+    return results_.get();
   }
+
+  Reporter& reporter_;  ///< The reporter of the results.
+  const core::Settings& settings_;  ///< The analysis settings.
+  xml::StreamElement& report_;  ///< The root element of the document.
+  std::unique_ptr<xml::StreamElement> results_;  ///< The lazy results element.
+};
+
+void Reporter::Stream(core::RiskAnalysis* risk_an, std::FILE* out,
+                      bool indent) {
+  xml::Stream xml_stream(out, indent);
+  Stream(risk_an, &xml_stream);
 }
 
-void Reporter::Report(const core::RiskAnalysis& risk_an,
-                      const std::string& file, bool indent) {
-  std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
-      std::fopen(file.c_str(), "w"), &std::fclose);
+void Reporter::Stream(core::RiskAnalysis* risk_an, const std::string& file,
+                      bool indent) {
   try {
-    if (!fp) {
-      SCRAM_THROW(IOError("Cannot open the output file for report."))
-          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("w");
-    }
-    Report(risk_an, fp.get(), indent);
+    xml::Stream xml_stream(xml::Output::Open(file, /*background=*/true),
+                           indent);
+    Stream(risk_an, &xml_stream);
   } catch (IOError& err) {
     err << boost::errinfo_file_name(file);
     throw;
   }
 }
 
+void Reporter::Stream(core::RiskAnalysis* risk_an, xml::Stream* xml_stream) {
+  xml::StreamElement report = xml_stream->root("report");
+  ReportInformation(*risk_an, &report);
+  const core::Settings& settings = std::as_const(*risk_an).settings();
+  ResultStream result_stream(this, settings, &report);
+  risk_an->Analyze(&result_stream);
+}
+
 /// Describes the fault tree analysis and techniques.
 template <>
 void Reporter::ReportCalculatedQuantity<core::FaultTreeAnalysis>(
@@ -208,6 +262,8 @@ void Reporter::ReportCalculatedQuantity<core::UncertaintyAnalysis>(
   if (settings.seed() >= 0) {
     limits.AddChild("seed").AddText(settings.seed());
   }
+  limits.AddChild("rng-engine")
+      .AddText(core::kRngEngineToString[static_cast<int>(settings.rng_engine())]);
 }
 
 /// Describes all performed analyses deduced from settings.
@@ -315,24 +371,37 @@ void Reporter::ReportPerformance(const core::RiskAnalysis& risk_an,
     return;
   // Setup for performance information.
   xml::StreamElement performance = information->AddChild("performance");
+  // The analysis time with the non-zero resource measurements.
+  auto report = [](const char* name, const core::Analysis& analysis,
+                   xml::StreamElement* calc_time) {
+    xml::StreamElement element = calc_time->AddChild(name);
+    const core::Resources& resources = analysis.resources();
+    auto attribute = [&element](const char* key, auto value) {
+      if (value > 0)
+        element.SetAttribute(key, value);
+    };
+    attribute("peak-rss", resources.peak_rss);
+    attribute("allocated", resources.allocated);
+    attribute("pdag-nodes", resources.pdag_nodes);
+    attribute("bdd-vertices", resources.bdd_vertices);
+    attribute("zbdd-vertices", resources.zbdd_vertices);
+    attribute("products", resources.products);
+    element.AddText(analysis.analysis_time());
+  };
   for (const core::RiskAnalysis::Result& result : risk_an.results()) {
     xml::StreamElement calc_time = performance.AddChild("calculation-time");
     scram::PutId(result.id, &calc_time);
     if (result.fault_tree_analysis)
-      calc_time.AddChild("products")
-          .AddText(result.fault_tree_analysis->analysis_time());
+      report("products", *result.fault_tree_analysis, &calc_time);
 
     if (result.probability_analysis)
-      calc_time.AddChild("probability")
-          .AddText(result.probability_analysis->analysis_time());
+      report("probability", *result.probability_analysis, &calc_time);
 
     if (result.importance_analysis)
-      calc_time.AddChild("importance")
-          .AddText(result.importance_analysis->analysis_time());
+      report("importance", *result.importance_analysis, &calc_time);
 
     if (result.uncertainty_analysis)
-      calc_time.AddChild("uncertainty")
-          .AddText(result.uncertainty_analysis->analysis_time());
+      report("uncertainty", *result.uncertainty_analysis, &calc_time);
   }
 }
 
@@ -370,15 +439,21 @@ void Reporter::ReportResults(const core::RiskAnalysis::EtaResult& eta_result,
         .SetAttribute("name", result_sequence.sequence.name())
         .SetAttribute("value", result_sequence.p_sequence);
   }
+  for (const core::EventTreeAnalysis::EndState& end_state : eta.end_states()) {
+    initiating_event.AddChild("end-state")
+        .SetAttribute("name", end_state.name)
+        .SetAttribute("value", end_state.p_end_state);
+  }
 }
 
-void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
-                             const core::FaultTreeAnalysis& fta,
-                             const core::ProbabilityAnalysis* prob_analysis,
+void Reporter::ReportResults(const core::RiskAnalysis::Result& result,
                              xml::StreamElement* results) {
   TIMER(DEBUG2, "Reporting products");
+  const core::FaultTreeAnalysis& fta = *result.fault_tree_analysis;
+  const core::ProbabilityAnalysis* prob_analysis =
+      result.probability_analysis.get();
   xml::StreamElement sum_of_products = results->AddChild("sum-of-products");
-  scram::PutId(id, &sum_of_products);
+  scram::PutId(result.id, &sum_of_products);
 
   std::string warning = fta.warnings();
   if (prob_analysis && prob_analysis->warnings().empty() == false)
@@ -393,6 +468,9 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
   if (prob_analysis)
     sum_of_products.SetAttribute("probability", prob_analysis->p_total());
 
+  if (result.cached)
+    sum_of_products.SetAttribute("cached", true);
+
   if (fta.products().empty() == false) {
     sum_of_products.SetAttribute(
         "distribution",
@@ -422,6 +500,21 @@ void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
   }
 }
 
+void Reporter::ReportTarget(const core::RiskAnalysis::Result& result,
+                            xml::StreamElement* results) {
+  if (result.fault_tree_analysis)
+    ReportResults(result, results);
+
+  if (result.probability_analysis)
+    ReportResults(result.id, *result.probability_analysis, results);
+
+  if (result.importance_analysis)
+    ReportResults(result.id, *result.importance_analysis, results);
+
+  if (result.uncertainty_analysis)
+    ReportResults(result.id, *result.uncertainty_analysis, results);
+}
+
 void Reporter::ReportResults(const core::RiskAnalysis::Result::Id& id,
                              const core::ProbabilityAnalysis& prob_analysis,
                              xml::StreamElement* results) {
@@ -55,6 +55,8 @@ class Reporter {
 
   /// A convenience function to generate the report into a file.
   /// This function overwrites the file.
+  /// The report is compressed on a background thread
+  /// if the file name ends with ".gz" or ".zst".
   ///
   /// @param[in] risk_an  Risk analysis with results.
   /// @param[out] file  The output destination.
@@ -65,7 +67,55 @@ class Reporter {
   void Report(const core::RiskAnalysis& risk_an, const std::string& file,
               bool indent = true);
 
+  /// Runs the risk analysis on a model
+  /// and reports the results of every target as soon as they are ready.
+  /// The analyses of the reported targets are released,
+  /// so the peak memory does not grow with the number of targets.
+  ///
+  /// @param[in,out] risk_an  Risk analysis to be run.
+  /// @param[out] out  The report destination stream.
+  /// @param[in] indent  The flag to indent output for readability.
+  ///
+  /// @pre The risk analysis has not been run.
+  /// @pre The output destination is used only by this reporter.
+  ///
+  /// @post The performance information is not reported
+  ///       because it precedes the results in the report.
+  ///
+  /// @throws IOError  The write operation has failed.
+  /// @throws CancelError  The analysis has been canceled.
+  void Stream(core::RiskAnalysis* risk_an, std::FILE* out, bool indent = true);
+
+  /// A convenience function to stream the report into a file.
+  /// This function overwrites the file,
+  /// compressing it as in the Report function.
+  ///
+  /// @param[in,out] risk_an  Risk analysis to be run.
+  /// @param[out] file  The output destination.
+  /// @param[in] indent  The flag to indent output for readability.
+  ///
+  /// @throws IOError  The output file is not accessible,
+  ///                  or the write operation has failed.
+  /// @throws CancelError  The analysis has been canceled.
+  void Stream(core::RiskAnalysis* risk_an, const std::string& file,
+              bool indent = true);
+
  private:
+  /// The sink of risk analysis results into the report.
+  class ResultStream;
+
+  /// Reports the results of risk analysis into the XML stream.
+  ///
+  /// @param[in] risk_an  Risk analysis with results.
+  /// @param[in,out] xml_stream  The destination document.
+  void Report(const core::RiskAnalysis& risk_an, xml::Stream* xml_stream);
+
+  /// Runs the risk analysis and streams its results.
+  ///
+  /// @param[in,out] risk_an  Risk analysis to be run.
+  /// @param[in,out] xml_stream  The destination document.
+  void Stream(core::RiskAnalysis* risk_an, xml::Stream* xml_stream);
+
   /// This function populates information
   /// about the software, settings, time, methods, model, etc.
   ///
@@ -130,17 +180,21 @@ class Reporter {
 
   /// Reports the results of fault tree analysis
   /// to a specified output destination.
+  /// The products are accompanied with the probability analysis results
+  /// if any.
   ///
-  /// @param[in] id  The analysis id.
-  /// @param[in] fta  Fault Tree Analysis with results.
-  /// @param[in] prob_analysis  Probability Analysis with results.
-  ///                           Null pointer for no probability analysis.
+  /// @param[in] result  The analysis result with Fault Tree Analysis.
   /// @param[in,out] results  XML element to for all results.
-  void ReportResults(const core::RiskAnalysis::Result::Id& id,
-                     const core::FaultTreeAnalysis& fta,
-                     const core::ProbabilityAnalysis* prob_analysis,
+  void ReportResults(const core::RiskAnalysis::Result& result,
                      xml::StreamElement* results);
 
+  /// Reports all the available analysis results of a target.
+  ///
+  /// @param[in] result  The analysis results of the target.
+  /// @param[in,out] results  XML element to for all results.
+  void ReportTarget(const core::RiskAnalysis::Result& result,
+                    xml::StreamElement* results);
+
   /// Reports results of probability analysis.
   ///
   /// @param[in] id  The analysis id.
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the resource accounting.
+
+#include "resources.h"
+
+#include <boost/predef/os.h>
+
+#if BOOST_OS_UNIX || BOOST_OS_MACOS
+#include <sys/resource.h>
+#endif
+
+namespace scram::core {
+
+namespace {
+
+/// @returns The peak resident set size of the process in bytes,
+///          or 0 if the platform doesn't provide it.
+std::size_t PeakRss() noexcept {
+#if BOOST_OS_UNIX || BOOST_OS_MACOS
+  struct rusage usage {};
+  if (getrusage(RUSAGE_SELF, &usage))
+    return 0;
+#if BOOST_OS_MACOS
+  return usage.ru_maxrss;  // In bytes.
+#else
+  return usage.ru_maxrss * std::size_t(1024);  // In kilobytes.
+#endif
+#else
+  return 0;
+#endif
+}
+
+}  // namespace
+
+ResourceMeter::ResourceMeter(Resources* resources) noexcept
+    : resources_(resources), parent_(current_), start_rss_(PeakRss()) {
+  current_ = this;
+}
+
+ResourceMeter::~ResourceMeter() noexcept {
+  current_ = parent_;
+  // The peak RSS is monotonic within the process.
+  resources_->peak_rss =
+      std::max(resources_->peak_rss, PeakRss() - start_rss_);
+  resources_->allocated += allocated_;
+  auto peak = [this](Resource kind) { return peak_[static_cast<int>(kind)]; };
+  resources_->pdag_nodes =
+      std::max(resources_->pdag_nodes, peak(Resource::kPdagNode));
+  resources_->bdd_vertices =
+      std::max(resources_->bdd_vertices, peak(Resource::kBddVertex));
+  resources_->zbdd_vertices =
+      std::max(resources_->zbdd_vertices, peak(Resource::kZbddVertex));
+  if (parent_) {
+    for (int i = 0; i < kNumKinds; ++i) {
+      parent_->peak_[i] = std::max(parent_->peak_[i],
+                                   parent_->live_[i] + peak_[i]);
+      parent_->live_[i] += live_[i];
+    }
+    parent_->allocated_ += allocated_;
+  }
+}
+
+}  // namespace scram::core
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Accounting of the memory and graph resources consumed by analyses.
+
+#pragma once
+
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+
+#include <boost/noncopyable.hpp>
+
+namespace scram::core {
+
+/// The resources consumed by an analysis.
+struct Resources {
+  /// The growth of the peak resident set size of the process in bytes.
+  std::size_t peak_rss = 0;
+  /// The bytes allocated for the PDAG nodes and the decision diagram vertices.
+  std::size_t allocated = 0;
+  int pdag_nodes = 0;  ///< The peak number of live PDAG nodes.
+  int bdd_vertices = 0;  ///< The peak number of live BDD vertices.
+  int zbdd_vertices = 0;  ///< The peak number of live ZBDD vertices.
+  std::size_t products = 0;  ///< The number of generated products.
+};
+
+/// The kinds of the tracked graph elements.
+enum class Resource { kPdagNode = 0, kBddVertex, kZbddVertex };
+
+/// Scoped accounting of the resources consumed on the current thread.
+///
+/// The graph elements report their creation and destruction
+/// to the innermost meter of their thread.
+/// Without any meter, the reports are no-op checks of a thread-local pointer.
+/// Nested meters pass their counts to the enclosing meter upon destruction.
+///
+/// @note The peak RSS is measured for the whole process,
+///       so it includes the memory of concurrent analyses.
+class ResourceMeter : private boost::noncopyable {
+ public:
+  /// Starts the accounting on the current thread.
+  ///
+  /// @param[out] resources  The destination for the measurements
+  ///                        merged upon the meter destruction.
+  explicit ResourceMeter(Resources* resources) noexcept;
+
+  /// Merges the measurements into the destination
+  /// and restores the enclosing meter.
+  ~ResourceMeter() noexcept;
+
+  /// Registers the creation of a graph element.
+  ///
+  /// @param[in] kind  The kind of the element.
+  /// @param[in] bytes  The size of the element.
+  static void Acquire(Resource kind, std::size_t bytes) noexcept {
+    if (ResourceMeter* meter = current_) {
+      int i = static_cast<int>(kind);
+      meter->peak_[i] = std::max(meter->peak_[i], ++meter->live_[i]);
+      meter->allocated_ += bytes;
+    }
+  }
+
+  /// Registers the destruction of a graph element.
+  ///
+  /// @param[in] kind  The kind of the element.
+  ///
+  /// @note The elements may be created outside of the meter.
+  static void Release(Resource kind) noexcept {
+    if (ResourceMeter* meter = current_)
+      --meter->live_[static_cast<int>(kind)];
+  }
+
+  /// Registers additional memory of a graph element.
+  ///
+  /// @param[in] bytes  The size of the extension.
+  static void Allocate(std::size_t bytes) noexcept {
+    if (ResourceMeter* meter = current_)
+      meter->allocated_ += bytes;
+  }
+
+ private:
+  static constexpr int kNumKinds = 3;  ///< The number of the Resource kinds.
+
+  /// The innermost meter of the thread.
+  static inline thread_local ResourceMeter* current_ = nullptr;
+
+  Resources* resources_;  ///< The destination of the measurements.
+  ResourceMeter* parent_;  ///< The enclosing meter if any.
+  std::size_t start_rss_;  ///< The peak RSS at the start of the accounting.
+  std::size_t allocated_ = 0;  ///< The allocated bytes.
+  std::array<int, kNumKinds> live_{};  ///< The balance of the elements.
+  std::array<int, kNumKinds> peak_{};  ///< The peak balance of the elements.
+};
+
+}  // namespace scram::core
@@ -0,0 +1,515 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the persistent result cache.
+
+#include "result_cache.h"
+
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/filesystem.hpp>
+
+#include "error.h"
+#include "event.h"
+#include "expression/tape.h"
+#include "logger.h"
+#include "zbdd.h"
+
+namespace fs = boost::filesystem;
+
+namespace scram::core {
+
+namespace {
+
+const char kMagic[8] = "SCRAMRC";  ///< The signature of the entry files.
+/// The version of the entry format and the key composition.
+const std::uint32_t kVersion = 1;
+static_assert(sizeof(int) == sizeof(std::int32_t), "Unexpected entry format.");
+
+/// FNV-1a hash accumulator stable across platforms and program runs.
+class Hasher {
+ public:
+  /// Hashes the object representation of a trivially copyable value.
+  template <typename T>
+  void operator()(const T& value) noexcept {
+    Bytes(&value, sizeof(value));
+  }
+
+  /// Hashes the contents of a string.
+  void operator()(const std::string& value) noexcept {
+    (*this)(value.size());
+    Bytes(value.data(), value.size());
+  }
+
+  /// Hashes a raw block of memory.
+  void Bytes(const void* data, std::size_t size) noexcept {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+      hash_ ^= bytes[i];
+      hash_ *= 0x100000001b3;
+    }
+  }
+
+  /// @returns The accumulated hash value.
+  std::uint64_t value() const { return hash_; }
+
+ private:
+  std::uint64_t hash_ = 0xcbf29ce484222325;  ///< The FNV offset basis.
+};
+
+/// Binary writer of entry files with the running checksum.
+class Writer {
+ public:
+  /// @param[in] file  The destination file opened for binary writing.
+  explicit Writer(std::FILE* file) : file_(file) {}
+
+  /// Writes the object representation of a trivially copyable value.
+  template <typename T>
+  void operator()(const T& value) noexcept {
+    std::fwrite(&value, sizeof(value), 1, file_);
+    checksum_.Bytes(&value, sizeof(value));
+  }
+
+  /// @returns The checksum of the written data.
+  std::uint64_t checksum() const { return checksum_.value(); }
+
+ private:
+  std::FILE* file_;  ///< The destination file.
+  Hasher checksum_;  ///< The checksum of the written data.
+};
+
+/// Binary reader of entry files with the running checksum.
+class Reader {
+ public:
+  /// @param[in] file  The source file opened for binary reading.
+  explicit Reader(std::FILE* file) : file_(file) {}
+
+  /// Reads the object representation of a trivially copyable value.
+  ///
+  /// @returns false if the file has ended prematurely.
+  template <typename T>
+  bool operator()(T* value) noexcept {
+    if (std::fread(value, sizeof(*value), 1, file_) != 1)
+      return false;
+    checksum_.Bytes(value, sizeof(*value));
+    return true;
+  }
+
+  /// @returns The checksum of the read data.
+  std::uint64_t checksum() const { return checksum_.value(); }
+
+ private:
+  std::FILE* file_;  ///< The source file.
+  Hasher checksum_;  ///< The checksum of the read data.
+};
+
+/// Reads the payload of an entry file.
+///
+/// @param[in] key  The expected key of the entry.
+/// @param[in,out] read  The reader positioned after the signature.
+/// @param[out] entry  The entry to fill.
+///
+/// @returns false if the data is inconsistent or truncated.
+bool ReadEntry(ResultCache::Key key, Reader* read,
+               ResultCache::Entry* entry) noexcept {
+  std::uint32_t version = 0;
+  ResultCache::Key stored_key = 0;
+  if (!(*read)(&version) || version != kVersion || !(*read)(&stored_key) ||
+      stored_key != key) {
+    return false;
+  }
+  std::uint32_t num_products = 0;
+  if (!(*read)(&num_products))
+    return false;
+  for (std::uint32_t i = 0; i < num_products; ++i) {
+    std::uint32_t size = 0;
+    if (!(*read)(&size))
+      return false;
+    std::vector<int> product;
+    for (std::uint32_t j = 0; j < size; ++j) {
+      std::int32_t literal = 0;
+      if (!(*read)(&literal) || std::abs(literal) < Pdag::kVariableStartIndex)
+        return false;
+      product.push_back(literal);
+    }
+    entry->products.push_back(std::move(product));
+  }
+  std::uint8_t has_probability = 0;
+  if (!(*read)(&has_probability))
+    return false;
+  if (has_probability) {
+    double p_total = 0;
+    if (!(*read)(&p_total))
+      return false;
+    entry->p_total = p_total;
+  }
+  std::uint32_t num_points = 0;
+  if (!(*read)(&num_points))
+    return false;
+  for (std::uint32_t i = 0; i < num_points; ++i) {
+    std::pair<double, double> point;
+    if (!(*read)(&point.first) || !(*read)(&point.second))
+      return false;
+    entry->p_time.push_back(point);
+  }
+  std::uint32_t num_factors = 0;
+  if (!(*read)(&num_factors))
+    return false;
+  for (std::uint32_t i = 0; i < num_factors; ++i) {
+    std::int32_t position = 0;
+    double mif = 0;
+    if (!(*read)(&position) || !(*read)(&mif))
+      return false;
+    entry->mif.emplace_back(position, mif);
+  }
+  return true;
+}
+
+/// ZBDD container of products restored from the cache.
+class ProductZbdd : public Zbdd {
+ public:
+  /// @param[in] products  Unique minimal products with literal indices.
+  /// @param[in] settings  The analysis settings.
+  ProductZbdd(std::vector<std::vector<int>> products,
+              const Settings& settings) noexcept
+      : Zbdd(settings, IsCoherent(products)) {
+    auto less = [](int lhs, int rhs) { return Order(lhs) < Order(rhs); };
+    for (std::vector<int>& product : products)
+      std::sort(product.begin(), product.end(), less);
+    std::sort(products.begin(), products.end(),
+              [&less](const std::vector<int>& lhs,
+                      const std::vector<int>& rhs) {
+                return std::lexicographical_compare(lhs.begin(), lhs.end(),
+                                                    rhs.begin(), rhs.end(),
+                                                    less);
+              });
+    Zbdd::root(Convert(products.begin(), products.end(), 0));
+  }
+
+ private:
+  /// The position in the sorted products.
+  using Iterator = std::vector<std::vector<int>>::const_iterator;
+
+  /// @returns The variable order of a literal with complements last.
+  static int Order(int literal) {
+    return 2 * std::abs(literal) + (literal < 0);
+  }
+
+  /// @returns true if the products have no complements.
+  static bool IsCoherent(const std::vector<std::vector<int>>& products) {
+    return std::all_of(
+        products.begin(), products.end(), [](const std::vector<int>& product) {
+          return std::all_of(product.begin(), product.end(),
+                             [](int literal) { return literal > 0; });
+        });
+  }
+
+  /// Converts the sorted products sharing a common prefix into ZBDD.
+  ///
+  /// @param[in] first  The first product in the range.
+  /// @param[in] last  The end of the product range.
+  /// @param[in] depth  The length of the common prefix.
+  ///
+  /// @returns The ZBDD vertex of the product suffixes.
+  VertexPtr Convert(Iterator first, Iterator last, int depth) noexcept {
+    if (first == last)
+      return kEmpty_;
+    if (first->size() == depth)  // The minimal products contain no supersets.
+      return kBase_;
+    int literal = (*first)[depth];
+    Iterator middle =
+        std::find_if(first, last, [literal, depth](const auto& product) {
+          return product[depth] != literal;
+        });
+    return Zbdd::FindOrAddVertex(literal, Convert(first, middle, depth + 1),
+                                 Convert(middle, last, depth), Order(literal));
+  }
+};
+
+}  // namespace
+
+ResultCache::Key ResultCache::Hash(const Pdag& graph,
+                                   const Settings& settings) noexcept {
+  Hasher hash;
+  hash(kVersion);
+  hash(settings.algorithm());
+  hash(settings.prime_implicants());
+  hash(settings.approximation());
+  hash(settings.limit_order());
+  hash(settings.cut_off());
+  hash(settings.ccf_analysis());
+  hash(settings.probability_analysis());
+  hash(settings.importance_analysis());
+  hash(settings.safety_integrity_levels());
+  hash(settings.mission_time());
+  hash(settings.time_step());
+
+  // The gates are hashed in the deterministic order of their indices.
+  std::map<int, const Gate*> gates;
+  auto collect = [&gates](auto& self, const Gate& gate) -> void {
+    if (gates.emplace(gate.index(), &gate).second == false)
+      return;
+    for (const auto& arg : gate.args<Gate>())
+      self(self, arg.second);
+  };
+  collect(collect, graph.root());
+  hash(graph.complement());
+  for (const std::pair<const int, const Gate*>& entry : gates) {
+    const Gate& gate = *entry.second;
+    hash(gate.index());
+    hash(gate.type());
+    hash(gate.min_number());
+    hash(gate.args().size());
+    for (int arg : gate.args())
+      hash(arg);
+  }
+  for (const Pdag::Substitution& substitution : graph.substitutions()) {
+    for (const std::vector<int>* events :
+         {&substitution.hypothesis, &substitution.source}) {
+      hash(events->size());
+      for (int index : *events)
+        hash(index);
+    }
+    hash(substitution.target);
+  }
+
+  // The variables are identified by their events and probability values.
+  std::vector<mef::Expression*> expressions;
+  for (const mef::BasicEvent* event : graph.basic_events()) {
+    hash(event->id());
+    expressions.push_back(&event->expression());
+  }
+  mef::ExpressionTape tape(expressions);
+  if (settings.time_step()) {
+    std::vector<double> time_points;  // The points of probability analysis.
+    for (double time = 0; time < settings.mission_time();
+         time += settings.time_step()) {
+      time_points.push_back(time);
+    }
+    time_points.push_back(settings.mission_time());
+    tape.Evaluate(time_points);
+  } else {
+    tape.Evaluate();
+  }
+  for (int i = 0; i < expressions.size(); ++i) {
+    for (int lane = 0; lane < tape.num_lanes(); ++lane)
+      hash(tape.value(i, lane));
+  }
+  return hash.value();
+}
+
+ResultCache::Entry
+ResultCache::Record(const Zbdd& products, const Pdag& graph,
+                    const ProbabilityAnalysis* probability_analysis,
+                    const ImportanceAnalysis* importance_analysis) noexcept {
+  Entry entry;
+  for (const std::vector<int>& product : products)
+    entry.products.push_back(product);
+
+  if (probability_analysis) {
+    entry.p_total = probability_analysis->p_total();
+    entry.p_time = probability_analysis->p_time();
+  }
+
+  if (importance_analysis) {
+    std::unordered_map<const mef::BasicEvent*, int> positions;
+    for (const mef::BasicEvent* event : graph.basic_events())
+      positions.emplace(event, positions.size());
+    for (const ImportanceRecord& record : importance_analysis->importance())
+      entry.mif.emplace_back(positions.at(&record.event), record.factors.mif);
+  }
+  return entry;
+}
+
+bool ResultCache::Match(const Entry& lhs, const Entry& rhs) noexcept {
+  auto equal = [](double x, double y) {
+    return std::abs(x - y) <= 1e-9 * std::max(std::abs(x), std::abs(y));
+  };
+  if (lhs.products.size() != rhs.products.size() ||
+      lhs.p_total.has_value() != rhs.p_total.has_value() ||
+      (lhs.p_total && !equal(*lhs.p_total, *rhs.p_total)) ||
+      lhs.p_time.size() != rhs.p_time.size() ||
+      lhs.mif.size() != rhs.mif.size()) {
+    return false;
+  }
+  // The order of products is specific to the algorithm.
+  auto sorted = [](std::vector<std::vector<int>> products) {
+    for (std::vector<int>& product : products)
+      std::sort(product.begin(), product.end());
+    std::sort(products.begin(), products.end());
+    return products;
+  };
+  if (sorted(lhs.products) != sorted(rhs.products))
+    return false;
+  for (int i = 0; i < lhs.p_time.size(); ++i) {
+    if (!equal(lhs.p_time[i].first, rhs.p_time[i].first) ||
+        lhs.p_time[i].second != rhs.p_time[i].second) {
+      return false;
+    }
+  }
+  for (int i = 0; i < lhs.mif.size(); ++i) {
+    if (lhs.mif[i].first != rhs.mif[i].first ||
+        !equal(lhs.mif[i].second, rhs.mif[i].second)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ResultCache::ResultCache(std::string directory, double verification)
+    : directory_(std::move(directory)), verification_(verification) {
+  boost::system::error_code error;
+  fs::create_directories(directory_, error);
+  if (error) {
+    SCRAM_THROW(IOError("Cannot create the result cache directory."))
+        << boost::errinfo_file_name(directory_);
+  }
+}
+
+std::optional<ResultCache::Entry> ResultCache::Find(Key key) const noexcept {
+  std::string path = Path(key);
+  std::unique_ptr<std::FILE, decltype(&std::fclose)> file(
+      std::fopen(path.c_str(), "rb"), &std::fclose);
+  if (!file)
+    return {};
+
+  Entry entry;
+  Reader read(file.get());
+  char magic[sizeof(kMagic)] = {};
+  bool valid = read(&magic) && !std::memcmp(magic, kMagic, sizeof(kMagic)) &&
+               ReadEntry(key, &read, &entry);
+  if (valid) {
+    std::uint64_t expected = read.checksum();
+    std::uint64_t checksum = 0;
+    valid = read(&checksum) && checksum == expected &&
+            std::fgetc(file.get()) == EOF;
+  }
+  if (!valid) {
+    LOG(WARNING) << "Ignoring the corrupted result cache entry: " << path;
+    return {};
+  }
+  return entry;
+}
+
+void ResultCache::Store(Key key, const Entry& entry) const {
+  std::string path = Path(key);
+  // The entry is published atomically for concurrent readers.
+  std::string temp_path =
+      path + fs::unique_path(".%%%%-%%%%-%%%%-%%%%").string();
+  {
+    std::unique_ptr<std::FILE, decltype(&std::fclose)> file(
+        std::fopen(temp_path.c_str(), "wb"), &std::fclose);
+    if (!file) {
+      SCRAM_THROW(IOError("Cannot write the result cache entry."))
+          << boost::errinfo_file_name(temp_path);
+    }
+    Writer write(file.get());
+    write(kMagic);
+    write(kVersion);
+    write(key);
+    write(static_cast<std::uint32_t>(entry.products.size()));
+    for (const std::vector<int>& product : entry.products) {
+      write(static_cast<std::uint32_t>(product.size()));
+      for (int literal : product)
+        write(literal);
+    }
+    write(static_cast<std::uint8_t>(entry.p_total.has_value()));
+    if (entry.p_total)
+      write(*entry.p_total);
+    write(static_cast<std::uint32_t>(entry.p_time.size()));
+    for (const std::pair<double, double>& point : entry.p_time) {
+      write(point.first);
+      write(point.second);
+    }
+    write(static_cast<std::uint32_t>(entry.mif.size()));
+    for (const std::pair<int, double>& factor : entry.mif) {
+      write(factor.first);
+      write(factor.second);
+    }
+    write(write.checksum());
+    if (std::ferror(file.get()) || std::fclose(file.release())) {
+      fs::remove(temp_path);
+      SCRAM_THROW(IOError("Cannot write the result cache entry."))
+          << boost::errinfo_file_name(temp_path);
+    }
+  }
+  boost::system::error_code error;
+  fs::rename(temp_path, path, error);
+  if (error) {
+    fs::remove(temp_path, error);
+    SCRAM_THROW(IOError("Cannot store the result cache entry."))
+        << boost::errinfo_file_name(path);
+  }
+}
+
+bool ResultCache::Verify(Key key) const noexcept {
+  // The upper bits of the key are uniformly distributed in [0, 1).
+  return static_cast<double>(key >> 11) / (std::uint64_t(1) << 53) <
+         verification_;
+}
+
+std::string ResultCache::Path(Key key) const {
+  char name[17];
+  std::snprintf(name, sizeof(name), "%016" PRIx64, key);
+  return (fs::path(directory_) / name).string();
+}
+
+CachedFaultTreeAnalysis::CachedFaultTreeAnalysis(
+    const mef::Gate& root, const Settings& settings, const mef::Model* model,
+    std::vector<std::vector<int>> products)
+    : FaultTreeAnalysis(root, settings, model), data_(std::move(products)) {}
+
+const Zbdd& CachedFaultTreeAnalysis::GenerateProducts(const Pdag*) noexcept {
+  products_ =
+      std::make_unique<ProductZbdd>(std::move(data_), Analysis::settings());
+  return *products_;
+}
+
+CachedImportanceAnalysis::CachedImportanceAnalysis(
+    const CachedFaultTreeAnalysis* fta,
+    const ProbabilityAnalysis* prob_analysis, const ResultCache::Entry& entry)
+    : ImportanceAnalysis(prob_analysis),
+      basic_events_(fta->graph()->basic_events()),
+      p_total_(prob_analysis->p_total()),
+      occurrences_(basic_events_.size()),
+      mif_(entry.mif) {
+  for (const std::vector<int>& product : entry.products) {
+    for (int literal : product)
+      ++occurrences_[std::abs(literal) - Pdag::kVariableStartIndex];
+  }
+}
+
+double CachedImportanceAnalysis::CalculateMif(int index) noexcept {
+  auto it = std::lower_bound(
+      mif_.begin(), mif_.end(), index,
+      [](const std::pair<int, double>& factor, int position) {
+        return factor.first < position;
+      });
+  assert(it != mif_.end() && it->first == index && "Missing cached factor.");
+  return it->second;
+}
+
+}  // namespace scram::core
@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Persistent cache of analysis results
+/// keyed by the hash of the analyzed model fragment.
+
+#pragma once
+
+#include <cstdint>
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "fault_tree_analysis.h"
+#include "importance_analysis.h"
+#include "pdag.h"
+#include "probability_analysis.h"
+#include "settings.h"
+
+namespace scram::core {
+
+/// On-disk storage of the results of analysis targets.
+///
+/// Every entry is keyed by a hash of the target PDAG structure,
+/// the probability values of its variables,
+/// and the settings relevant to the results.
+/// The entries are stored in separate files of the cache directory,
+/// so the cache is safe to share between concurrent analyses.
+///
+/// @note The uncertainty analysis results are not cached
+///       because the samples depend on the order of all the analyses.
+class ResultCache : private boost::noncopyable {
+ public:
+  using Key = std::uint64_t;  ///< The hash of the analysis inputs.
+
+  /// The stored results of an analysis target.
+  struct Entry {
+    /// The products with the literal indices of the target PDAG.
+    std::vector<std::vector<int>> products;
+    std::optional<double> p_total;  ///< The total probability if calculated.
+    std::vector<std::pair<double, double>> p_time;  ///< {probability, time}.
+    /// The marginal importance factors of the variables
+    /// mapped by the positions of the variables in the PDAG.
+    std::vector<std::pair<int, double>> mif;
+  };
+
+  /// Computes the key of an analysis target.
+  ///
+  /// @param[in] graph  The unprocessed PDAG of the target.
+  /// @param[in] settings  The analysis settings.
+  ///
+  /// @returns The hash of the analysis inputs.
+  static Key Hash(const Pdag& graph, const Settings& settings) noexcept;
+
+  /// Extracts the entry from the analysis results.
+  ///
+  /// @param[in] products  The products from the qualitative analysis.
+  /// @param[in] graph  The PDAG of the qualitative analysis.
+  /// @param[in] probability_analysis  The optional probability analysis.
+  /// @param[in] importance_analysis  The optional importance analysis.
+  ///
+  /// @returns The cache entry with the results.
+  static Entry Record(const Zbdd& products, const Pdag& graph,
+                      const ProbabilityAnalysis* probability_analysis,
+                      const ImportanceAnalysis* importance_analysis) noexcept;
+
+  /// Compares the recomputed results with the cached ones.
+  ///
+  /// @param[in] lhs  The first entry.
+  /// @param[in] rhs  The second entry.
+  ///
+  /// @returns true if the entries hold the same results
+  ///          up to the round-off errors.
+  static bool Match(const Entry& lhs, const Entry& rhs) noexcept;
+
+  /// @param[in] directory  The cache directory to be created if missing.
+  /// @param[in] verification  The fraction of hits to verify.
+  ///
+  /// @throws IOError  The directory cannot be created.
+  ResultCache(std::string directory, double verification);
+
+  /// Loads the entry from the cache.
+  ///
+  /// @param[in] key  The key of the analysis target.
+  ///
+  /// @returns The cached entry if any.
+  ///
+  /// @note Unreadable or corrupted entries are treated as misses.
+  std::optional<Entry> Find(Key key) const noexcept;
+
+  /// Stores the entry into the cache replacing any existing one.
+  ///
+  /// @param[in] key  The key of the analysis target.
+  /// @param[in] entry  The results of the target.
+  ///
+  /// @throws IOError  The entry cannot be written.
+  void Store(Key key, const Entry& entry) const;
+
+  /// Selects the hits to verify deterministically by their keys.
+  ///
+  /// @param[in] key  The key of a cache hit.
+  ///
+  /// @returns true if the hit must be recomputed.
+  bool Verify(Key key) const noexcept;
+
+ private:
+  /// @returns The path of the entry file.
+  std::string Path(Key key) const;
+
+  std::string directory_;  ///< The location of the entry files.
+  double verification_;  ///< The fraction of hits to verify.
+};
+
+/// Qualitative analysis restored from the result cache.
+class CachedFaultTreeAnalysis : public FaultTreeAnalysis {
+ public:
+  /// @copydoc FaultTreeAnalysis::FaultTreeAnalysis
+  /// @param[in] products  The cached products.
+  CachedFaultTreeAnalysis(const mef::Gate& root, const Settings& settings,
+                          const mef::Model* model,
+                          std::vector<std::vector<int>> products);
+
+  using FaultTreeAnalysis::graph;  // Provide access to other analyses.
+
+ private:
+  /// The cached products need no preprocessing.
+  void Preprocess(Pdag*) noexcept override {}
+
+  const Zbdd& GenerateProducts(const Pdag* graph) noexcept override;
+
+  std::vector<std::vector<int>> data_;  ///< The cached products.
+  std::unique_ptr<Zbdd> products_;  ///< The products for reporting.
+};
+
+/// Probability analysis restored from the result cache.
+class CachedProbabilityAnalysis : public ProbabilityAnalysis {
+ public:
+  /// @param[in] fta  The restored qualitative analysis.
+  /// @param[in] mission_time  The mission time expression of the model.
+  /// @param[in] entry  The cache entry with the probability results.
+  CachedProbabilityAnalysis(const FaultTreeAnalysis* fta,
+                            mef::MissionTime* mission_time,
+                            const ResultCache::Entry& entry)
+      : ProbabilityAnalysis(fta, mission_time),
+        p_total_(*entry.p_total),
+        p_time_(entry.p_time) {}
+
+ private:
+  double CalculateTotalProbability() noexcept override { return p_total_; }
+
+  std::vector<std::pair<double, double>>
+  CalculateProbabilityOverTime() noexcept override {
+    return std::move(p_time_);
+  }
+
+  double p_total_;  ///< The cached total probability.
+  std::vector<std::pair<double, double>> p_time_;  ///< The cached curve.
+};
+
+/// Importance analysis restored from the result cache.
+class CachedImportanceAnalysis : public ImportanceAnalysis {
+ public:
+  /// @param[in] fta  The restored qualitative analysis.
+  /// @param[in] prob_analysis  The restored probability analysis.
+  /// @param[in] entry  The cache entry with the importance results.
+  CachedImportanceAnalysis(const CachedFaultTreeAnalysis* fta,
+                           const ProbabilityAnalysis* prob_analysis,
+                           const ResultCache::Entry& entry);
+
+ private:
+  double p_total() noexcept override { return p_total_; }
+
+  const std::vector<const mef::BasicEvent*>& basic_events() noexcept override {
+    return basic_events_;
+  }
+
+  std::vector<int> occurrences() noexcept override { return occurrences_; }
+
+  double CalculateMif(int index) noexcept override;
+
+  /// The variables of the restored qualitative analysis.
+  const std::vector<const mef::BasicEvent*>& basic_events_;
+  double p_total_;  ///< The total probability of the target.
+  std::vector<int> occurrences_;  ///< The occurrences of the variables.
+  /// The cached factors sorted by the positions of the variables.
+  std::vector<std::pair<int, double>> mif_;
+};
+
+}  // namespace scram::core
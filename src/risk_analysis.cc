@@ -20,12 +20,22 @@
 
 #include "risk_analysis.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
 #include "bdd.h"
+#include "error.h"
 #include "expression/random_deviate.h"
+#include "ext/parallel.h"
 #include "ext/scope_guard.h"
 #include "fault_tree.h"
 #include "logger.h"
 #include "mocus.h"
+#include "preprocessor.h"
+#include "progress.h"
 #include "zbdd.h"
 
 namespace scram::core {
@@ -33,13 +43,25 @@ namespace scram::core {
 RiskAnalysis::RiskAnalysis(mef::Model* model, const Settings& settings)
     : Analysis(settings), model_(model) {}
 
-void RiskAnalysis::Analyze() noexcept {
+void RiskAnalysis::Analyze(Sink* sink) {
   assert(results_.empty() && "Rerunning the analysis.");
+  sink_ = sink;
   // Set the seed for the pseudo-random number generator if given explicitly.
   // Otherwise it defaults to the implementation dependent value.
+  mef::RandomDeviate::engine(Analysis::settings().rng_engine());
   if (Analysis::settings().seed() >= 0)
     mef::RandomDeviate::seed(Analysis::settings().seed());
 
+  if (!Analysis::settings().cache_directory().empty()) {
+    if (Analysis::settings().uncertainty_analysis()) {
+      LOG(WARNING) << "The result cache is disabled for uncertainty analysis.";
+    } else {
+      result_cache_ = std::make_unique<ResultCache>(
+          Analysis::settings().cache_directory(),
+          Analysis::settings().cache_verification());
+    }
+  }
+
   if (model_->alignments().empty()) {
     RunAnalysis();
   } else {
@@ -50,7 +72,7 @@ void RiskAnalysis::Analyze() noexcept {
   }
 }
 
-void RiskAnalysis::RunAnalysis(std::optional<Context> context) noexcept {
+void RiskAnalysis::RunAnalysis(std::optional<Context> context) {
   std::vector<std::pair<mef::HouseEvent*, bool>> house_events;
   /// Restores the model after application of the context.
   ext::scope_guard restorator(
@@ -70,7 +92,7 @@ void RiskAnalysis::RunAnalysis(std::optional<Context> context) noexcept {
 
     for (const mef::SetHouseEvent* instruction :
          context->phase.instructions()) {
-      auto it = model_->table<mef::HouseEvent>().find(instruction->name());
+      auto it = model_->table<mef::HouseEvent>().find(instruction->symbol());
       assert(it != model_->table<mef::HouseEvent>().end() &&
              "Invalid instruction.");
       mef::HouseEvent& house_event = *it;
@@ -81,28 +103,36 @@ void RiskAnalysis::RunAnalysis(std::optional<Context> context) noexcept {
     }
   }
 
+  std::vector<Task> tasks;
+  int first_eta_result = event_tree_results_.size();
   for (const mef::InitiatingEvent& initiating_event :
        model_->initiating_events()) {
     if (initiating_event.event_tree()) {
       LOG(INFO) << "Running event tree analysis: " << initiating_event.name();
+      TRACE("event tree", initiating_event.name());
       auto eta = std::make_unique<EventTreeAnalysis>(
           initiating_event, Analysis::settings(), model_->context());
       eta->Analyze();
-      for (EventTreeAnalysis::Result& result : eta->sequences()) {
-        const mef::Sequence& sequence = result.sequence;
-        LOG(INFO) << "Running analysis for sequence: " << sequence.name();
-        results_.push_back(
-            {{std::pair<const mef::InitiatingEvent&, const mef::Sequence&>{
-                  initiating_event, sequence},
-              context}});
-        RunAnalysis(*result.gate, &results_.back());
-        if (result.is_expression_only) {
-          results_.back().fault_tree_analysis = nullptr;
-          results_.back().importance_analysis = nullptr;
-        }
+      if (Analysis::settings().shared_bdd()) {
         if (Analysis::settings().probability_analysis())
-          result.p_sequence = results_.back().probability_analysis->p_total();
-        LOG(INFO) << "Finished analysis for sequence: " << sequence.name();
+          RunAnalysis(eta.get());
+      } else {
+        for (EventTreeAnalysis::Result& result : eta->sequences()) {
+          results_.push_back(
+              {{std::pair<const mef::InitiatingEvent&, const mef::Sequence&>{
+                    initiating_event, result.sequence},
+                context}});
+          tasks.push_back({*result.gate, nullptr, &result, nullptr});
+        }
+        for (EventTreeAnalysis::EndState& end_state : eta->end_states()) {
+          results_.push_back(
+              {{std::pair<const mef::InitiatingEvent&,
+                          const EventTreeAnalysis::EndState&>{
+                    initiating_event, end_state},
+                context}});
+          tasks.push_back({*end_state.gate, nullptr, nullptr, nullptr,
+                           nullptr, &end_state});
+        }
       }
       event_tree_results_.push_back(
           {initiating_event, context, std::move(eta)});
@@ -112,64 +142,301 @@ void RiskAnalysis::RunAnalysis(std::optional<Context> context) noexcept {
 
   for (const mef::FaultTree& ft : model_->fault_trees()) {
     for (const mef::Gate* target : ft.top_events()) {
-      LOG(INFO) << "Running analysis for gate: " << target->id();
       results_.push_back({{target, context}});
-      RunAnalysis(*target, &results_.back());
-      LOG(INFO) << "Finished analysis for gate: " << target->id();
+      Task& task = tasks.emplace_back(Task{*target, nullptr, nullptr});
+      HouseEventStates states = GatherHouseEvents(*target);
+      if (context && !states.empty())
+        task.symbolic_graph = &symbolic_graphs_[target];
+      if (!sink_) {
+        task.fault_tree_analysis =
+            &fault_tree_analyses_[{target, std::move(states)}];
+      }
+    }
+  }
+  // The result storage is stable only after all the insertions.
+  for (int i = 0, first = results_.size() - tasks.size(); i < tasks.size();
+       ++i) {
+    tasks[i].result = &results_[first + i];
+  }
+
+  // Without the serial Monte Carlo sampling,
+  // the streamed results are completed by the workers
+  // as soon as all the preceding targets are analyzed.
+  bool stream = sink_ && !Analysis::settings().uncertainty_analysis();
+  std::vector<char> analyzed(stream ? tasks.size() : 0);
+  int num_completed = 0;
+  std::mutex completion_mutex;
+
+  Progress* progress = Analysis::settings().progress();
+  std::atomic<int> num_done = 0;
+  ext::parallel_for(
+      tasks.size(), Analysis::settings().num_threads(),
+      [this, &tasks, progress, &num_done, stream, &analyzed, &num_completed,
+       &completion_mutex](int i) {
+        CheckCancellation(progress);
+        Task& task = tasks[i];
+        const char* kind = "gate";
+        const std::string* name = &task.gate.id();
+        if (task.sequence) {
+          kind = "sequence";
+          name = &task.sequence->sequence.name();
+        } else if (task.end_state) {
+          kind = "end state";
+          name = &task.end_state->name;
+        }
+        LOG(INFO) << "Running analysis for " << kind << ": " << *name;
+        TRACE(kind, *name);
+        RunAnalysis(&task);
+        LOG(INFO) << "Finished analysis for " << kind << ": " << *name;
+        ReportProgress(progress, "targets", ++num_done, tasks.size());
+        if (stream) {
+          std::lock_guard<std::mutex> lock(completion_mutex);
+          analyzed[i] = true;
+          while (num_completed < tasks.size() && analyzed[num_completed])
+            Complete(&tasks[num_completed++]);
+        }
+      });
+
+  if (!stream) {
+    for (Task& task : tasks)
+      Complete(&task);
+  }
+  if (sink_) {
+    for (int i = first_eta_result; i < event_tree_results_.size(); ++i)
+      sink_->Consume(event_tree_results_[i]);
+  }
+}
+
+void RiskAnalysis::Complete(Task* task) {
+  if (task->uncertainty_analysis) {
+    task->uncertainty_analysis->Analyze();
+    task->result->uncertainty_analysis = std::move(task->uncertainty_analysis);
+  }
+  if (task->sequence) {
+    if (task->sequence->is_expression_only) {
+      task->result->fault_tree_analysis = nullptr;
+      task->result->importance_analysis = nullptr;
+    }
+    if (Analysis::settings().probability_analysis()) {
+      task->sequence->p_sequence =
+          task->result->probability_analysis->p_total();
+    }
+  } else if (task->end_state) {
+    if (task->end_state->is_expression_only) {
+      task->result->fault_tree_analysis = nullptr;
+      task->result->importance_analysis = nullptr;
+    }
+    if (Analysis::settings().probability_analysis()) {
+      task->end_state->p_end_state =
+          task->result->probability_analysis->p_total();
+    }
+  }
+  if (sink_) {
+    Result& result = *task->result;
+    sink_->Consume(result);
+    result.uncertainty_analysis.reset();
+    result.importance_analysis.reset();
+    result.probability_analysis.reset();
+    result.fault_tree_analysis.reset();
+  }
+}
+
+void RiskAnalysis::RunAnalysis(EventTreeAnalysis* eta) {
+  CLOCK(shared_time);
+  TRACE("Shared BDD sequence probabilities");
+  LOG(DEBUG2) << "Calculating sequence probabilities with shared BDD...";
+  std::vector<std::unique_ptr<Pdag>> graphs;
+  std::vector<const Pdag*> roots;
+  for (const EventTreeAnalysis::Result& result : eta->sequences()) {
+    CheckCancellation(Analysis::settings().progress());
+    graphs.push_back(std::make_unique<Pdag>(
+        *result.gate, Analysis::settings().ccf_analysis()));
+    CustomPreprocessor<Bdd>{graphs.back().get()}();
+    roots.push_back(graphs.back().get());
+  }
+  for (const EventTreeAnalysis::EndState& end_state : eta->end_states()) {
+    graphs.push_back(std::make_unique<Pdag>(
+        *end_state.gate, Analysis::settings().ccf_analysis()));
+    CustomPreprocessor<Bdd>{graphs.back().get()}();
+    roots.push_back(graphs.back().get());
+  }
+  Bdd bdd(roots, Analysis::settings());
+  graphs.clear();  // The BDD is independent of the graphs.
+
+  Pdag::IndexMap<double> p_vars;
+  p_vars.reserve(bdd.basic_events().size());
+  for (const mef::BasicEvent* event : bdd.basic_events())
+    p_vars.push_back(event->p());
+  std::vector<double> p_sequences = CalculateProbabilities(&bdd, p_vars);
+  int num_sequences = eta->sequences().size();
+  for (int i = 0; i < num_sequences; ++i)
+    eta->sequences()[i].p_sequence = p_sequences[i];
+  for (int i = num_sequences; i < p_sequences.size(); ++i)
+    eta->end_states()[i - num_sequences].p_end_state = p_sequences[i];
+  LOG(DEBUG2) << "Calculated " << p_sequences.size()
+              << " sequence probabilities in " << DUR(shared_time);
+}
+
+RiskAnalysis::HouseEventStates
+RiskAnalysis::GatherHouseEvents(const mef::Gate& gate) noexcept {
+  HouseEventStates house_events;
+  std::unordered_set<const mef::Gate*> visited;
+  auto gather = [&house_events, &visited](auto& self,
+                                          const mef::Gate& node) -> void {
+    if (visited.insert(&node).second == false)
+      return;
+    for (const mef::Formula::Arg& arg : node.formula().args()) {
+      if (auto* house_event = std::get_if<mef::HouseEvent*>(&arg.event)) {
+        house_events.emplace_back(*house_event, (*house_event)->state());
+      } else if (auto* arg_gate = std::get_if<mef::Gate*>(&arg.event)) {
+        self(self, **arg_gate);
+      }
     }
+  };
+  gather(gather, gate);
+  std::sort(house_events.begin(), house_events.end());
+  house_events.erase(std::unique(house_events.begin(), house_events.end()),
+                     house_events.end());
+  return house_events;
+}
+
+std::unique_ptr<Pdag> RiskAnalysis::ConstructGraph(const Task& task) {
+  bool ccf = Analysis::settings().ccf_analysis();
+  if (!task.symbolic_graph)
+    return std::make_unique<Pdag>(task.gate, ccf, model_);
+
+  std::unique_ptr<Pdag>& graph = *task.symbolic_graph;
+  if (!graph) {
+    LOG(DEBUG2) << "Preprocessing the graph with symbolic house events...";
+    graph = std::make_unique<Pdag>(task.gate, ccf, model_, /*symbolic=*/true);
+    CustomPreprocessor<Pdag>{graph.get()}();
   }
+  return graph->Specialize();
 }
 
-void RiskAnalysis::RunAnalysis(const mef::Gate& target,
-                               Result* result) noexcept {
+void RiskAnalysis::RunAnalysis(Task* task) {
+  std::optional<ResultCache::Entry> hit;
+  if (result_cache_) {
+    task->graph = ConstructGraph(*task);
+    task->cache_key = ResultCache::Hash(*task->graph, Analysis::settings());
+    hit = result_cache_->Find(*task->cache_key);
+    if (hit && !result_cache_->Verify(*task->cache_key))
+      return RunAnalysis(*hit, task);
+  }
+
   switch (Analysis::settings().algorithm()) {
     case Algorithm::kBdd:
-      return RunAnalysis<Bdd>(target, result);
+      RunAnalysis<Bdd>(task);
+      break;
     case Algorithm::kZbdd:
-      return RunAnalysis<Zbdd>(target, result);
+      RunAnalysis<Zbdd>(task);
+      break;
     case Algorithm::kMocus:
-      return RunAnalysis<Mocus>(target, result);
+      RunAnalysis<Mocus>(task);
+  }
+
+  if (task->cache_entry) {
+    if (hit && !ResultCache::Match(*hit, *task->cache_entry)) {
+      LOG(WARNING) << "The cached results of " << task->gate.id()
+                   << " failed the verification and are replaced.";
+      hit.reset();
+    }
+    if (!hit) {
+      try {
+        result_cache_->Store(*task->cache_key, *task->cache_entry);
+      } catch (const IOError& err) {  // The cache is only an optimization.
+        LOG(WARNING) << "The results of " << task->gate.id()
+                     << " are not cached: " << err.what();
+      }
+    }
+    task->cache_entry.reset();
   }
 }
 
-template <class Algorithm>
-void RiskAnalysis::RunAnalysis(const mef::Gate& target,
-                               Result* result) noexcept {
-  auto fta = std::make_unique<FaultTreeAnalyzer<Algorithm>>(
-      target, Analysis::settings(), model_);
+void RiskAnalysis::RunAnalysis(const ResultCache::Entry& entry, Task* task) {
+  LOG(DEBUG2) << "Restoring the results from the cache";
+  TRACE("Restoring cached results");
+  auto fta = std::make_shared<CachedFaultTreeAnalysis>(
+      task->gate, Analysis::settings(), model_, entry.products);
+  fta->graph(std::move(task->graph));
   fta->Analyze();
+  if (Analysis::settings().probability_analysis()) {
+    auto pa = std::make_unique<CachedProbabilityAnalysis>(
+        fta.get(), &model_->mission_time(), entry);
+    pa->Analyze();
+    if (Analysis::settings().importance_analysis()) {
+      auto ia = std::make_unique<CachedImportanceAnalysis>(fta.get(),
+                                                           pa.get(), entry);
+      ia->Analyze();
+      task->result->importance_analysis = std::move(ia);
+    }
+    task->result->probability_analysis = std::move(pa);
+  }
+  task->result->fault_tree_analysis = std::move(fta);
+  task->result->cached = true;
+}
+
+template <class Algorithm>
+void RiskAnalysis::RunAnalysis(Task* task) {
+  std::shared_ptr<FaultTreeAnalysis> fta;
+  if (task->fault_tree_analysis && *task->fault_tree_analysis) {
+    LOG(DEBUG2) << "Reusing the qualitative analysis from the previous phase";
+    fta = *task->fault_tree_analysis;
+  } else {
+    fta = std::make_shared<FaultTreeAnalyzer<Algorithm>>(
+        task->gate, Analysis::settings(), model_);
+    if (!task->graph && task->symbolic_graph)
+      task->graph = ConstructGraph(*task);
+    if (task->graph)
+      fta->graph(std::move(task->graph));
+    fta->Analyze();
+    if (task->fault_tree_analysis)
+      *task->fault_tree_analysis = fta;
+  }
+  auto* analyzer = static_cast<FaultTreeAnalyzer<Algorithm>*>(fta.get());
+  RunAnalysis<Algorithm>(analyzer, task);
+  if (task->cache_key) {
+    task->cache_entry = ResultCache::Record(
+        analyzer->algorithm()->products(), *analyzer->graph(),
+        task->result->probability_analysis.get(),
+        task->result->importance_analysis.get());
+  }
+  task->result->fault_tree_analysis = std::move(fta);
+}
+
+template <class Algorithm>
+void RiskAnalysis::RunAnalysis(FaultTreeAnalyzer<Algorithm>* fta,
+                               Task* task) {
   if (Analysis::settings().probability_analysis()) {
     switch (Analysis::settings().approximation()) {
       case Approximation::kNone:
-        RunAnalysis<Algorithm, Bdd>(fta.get(), result);
+        RunAnalysis<Algorithm, Bdd>(fta, task);
         break;
       case Approximation::kRareEvent:
-        RunAnalysis<Algorithm, RareEventCalculator>(fta.get(), result);
+        RunAnalysis<Algorithm, RareEventCalculator>(fta, task);
         break;
       case Approximation::kMcub:
-        RunAnalysis<Algorithm, McubCalculator>(fta.get(), result);
+        RunAnalysis<Algorithm, McubCalculator>(fta, task);
     }
   }
-  result->fault_tree_analysis = std::move(fta);
 }
 
 template <class Algorithm, class Calculator>
 void RiskAnalysis::RunAnalysis(FaultTreeAnalyzer<Algorithm>* fta,
-                               Result* result) noexcept {
+                               Task* task) {
   auto pa = std::make_unique<ProbabilityAnalyzer<Calculator>>(
       fta, &model_->mission_time());
   pa->Analyze();
   if (Analysis::settings().importance_analysis()) {
     auto ia = std::make_unique<ImportanceAnalyzer<Calculator>>(pa.get());
     ia->Analyze();
-    result->importance_analysis = std::move(ia);
+    task->result->importance_analysis = std::move(ia);
   }
   if (Analysis::settings().uncertainty_analysis()) {
-    auto ua = std::make_unique<UncertaintyAnalyzer<Calculator>>(pa.get());
-    ua->Analyze();
-    result->uncertainty_analysis = std::move(ua);
+    task->uncertainty_analysis =
+        std::make_unique<UncertaintyAnalyzer<Calculator>>(pa.get());
   }
-  result->probability_analysis = std::move(pa);
+  task->result->probability_analysis = std::move(pa);
 }
 
 }  // namespace scram::core
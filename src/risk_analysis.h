@@ -20,8 +20,10 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -34,6 +36,7 @@
 #include "importance_analysis.h"
 #include "model.h"
 #include "probability_analysis.h"
+#include "result_cache.h"
 #include "settings.h"
 #include "uncertainty_analysis.h"
 
@@ -52,8 +55,10 @@ class RiskAnalysis : public Analysis {
   struct Result {
     /// The analysis target type as a unique identifier.
     struct Id {
-      std::variant<const mef::Gate*, std::pair<const mef::InitiatingEvent&,
-                                               const mef::Sequence&>>
+      std::variant<const mef::Gate*,
+                   std::pair<const mef::InitiatingEvent&, const mef::Sequence&>,
+                   std::pair<const mef::InitiatingEvent&,
+                             const EventTreeAnalysis::EndState&>>
           target;  ///< The main input to the analysis.
       std::optional<Context> context;  ///< Optional analysis context.
     };
@@ -61,12 +66,15 @@ class RiskAnalysis : public Analysis {
     const Id id;  ///< The main analysis input or target.
 
     /// Optional analyses, i.e., may be nullptr.
+    /// The qualitative analysis may be shared by the phases of an alignment.
     /// @{
-    std::unique_ptr<const FaultTreeAnalysis> fault_tree_analysis;
+    std::shared_ptr<const FaultTreeAnalysis> fault_tree_analysis;
     std::unique_ptr<const ProbabilityAnalysis> probability_analysis;
     std::unique_ptr<const ImportanceAnalysis> importance_analysis;
     std::unique_ptr<const UncertaintyAnalysis> uncertainty_analysis;
     /// @}
+
+    bool cached = false;  ///< The indication of results restored from cache.
   };
 
   /// The analysis results grouped by an event-tree.
@@ -79,6 +87,21 @@ class RiskAnalysis : public Analysis {
     std::unique_ptr<const EventTreeAnalysis> event_tree_analysis;
   };
 
+  /// Receiver of the analysis results
+  /// as soon as the results are complete.
+  class Sink {
+   public:
+    virtual ~Sink() = default;
+
+    /// @param[in] result  The complete results of an event tree analysis.
+    virtual void Consume(const EtaResult& result) = 0;
+
+    /// @param[in] result  The complete results of an analysis target.
+    ///
+    /// @post The analyses of the result are released after the call.
+    virtual void Consume(const Result& result) = 0;
+  };
+
   /// @param[in] model  An analysis model with fault trees, events, etc.
   /// @param[in] settings  Analysis settings for the given model.
   ///
@@ -99,8 +122,24 @@ class RiskAnalysis : public Analysis {
   ///       only after full initialization of the model
   ///       with or without its probabilities.
   ///
+  /// The optional sink receives the results in the order of results(),
+  /// and the event tree results of a phase after the results of the phase.
+  /// The analyses of the consumed results are released,
+  /// so the peak memory is bounded by the analyses in flight
+  /// instead of the analyses of all the targets.
+  /// The qualitative analyses are not shared between phases in this mode.
+  ///
+  /// @param[in] sink  The optional receiver of the streamed results.
+  ///
   /// @pre The analysis is performed only once.
-  void Analyze() noexcept;
+  ///
+  /// @post With the sink, the results keep only their ids.
+  ///
+  /// @throws CancelError  The cancellation is requested
+  ///                      through the progress channel of the settings.
+  ///                      The model is restored,
+  ///                      but the results are incomplete.
+  void Analyze(Sink* sink = nullptr);
 
   /// @returns The results of the analysis.
   const std::vector<Result>& results() const { return results_; }
@@ -111,31 +150,115 @@ class RiskAnalysis : public Analysis {
   }
 
  private:
+  /// The analysis of a single target in the current context.
+  struct Task {
+    const mef::Gate& gate;  ///< The analysis target.
+    Result* result;  ///< The destination of the analysis results.
+    /// The originating event-tree sequence if any.
+    EventTreeAnalysis::Result* sequence;
+    /// The uncertainty analysis deferred to the serial stage.
+    std::unique_ptr<UncertaintyAnalysis> uncertainty_analysis;
+    /// The optional storage of the qualitative analysis
+    /// to reuse between phases.
+    std::shared_ptr<FaultTreeAnalysis>* fault_tree_analysis = nullptr;
+    /// The originating event-tree end state if any.
+    EventTreeAnalysis::EndState* end_state = nullptr;
+    /// The optional storage of the graph with symbolic house events
+    /// to specialize for the phases.
+    std::unique_ptr<Pdag>* symbolic_graph = nullptr;
+    /// The key of the target in the result cache if enabled.
+    std::optional<ResultCache::Key> cache_key;
+    /// The graph of the target hashed for the cache key
+    /// and handed over to the analysis.
+    std::unique_ptr<Pdag> graph;
+    /// The results recorded for the result cache.
+    std::optional<ResultCache::Entry> cache_entry;
+  };
+
+  /// The states of house events sorted by the event addresses.
+  using HouseEventStates = std::vector<std::pair<const mef::HouseEvent*, bool>>;
+
   /// Runs the whole analysis with the given alignment.
   ///
+  /// The targets are analyzed concurrently
+  /// while the model is in the read-only state of the context.
+  /// The Monte Carlo sampling mutates shared expressions and the RNG;
+  /// therefore, it is performed serially in the order of results.
+  ///
   /// @param[in] context  The optional context with the current alignment/phase.
   ///
   /// @pre The model is in pristine.
   ///
   /// @post The model is restored to the original state.
-  void RunAnalysis(std::optional<Context> context = {}) noexcept;
+  void RunAnalysis(std::optional<Context> context = {});
+
+  /// Calculates the probabilities of all the sequences and end states
+  /// of an event tree with a single BDD shared by them.
+  ///
+  /// @param[in,out] eta  The event tree analysis with collected sequences.
+  void RunAnalysis(EventTreeAnalysis* eta);
+
+  /// @param[in] gate  The analysis target.
+  ///
+  /// @returns The current states of the house events reachable from the gate.
+  static HouseEventStates GatherHouseEvents(const mef::Gate& gate) noexcept;
+
+  /// Constructs the graph of the target in the current context.
+  /// The graph with symbolic house events is constructed and preprocessed
+  /// only once for all the phases
+  /// and specialized with the current house event states.
+  ///
+  /// @param[in] task  The analysis target.
+  ///
+  /// @returns The unpreprocessed or specialized graph of the target.
+  std::unique_ptr<Pdag> ConstructGraph(const Task& task);
 
   /// Runs all possible analysis on a given target.
   /// Analysis types are deduced from the settings.
   ///
-  /// @param[in] target  Analysis target.
-  /// @param[in,out] result  The result container element.
-  void RunAnalysis(const mef::Gate& target, Result* result) noexcept;
+  /// The results of unchanged targets are restored from the result cache
+  /// unless selected for verification.
+  ///
+  /// @param[in,out] task  The target and the result container element.
+  ///
+  /// @note The function is safe to call concurrently for different tasks.
+  void RunAnalysis(Task* task);
+
+  /// Restores the results of the target from the result cache.
+  ///
+  /// @param[in] entry  The cached results of the target.
+  /// @param[in,out] task  The target and the result container element.
+  void RunAnalysis(const ResultCache::Entry& entry, Task* task);
+
+  /// Completes the results of the analyzed target.
+  /// The uncertainty analysis is run if requested.
+  /// The results are handed to the sink if any.
+  ///
+  /// @param[in,out] task  The analyzed target with its results.
+  ///
+  /// @pre The tasks are completed serially in the order of results.
+  void Complete(Task* task);
 
   /// Defines and runs Qualitative analysis on the target.
   /// Calls the Quantitative analysis if requested in settings.
   ///
+  /// The Qualitative analysis is independent of the mission time;
+  /// therefore, it is reused if the task provides an already analyzed one.
+  ///
+  /// @tparam Algorithm  Qualitative analysis algorithm.
+  ///
+  /// @param[in,out] task  The target and the result container element.
+  template <class Algorithm>
+  void RunAnalysis(Task* task);
+
+  /// Runs the Quantitative analyses requested in settings.
+  ///
   /// @tparam Algorithm  Qualitative analysis algorithm.
   ///
-  /// @param[in] target  Analysis target.
-  /// @param[in,out] result  The result container element.
+  /// @param[in] fta  The result of Qualitative analysis.
+  /// @param[in,out] task  The target and the result container element.
   template <class Algorithm>
-  void RunAnalysis(const mef::Gate& target, Result* result) noexcept;
+  void RunAnalysis(FaultTreeAnalyzer<Algorithm>* fta, Task* task);
 
   /// Defines and runs Quantitative analysis on the target.
   ///
@@ -143,16 +266,31 @@ class RiskAnalysis : public Analysis {
   /// @tparam Calculator  Quantitative analysis algorithm.
   ///
   /// @param[in] fta  The result of Qualitative analysis.
-  /// @param[in,out] result  The result container element.
+  /// @param[in,out] task  The target and the result container element.
   ///
   /// @pre FaultTreeAnalyzer is ready to tolerate
   ///      giving its internals to Quantitative analyzers.
   template <class Algorithm, class Calculator>
-  void RunAnalysis(FaultTreeAnalyzer<Algorithm>* fta, Result* result) noexcept;
+  void RunAnalysis(FaultTreeAnalyzer<Algorithm>* fta, Task* task);
 
   mef::Model* model_;  ///< The model with constructs.
   std::vector<Result> results_;  ///< The analysis result storage.
   std::vector<EtaResult> event_tree_results_;  ///< Grouping of sequences.
+  /// The Qualitative analyses of the model gates
+  /// by the states of their house events.
+  /// The phases of alignments that do not change these states
+  /// skip the PDAG construction, preprocessing, and product generation.
+  std::map<std::pair<const mef::Gate*, HouseEventStates>,
+           std::shared_ptr<FaultTreeAnalysis>>
+      fault_tree_analyses_;
+  /// The preprocessed graphs of the model gates with symbolic house events.
+  /// The phases that change the house events of a gate
+  /// specialize its graph with the constants
+  /// instead of the construction from the model,
+  /// and the preprocessing of the phases starts from the simplified graph.
+  std::unordered_map<const mef::Gate*, std::unique_ptr<Pdag>> symbolic_graphs_;
+  std::unique_ptr<ResultCache> result_cache_;  ///< The optional result cache.
+  Sink* sink_ = nullptr;  ///< The optional receiver of streamed results.
 };
 
 }  // namespace scram::core
@@ -18,13 +18,16 @@
 /// @file
 /// Main entrance.
 
+#include <csignal>
 #include <cstdarg>
 #include <cstdio>  // vsnprintf
 #include <cstring>  // strerror
 
+#include <atomic>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <boost/core/typeinfo.hpp>
@@ -36,15 +39,18 @@
 #include <libxml/xmlerror.h>  // initGenericErrorDefaultFunc
 #include <libxml/xmlversion.h>  // LIBXML_TEST_VERSION, LIBXML_DOTTED_VERSION
 
+#include "compact_reporter.h"
 #include "error.h"
 #include "ext/scope_guard.h"
 #include "initializer.h"
 #include "logger.h"
+#include "progress.h"
 #include "project.h"
 #include "reporter.h"
 #include "risk_analysis.h"
 #include "serialization.h"
 #include "settings.h"
+#include "snapshot.h"
 #include "version.h"
 
 namespace po = boost::program_options;
@@ -65,6 +71,10 @@ po::options_description ConstructOptions() {
       ("version", "Display version information")
       ("project", OPT_VALUE(path), "Project file with analysis configurations")
       ("allow-extern", "**UNSAFE** Allow external libraries")
+      ("snapshot", OPT_VALUE(path),
+       "Load the model from the snapshot instead of input files")
+      ("save-snapshot", OPT_VALUE(path),
+       "Save the snapshot of the valid input files")
       ("validate", "Validate input files without analysis")
       ("bdd", "Perform qualitative analysis with BDD")
       ("zbdd", "Perform qualitative analysis with ZBDD")
@@ -75,6 +85,7 @@ po::options_description ConstructOptions() {
       ("uncertainty", "Perform uncertainty analysis")
       ("ccf", "Perform common-cause failure analysis")
       ("sil", "Compute the Safety Integrity Level metrics")
+      ("shared-bdd", "Share one BDD among the sequences of an event tree")
       ("rare-event", "Use the rare event approximation")
       ("mcub", "Use the MCUB approximation")
       ("limit-order,l", OPT_VALUE(int), "Upper limit for the product order")
@@ -88,8 +99,23 @@ po::options_description ConstructOptions() {
        "Number of quantiles for distributions")
       ("num-bins", OPT_VALUE(int), "Number of bins for histograms")
       ("seed", OPT_VALUE(int), "Seed for the pseudo-random number generator")
+      ("rng-engine", OPT_VALUE(std::string),
+       "Pseudo-random number engine: mt19937 or philox")
+      ("threads", OPT_VALUE(int), "Number of threads to analyze targets")
+      ("target", OPT_VALUE(std::vector<std::string>)->composing(),
+       "Gate or initiating event to analyze instead of the whole model")
+      ("cache-dir", OPT_VALUE(path),
+       "Directory to persist analysis results between runs")
+      ("verify-cache", OPT_VALUE(double),
+       "Fraction of cached results to verify by recomputation")
       ("output,o", OPT_VALUE(path), "Output file for reports")
+      ("trace-file", OPT_VALUE(path),
+       "Output file for the Chrome Trace Event timeline")
       ("no-indent", "Omit indentation whitespace in output XML")
+      ("stream-report",
+       "Report results as analyses finish to bound the memory use")
+      ("report-format", OPT_VALUE(std::string),
+       "Report format: xml, jsonl (JSON lines), or columnar (binary)")
       ("verbosity", OPT_VALUE(int), "Set log verbosity");
 #ifndef NDEBUG
   po::options_description debug("Debug Options");
@@ -163,11 +189,26 @@ int ParseArguments(int argc, char* argv[], po::variables_map* vm) {
     }
   }
 
-  if (!vm->count("input-files") && !vm->count("project")) {
+  if (vm->count("snapshot") &&
+      (vm->count("input-files") || vm->count("save-snapshot"))) {
+    std::cerr << "The snapshot replaces input files.\n\n";
+    print_help(std::cerr);
+    return 1;
+  }
+  if (!vm->count("input-files") && !vm->count("project") &&
+      !vm->count("snapshot")) {
     std::cerr << "No input or configuration file is given.\n\n";
     print_help(std::cerr);
     return 1;
   }
+  if (vm->count("report-format")) {
+    std::string format = (*vm)["report-format"].as<std::string>();
+    if (format != "xml" && format != "jsonl" && format != "columnar") {
+      std::cerr << "Unknown report format: " << format << "\n\n";
+      print_help(std::cerr);
+      return 1;
+    }
+  }
   if ((vm->count("bdd") + vm->count("zbdd") + vm->count("mocus")) > 1) {
     std::cerr << "Mutually exclusive qualitative analysis algorithms.\n"
               << "(MOCUS/BDD/ZBDD) cannot be applied at the same time.\n\n";
@@ -223,7 +264,13 @@ void ConstructSettings(const po::variables_map& vm,
   settings->importance_analysis(vm.count("importance"));
   settings->uncertainty_analysis(vm.count("uncertainty"));
   settings->ccf_analysis(vm.count("ccf"));
+  settings->shared_bdd(vm.count("shared-bdd"));
   SET("seed", int, seed);
+  SET("rng-engine", std::string, rng_engine);
+  SET("threads", int, num_threads);
+  SET("target", std::vector<std::string>, targets);
+  SET("cache-dir", std::string, cache_directory);
+  SET("verify-cache", double, cache_verification);
   SET("limit-order", int, limit_order);
   SET("cut-off", double, cut_off);
   SET("mission-time", double, mission_time);
@@ -237,6 +284,55 @@ void ConstructSettings(const po::variables_map& vm,
 }
 #undef SET
 
+/// The progress channel of the running analysis.
+std::atomic<scram::core::Progress*> g_progress = nullptr;
+
+/// Requests the cancellation of the running analysis.
+///
+/// @param[in] signal  The termination request signal.
+extern "C" void CancelAnalysis(int signal) {
+  if (scram::core::Progress* progress = g_progress)
+    progress->Cancel();
+  std::signal(signal, SIG_DFL);  // The repeated request terminates.
+}
+
+/// Runs the risk analysis and reports its results in a compact format.
+///
+/// @param[in,out] analysis  The risk analysis to be run.
+/// @param[in] vm  Variables map of program options.
+/// @param[in] no_report  The flag to skip the report.
+///
+/// @throws IOError  The output file is not accessible,
+///                  or the write operation has failed.
+void ReportCompact(scram::core::RiskAnalysis* analysis,
+                   const po::variables_map& vm, bool no_report) {
+  if (no_report)
+    return analysis->Analyze();
+  auto format = vm["report-format"].as<std::string>() == "jsonl"
+                    ? scram::CompactReporter::kJsonLines
+                    : scram::CompactReporter::kColumnar;
+  std::unique_ptr<scram::CompactReporter> reporter =
+      scram::CompactReporter::Create(
+          format, std::as_const(*analysis).settings().probability_analysis(),
+          vm.count("output")
+              ? scram::xml::Output::Open(vm["output"].as<std::string>(),
+                                         /*background=*/true)
+              : scram::xml::Output::Open(stdout));
+  if (vm.count("stream-report")) {
+    analysis->Analyze(reporter.get());
+  } else {
+    analysis->Analyze();
+    reporter->Report(*analysis);
+  }
+  try {
+    reporter->Finish();
+  } catch (scram::IOError& err) {
+    if (vm.count("output"))
+      err << boost::errinfo_file_name(vm["output"].as<std::string>());
+    throw;
+  }
+}
+
 /// Main body of command-line entrance to run the program.
 ///
 /// @param[in] vm  Variables map of program options.
@@ -261,12 +357,34 @@ void RunScram(const po::variables_map& vm) {
     auto cmd_input = vm["input-files"].as<std::vector<std::string>>();
     input_files.insert(input_files.end(), cmd_input.begin(), cmd_input.end());
   }
+  if (vm.count("trace-file"))
+    scram::Tracer::Start();
+  // The timeline is written even if the analysis fails.
+  SCOPE_EXIT([&vm] {
+    if (!vm.count("trace-file"))
+      return;
+    try {
+      scram::Tracer::Write(vm["trace-file"].as<std::string>());
+    } catch (const scram::IOError& err) {
+      LOG(scram::ERROR) << err.what();
+    }
+  });
   // Process input files
   // into valid analysis containers and constructs.
   // Throws if anything is invalid.
   std::unique_ptr<scram::mef::Model> model =
-      scram::mef::Initializer(input_files, settings, vm.count("allow-extern"))
-          .model();
+      vm.count("snapshot")
+          ? scram::mef::Initializer(
+                scram::mef::Snapshot::Read(vm["snapshot"].as<std::string>()),
+                settings, vm.count("allow-extern"))
+                .model()
+          : scram::mef::Initializer(input_files, settings,
+                                    vm.count("allow-extern"))
+                .model();
+  if (vm.count("save-snapshot")) {
+    scram::mef::Snapshot::Write(input_files,
+                                vm["save-snapshot"].as<std::string>());
+  }
 #ifndef NDEBUG
   if (vm.count("serialize"))
     return Serialize(*model, stdout);
@@ -275,14 +393,40 @@ void RunScram(const po::variables_map& vm) {
     return;  // Stop if only validation is requested.
 
   // Initiate risk analysis with the given information.
+  scram::core::Progress progress([](const scram::core::Progress::Status& s) {
+    LOG(scram::INFO) << "Progress of " << s.stage << ": " << s.completed << "/"
+                     << s.total << " in " << s.elapsed << "s";
+  });
+  settings.progress(&progress);
+  // Termination requests (e.g., scheduler timeouts) cancel the analysis.
+  g_progress = &progress;
+  SCOPE_EXIT([] { g_progress = nullptr; });
+  std::signal(SIGINT, CancelAnalysis);
+  std::signal(SIGTERM, CancelAnalysis);
   scram::core::RiskAnalysis analysis(model.get(), settings);
-  analysis.Analyze();
-#ifndef NDEBUG
-  if (vm.count("no-report") || vm.count("preprocessor") || vm.count("print"))
-    return;
-#endif
   scram::Reporter reporter;
   bool indent = vm.count("no-indent") ? false : true;
+  bool no_report = false;
+#ifndef NDEBUG
+  no_report =
+      vm.count("no-report") || vm.count("preprocessor") || vm.count("print");
+#endif
+  if (vm.count("report-format") &&
+      vm["report-format"].as<std::string>() != "xml") {
+    ReportCompact(&analysis, vm, no_report);
+    return;
+  }
+  if (vm.count("stream-report") && !no_report) {
+    if (vm.count("output")) {
+      reporter.Stream(&analysis, vm["output"].as<std::string>(), indent);
+    } else {
+      reporter.Stream(&analysis, stdout, indent);
+    }
+    return;
+  }
+  analysis.Analyze();
+  if (no_report)
+    return;
   if (vm.count("output")) {
     reporter.Report(analysis, vm["output"].as<std::string>(), indent);
   } else {
@@ -104,6 +104,16 @@ Settings& Settings::cut_off(double prob) {
   return *this;
 }
 
+Settings& Settings::cache_verification(double fraction) {
+  if (fraction < 0 || fraction > 1)
+    SCRAM_THROW(SettingsError(
+        "The cache verification fraction must be in the [0, 1] range."))
+        << errinfo_value(std::to_string(fraction));
+
+  cache_verification_ = fraction;
+  return *this;
+}
+
 Settings& Settings::num_trials(int n) {
   if (n < 1)
     SCRAM_THROW(SettingsError("The number of trials cannot be less than 1."))
@@ -140,6 +150,25 @@ Settings& Settings::seed(int s) {
   return *this;
 }
 
+Settings& Settings::rng_engine(std::string_view value) {
+  auto it = boost::find(kRngEngineToString, value);
+  if (it == std::end(kRngEngineToString))
+    SCRAM_THROW(SettingsError("The random number engine is not recognized."))
+        << errinfo_value(std::string(value));
+
+  return rng_engine(
+      static_cast<RngEngine>(std::distance(kRngEngineToString, it)));
+}
+
+Settings& Settings::num_threads(int n) {
+  if (n < 1)
+    SCRAM_THROW(SettingsError("The number of threads cannot be less than 1."))
+        << errinfo_value(std::to_string(n));
+
+  num_threads_ = n;
+  return *this;
+}
+
 Settings& Settings::mission_time(double time) {
   if (time < 0)
     SCRAM_THROW(SettingsError("The mission time cannot be negative."))
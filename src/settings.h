@@ -22,7 +22,10 @@
 
 #include <cstdint>
 
+#include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 namespace scram::core {
 
@@ -38,9 +41,18 @@ enum class Approximation : std::uint8_t { kNone = 0, kRareEvent, kMcub };
 /// String representations for approximations.
 const char* const kApproximationToString[] = {"none", "rare-event", "mcub"};
 
+/// Random number engines for Monte Carlo simulations.
+enum class RngEngine : std::uint8_t { kMt19937 = 0, kPhilox };
+
+/// String representations for random number engines.
+const char* const kRngEngineToString[] = {"mt19937", "philox"};
+
+class Progress;
+
 /// Builder for analysis settings.
 /// Analysis facilities are guaranteed not to throw or fail
-/// with an instance of this class.
+/// with an instance of this class
+/// except for the cancellation requested through the progress channel.
 ///
 /// @warning Some settings with defaults and constraints
 ///          may have side-effects on other settings.
@@ -179,6 +191,38 @@ class Settings {
   /// @throws SettingsError  The number is negative.
   Settings& seed(int s);
 
+  /// @returns The engine of the pseudo-random number generator.
+  RngEngine rng_engine() const { return rng_engine_; }
+
+  /// Sets the engine of the pseudo-random number generator.
+  /// The counter-based Philox engine makes samples reproducible
+  /// regardless of the sampling order or partitioning of trials.
+  ///
+  /// @param[in] value  The engine kind.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The engine is not recognized.
+  /// @{
+  Settings& rng_engine(RngEngine value) noexcept {
+    rng_engine_ = value;
+    return *this;
+  }
+  Settings& rng_engine(std::string_view value);
+  /// @}
+
+  /// @returns The number of threads to analyze independent targets.
+  int num_threads() const { return num_threads_; }
+
+  /// Sets the number of threads for concurrent analyses of targets.
+  ///
+  /// @param[in] n  A natural number for the number of threads.
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The number is less than 1.
+  Settings& num_threads(int n);
+
   /// @returns The length time of the system under risk.
   double mission_time() const { return mission_time_; }
 
@@ -287,6 +331,83 @@ class Settings {
     return *this;
   }
 
+  /// @returns true if event-tree sequences share a single BDD.
+  bool shared_bdd() const { return shared_bdd_; }
+
+  /// Sets the flag to analyze all the sequences of an event tree
+  /// with a single BDD holding every sequence as a root function.
+  /// The common fault trees of the sequences are converted only once;
+  /// however, only the exact probabilities of the sequences are calculated.
+  ///
+  /// @param[in] flag  True or false for turning on or off the sharing.
+  ///
+  /// @returns Reference to this object.
+  Settings& shared_bdd(bool flag) {
+    shared_bdd_ = flag;
+    return *this;
+  }
+
+  /// @returns The directory of the persistent result cache.
+  ///          Empty if the results are not cached.
+  const std::string& cache_directory() const { return cache_directory_; }
+
+  /// Sets the directory to persist the results of analysis targets
+  /// between runs.
+  /// The results of unchanged targets are restored from the cache
+  /// instead of being recomputed.
+  ///
+  /// @param[in] path  The directory path or an empty string to disable.
+  ///
+  /// @returns Reference to this object.
+  Settings& cache_directory(std::string path) {
+    cache_directory_ = std::move(path);
+    return *this;
+  }
+
+  /// @returns The fraction of cache hits to verify by recomputation.
+  double cache_verification() const { return cache_verification_; }
+
+  /// Sets the fraction of the result cache hits
+  /// to be recomputed and compared with the cached results.
+  ///
+  /// @param[in] fraction  The fraction of hits in [0, 1].
+  ///
+  /// @returns Reference to this object.
+  ///
+  /// @throws SettingsError  The fraction is not in the [0, 1] range.
+  Settings& cache_verification(double fraction);
+
+  /// @returns The ids of the gates and the names of the initiating events
+  ///          to analyze instead of the whole model.
+  const std::vector<std::string>& targets() const { return targets_; }
+
+  /// Restricts the model to the given analysis targets.
+  /// Only the elements reachable from the targets
+  /// are defined, validated, and analyzed.
+  ///
+  /// @param[in] names  The gate ids or initiating event names.
+  ///                   Empty for the whole model.
+  ///
+  /// @returns Reference to this object.
+  Settings& targets(std::vector<std::string> names) {
+    targets_ = std::move(names);
+    return *this;
+  }
+
+  /// @returns The optional channel for progress reports and cancellation.
+  Progress* progress() const { return progress_; }
+
+  /// Sets the channel for the analyses to report their progress
+  /// and to poll the cancellation requests.
+  ///
+  /// @param[in] progress  The channel outliving the analyses or nullptr.
+  ///
+  /// @returns Reference to this object.
+  Settings& progress(Progress* progress) {
+    progress_ = progress;
+    return *this;
+  }
+
 #ifndef NDEBUG
   bool preprocessor = false;  ///< Stop analysis after preprocessor.
   bool print = false;  ///< Print analysis results in a terminal friendly way.
@@ -298,6 +419,7 @@ class Settings {
   bool importance_analysis_ = false;  ///< A flag for importance analysis.
   bool uncertainty_analysis_ = false;  ///< A flag for uncertainty analysis.
   bool ccf_analysis_ = false;  ///< A flag for common-cause analysis.
+  bool shared_bdd_ = false;  ///< A flag for the BDD shared by sequences.
   bool prime_implicants_ = false;  ///< Calculation of prime implicants.
   /// Qualitative analysis algorithm.
   Algorithm algorithm_ = Algorithm::kBdd;
@@ -305,12 +427,19 @@ class Settings {
   Approximation approximation_ = Approximation::kNone;
   int limit_order_ = 20;  ///< Limit on the order of products.
   int seed_ = 0;  ///< The seed for the pseudo-random number generator.
+  /// The engine of the pseudo-random number generator.
+  RngEngine rng_engine_ = RngEngine::kMt19937;
+  int num_threads_ = 1;  ///< The number of threads for analyses.
   int num_trials_ = 1e3;  ///< The number of trials for Monte Carlo simulations.
   int num_quantiles_ = 20;  ///< The number of quantiles for distributions.
   int num_bins_ = 20;  ///< The number of bins for histograms.
   double mission_time_ = 8760;  ///< System mission time.
   double time_step_ = 0;  ///< The time step for probability analyses.
   double cut_off_ = 1e-8;  ///< The cut-off probability for products.
+  std::string cache_directory_;  ///< The persistent result cache location.
+  double cache_verification_ = 0;  ///< The fraction of hits to verify.
+  std::vector<std::string> targets_;  ///< The optional analysis targets.
+  Progress* progress_ = nullptr;  ///< The optional progress channel.
 };
 
 }  // namespace scram::core
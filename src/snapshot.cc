@@ -0,0 +1,411 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the binary snapshots of validated model input.
+
+#include "snapshot.h"
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+#include <boost/exception/errinfo_errno.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/exception/errinfo_file_open_mode.hpp>
+
+#include "env.h"
+#include "error.h"
+#include "logger.h"
+
+namespace scram::mef {
+
+namespace {
+
+const char kMagic[8] = "SCRAMSN";  ///< The signature of the snapshot files.
+const std::uint32_t kVersion = 1;  ///< The version of the snapshot format.
+/// The absent node, text, or sibling.
+const std::uint32_t kNil = std::numeric_limits<std::uint32_t>::max();
+
+/// The leading record of the snapshot.
+/// The offsets of the sections are relative to the beginning of the snapshot.
+struct Header {
+  char magic[8];  ///< The snapshot file signature.
+  std::uint32_t version;  ///< The snapshot format version.
+  std::uint32_t num_documents;  ///< The number of the input documents.
+  std::uint64_t schema;  ///< The hash of the input schema.
+  std::uint64_t checksum;  ///< The checksum of the data after the header.
+  std::uint64_t size;  ///< The size of the whole snapshot.
+  std::uint32_t nodes;  ///< The offset of the node records.
+  std::uint32_t num_nodes;  ///< The number of the node records.
+  std::uint32_t attributes;  ///< The offset of the attribute records.
+  std::uint32_t num_attributes;  ///< The number of the attribute records.
+  std::uint32_t strings;  ///< The offset of the string pool.
+  std::uint32_t strings_size;  ///< The size of the string pool.
+};
+
+/// The input document with its root node index.
+struct DocumentRecord {
+  std::uint32_t url;  ///< The string offset of the original file path.
+  std::uint32_t root;  ///< The index of the root element node.
+};
+
+/// The XML element with its children linked by the node indices.
+struct NodeRecord {
+  std::uint32_t name;  ///< The string offset of the element name.
+  std::uint32_t text;  ///< The string offset of the text or kNil.
+  std::uint32_t line;  ///< The line number in the original file.
+  std::uint32_t attributes;  ///< The index of the first attribute.
+  std::uint32_t num_attributes;  ///< The number of the attributes.
+  std::uint32_t first_child;  ///< The index of the first child or kNil.
+  std::uint32_t next_sibling;  ///< The index of the next sibling or kNil.
+};
+
+/// The XML attribute of an element.
+struct AttributeRecord {
+  std::uint32_t name;  ///< The string offset of the attribute name.
+  std::uint32_t value;  ///< The string offset of the attribute value.
+};
+
+/// @returns The FNV-1a hash of the raw memory block.
+std::uint64_t Hash(const char* data, std::size_t size) noexcept {
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for (std::size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+/// @returns The hash of the input schema contents.
+///
+/// @throws IOError  The schema file is not accessible.
+std::uint64_t SchemaHash() {
+  static const std::uint64_t hash = [] {
+    std::ifstream schema(env::input_schema(), std::ios::binary);
+    if (!schema) {
+      SCRAM_THROW(IOError("Cannot read the input schema."))
+          << boost::errinfo_file_name(env::input_schema());
+    }
+    std::string contents(std::istreambuf_iterator<char>(schema), {});
+    return Hash(contents.data(), contents.size());
+  }();
+  return hash;
+}
+
+/// Encoder of validated documents into the snapshot records.
+class Encoder {
+ public:
+  Encoder() { strings_.push_back('\0'); }  // Never an empty pool.
+
+  /// Adds the document into the snapshot.
+  void operator()(const xml::Document& document) {
+    xml::Element root = document.root();
+    documents_.push_back({Intern(root.filename()), Encode(root)});
+  }
+
+  /// Writes the snapshot into the file.
+  ///
+  /// @throws IOError  The snapshot is too large for the format.
+  void Write(std::FILE* file) const {
+    Header header = {};
+    std::copy(std::begin(kMagic), std::end(kMagic), header.magic);
+    header.version = kVersion;
+    header.num_documents = documents_.size();
+    header.schema = SchemaHash();
+    std::size_t offset = sizeof(header) + Size(documents_);
+    header.nodes = Offset(offset);
+    header.num_nodes = nodes_.size();
+    offset += Size(nodes_);
+    header.attributes = Offset(offset);
+    header.num_attributes = attributes_.size();
+    offset += Size(attributes_);
+    header.strings = Offset(offset);
+    header.strings_size = Offset(strings_.size());
+    header.size = offset + strings_.size();
+
+    std::string data;
+    data.reserve(header.size - sizeof(header));
+    auto append = [&data](const auto& records) {
+      data.append(reinterpret_cast<const char*>(records.data()),
+                  Size(records));
+    };
+    append(documents_);
+    append(nodes_);
+    append(attributes_);
+    data += strings_;
+    header.checksum = Hash(data.data(), data.size());
+
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1 ||
+        std::fwrite(data.data(), 1, data.size(), file) != data.size()) {
+      SCRAM_THROW(IOError("Failed to write the snapshot."))
+          << boost::errinfo_errno(errno);
+    }
+  }
+
+ private:
+  /// @returns The size of the records in bytes.
+  template <class T>
+  static std::size_t Size(const std::vector<T>& records) {
+    return records.size() * sizeof(T);
+  }
+
+  /// @returns The offset representation in the snapshot format.
+  ///
+  /// @throws IOError  The offset is too large for the format.
+  static std::uint32_t Offset(std::size_t offset) {
+    if (offset >= kNil)
+      SCRAM_THROW(IOError("The model is too large for the snapshot."));
+    return offset;
+  }
+
+  /// @returns The offset of the string in the deduplicated pool.
+  std::uint32_t Intern(std::string_view value) {
+    auto [it, is_new] =
+        offsets_.emplace(std::string(value), Offset(strings_.size()));
+    if (is_new)
+      strings_.append(value.data(), value.size()).push_back('\0');
+    return it->second;
+  }
+
+  /// @returns The index of the encoded element node.
+  std::uint32_t Encode(const xml::Element& element) {
+    std::uint32_t index = Offset(nodes_.size());
+    NodeRecord record = {};
+    record.name = Intern(element.name());
+    record.line = element.line();
+    record.attributes = Offset(attributes_.size());
+    record.first_child = record.next_sibling = record.text = kNil;
+    for (const xmlAttr* attribute = element.get()->properties; attribute;
+         attribute = attribute->next) {
+      const xmlNode* value = attribute->children;
+      attributes_.push_back(
+          {Intern(xml::detail::from_utf8(attribute->name)),
+           Intern(value && value->content
+                      ? xml::detail::from_utf8(value->content)
+                      : "")});
+    }
+    record.num_attributes = attributes_.size() - record.attributes;
+    nodes_.push_back(record);
+
+    std::uint32_t last_child = kNil;
+    for (const xml::Element& child : element.children()) {
+      std::uint32_t child_index = Encode(child);
+      (last_child == kNil ? nodes_[index].first_child
+                          : nodes_[last_child].next_sibling) = child_index;
+      last_child = child_index;
+    }
+    if (last_child == kNil) {  // Only leaf elements carry text in MEF.
+      for (const xmlNode* node = element.get()->children; node;
+           node = node->next) {
+        if (node->type == XML_TEXT_NODE) {
+          nodes_[index].text = Intern(element.text());
+          break;
+        }
+      }
+    }
+    return index;
+  }
+
+  std::vector<DocumentRecord> documents_;  ///< The encoded documents.
+  std::vector<NodeRecord> nodes_;  ///< The elements in the pre-order.
+  std::vector<AttributeRecord> attributes_;  ///< The element attributes.
+  std::string strings_;  ///< The pool of null-terminated strings.
+  /// The offsets of the strings in the pool.
+  std::unordered_map<std::string, std::uint32_t> offsets_;
+};
+
+/// Decoder of the snapshot records into DOM documents.
+class Decoder {
+ public:
+  /// @param[in] data  The verified snapshot block.
+  explicit Decoder(const char* data)
+      : header_(*reinterpret_cast<const Header*>(data)),
+        documents_(reinterpret_cast<const DocumentRecord*>(data +
+                                                           sizeof(Header))),
+        nodes_(reinterpret_cast<const NodeRecord*>(data + header_.nodes)),
+        attributes_(
+            reinterpret_cast<const AttributeRecord*>(data + header_.attributes)),
+        strings_(data + header_.strings) {}
+
+  /// @returns The rebuilt document.
+  ///
+  /// @throws IOError  The records are inconsistent.
+  xml::Document operator()(std::uint32_t index) const {
+    const DocumentRecord& record = documents_[index];
+    xml::Document document(xmlNewDoc(xml::detail::to_utf8("1.0")));
+    xmlDoc* doc = document.get();
+    doc->dict = xmlDictCreate();  // The element and attribute names.
+    doc->URL = xmlStrdup(String(record.url));
+    xmlNode* root = NewNode(doc, record.root);
+    xmlDocSetRootElement(doc, root);
+    Decode(doc, root, record.root);
+    return document;
+  }
+
+ private:
+  /// @returns The verified node record.
+  const NodeRecord& Node(std::uint32_t index) const {
+    if (index >= header_.num_nodes)
+      SCRAM_THROW(IOError("Inconsistent snapshot node records."));
+    return nodes_[index];
+  }
+
+  /// @returns The verified string from the pool.
+  const xmlChar* String(std::uint32_t offset) const {
+    if (offset >= header_.strings_size)
+      SCRAM_THROW(IOError("Inconsistent snapshot string records."));
+    return xml::detail::to_utf8(strings_ + offset);
+  }
+
+  /// @returns The new element node with its text but without attributes.
+  xmlNode* NewNode(xmlDoc* doc, std::uint32_t index) const {
+    const NodeRecord& record = Node(index);
+    const xmlChar* name = String(record.name);
+    const xmlChar* text = record.text == kNil ? nullptr : String(record.text);
+    xmlNode* node = xmlNewDocRawNode(doc, nullptr, name, text);
+    node->line = std::min<std::uint32_t>(
+        record.line, std::numeric_limits<unsigned short>::max());
+    return node;
+  }
+
+  /// Adds the attributes and child elements
+  /// into the node already owned by the document.
+  void Decode(xmlDoc* doc, xmlNode* node, std::uint32_t index) const {
+    const NodeRecord& record = nodes_[index];
+    if (record.num_attributes > header_.num_attributes ||
+        record.attributes > header_.num_attributes - record.num_attributes) {
+      SCRAM_THROW(IOError("Inconsistent snapshot attribute records."));
+    }
+    for (std::uint32_t i = 0; i < record.num_attributes; ++i) {
+      const AttributeRecord& attribute = attributes_[record.attributes + i];
+      xmlNewProp(node, String(attribute.name), String(attribute.value));
+    }
+    // The children follow their parent and each other in the pre-order.
+    for (std::uint32_t child = record.first_child, next = index + 1;
+         child != kNil; next = child + 1, child = nodes_[child].next_sibling) {
+      if (child < next)
+        SCRAM_THROW(IOError("Inconsistent snapshot node records."));
+      Decode(doc, xmlAddChild(node, NewNode(doc, child)), child);
+    }
+  }
+
+  const Header& header_;  ///< The verified snapshot header.
+  const DocumentRecord* documents_;  ///< The document records.
+  const NodeRecord* nodes_;  ///< The element records in the pre-order.
+  const AttributeRecord* attributes_;  ///< The attribute records.
+  const char* strings_;  ///< The null-terminated string pool.
+};
+
+}  // namespace
+
+void Snapshot::Write(const std::vector<std::string>& xml_files,
+                     const std::string& file) {
+  static xml::Validator validator(env::input_schema());
+
+  TIMER(DEBUG1, "Writing the snapshot");
+  Encoder encoder;
+  for (const std::string& xml_file : xml_files)
+    encoder(xml::Document(xml_file, &validator));
+
+  // The snapshot is renamed into place only after it is complete.
+  std::string temp_file = file + ".tmp";
+  std::unique_ptr<std::FILE, decltype(&std::fclose)> fp(
+      std::fopen(temp_file.c_str(), "wb"), &std::fclose);
+  try {
+    if (!fp) {
+      SCRAM_THROW(IOError("Cannot open the snapshot file for writing."))
+          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("wb");
+    }
+    encoder.Write(fp.get());
+    if (std::fclose(fp.release()) ||
+        std::rename(temp_file.c_str(), file.c_str())) {
+      SCRAM_THROW(IOError("Failed to write the snapshot."))
+          << boost::errinfo_errno(errno);
+    }
+  } catch (IOError& err) {
+    fp.reset();
+    std::remove(temp_file.c_str());
+    err << boost::errinfo_file_name(file);
+    throw;
+  }
+}
+
+Snapshot Snapshot::Read(const std::string& file) {
+  Snapshot snapshot(file, MappedFile(file));
+  try {
+    snapshot.Check();
+  } catch (Error& err) {
+    err << boost::errinfo_file_name(file);
+    throw;
+  }
+  return snapshot;
+}
+
+void Snapshot::Check() const {
+  std::size_t size = data_.size();
+  if (size < sizeof(Header))
+    SCRAM_THROW(IOError("Truncated snapshot file."));
+  const Header& header = *reinterpret_cast<const Header*>(data_.data());
+  if (!std::equal(std::begin(kMagic), std::end(kMagic), header.magic))
+    SCRAM_THROW(IOError("The file is not a SCRAM snapshot."));
+  if (header.version != kVersion)
+    SCRAM_THROW(VersionError("Incompatible snapshot format version."));
+  if (header.schema != SchemaHash())
+    SCRAM_THROW(VersionError("The snapshot is for another input schema."));
+  if (header.size != size ||
+      header.checksum != Hash(data_.data() + sizeof(header),
+                              size - sizeof(header))) {
+    SCRAM_THROW(IOError("Corrupted snapshot file."));
+  }
+  // The sections must be in the order of the writer.
+  if (header.nodes != sizeof(header) + sizeof(DocumentRecord) *
+                                           std::size_t(header.num_documents) ||
+      header.attributes !=
+          header.nodes + sizeof(NodeRecord) * std::size_t(header.num_nodes) ||
+      header.strings != header.attributes + sizeof(AttributeRecord) *
+                                                std::size_t(
+                                                    header.num_attributes) ||
+      header.strings + std::size_t(header.strings_size) != size ||
+      !header.strings_size || data_.data()[size - 1] != '\0') {
+    SCRAM_THROW(IOError("Inconsistent snapshot sections."));
+  }
+}
+
+std::vector<xml::Document> Snapshot::documents() const {
+  TIMER(DEBUG2, "Loading the snapshot documents");
+  const Header& header = *reinterpret_cast<const Header*>(data_.data());
+  Decoder decode(data_.data());
+  std::vector<xml::Document> documents;
+  try {
+    for (std::uint32_t i = 0; i < header.num_documents; ++i)
+      documents.push_back(decode(i));
+  } catch (IOError& err) {
+    err << boost::errinfo_file_name(file_);
+    throw;
+  }
+  return documents;
+}
+
+}  // namespace scram::mef
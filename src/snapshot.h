@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Binary snapshots of validated model input.
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mapped_file.h"
+#include "xml.h"
+
+namespace scram::mef {
+
+/// Compact binary image of the validated MEF input documents
+/// with all XInclude directives resolved.
+///
+/// The snapshot is a single block of records and deduplicated strings
+/// addressed with offsets relative to the start of the block,
+/// so the file is used in place after memory mapping.
+/// Loading the snapshot skips the XML parsing and schema validation,
+/// and the model built from it skips the validation of its structure.
+/// The checks depending on the analysis settings still run
+/// (e.g., the expression domains with the mission time).
+///
+/// @note The snapshot is versioned with its format and the input schema.
+class Snapshot {
+ public:
+  /// Writes the snapshot of the input files.
+  ///
+  /// @param[in] xml_files  The MEF XML input files of a valid model.
+  /// @param[in] file  The destination file for the snapshot.
+  ///
+  /// @throws IOError  The input files or the destination are not accessible.
+  /// @throws xml::Error  The input files are malformed or invalid.
+  ///
+  /// @pre The input files have been successfully initialized into a model.
+  static void Write(const std::vector<std::string>& xml_files,
+                    const std::string& file);
+
+  /// Maps the snapshot file into memory.
+  ///
+  /// @param[in] file  The snapshot file.
+  ///
+  /// @returns The verified snapshot.
+  ///
+  /// @throws IOError  The file is not accessible or corrupted.
+  /// @throws VersionError  The snapshot format or the input schema differ.
+  static Snapshot Read(const std::string& file);
+
+  /// @returns The input documents rebuilt from the snapshot
+  ///          in the order of the original input files.
+  ///
+  /// @throws IOError  The snapshot records are inconsistent.
+  std::vector<xml::Document> documents() const;
+
+ private:
+  /// @param[in] file  The snapshot file path for error messages.
+  /// @param[in] data  The contents of the snapshot file.
+  Snapshot(std::string file, MappedFile data)
+      : file_(std::move(file)), data_(std::move(data)) {}
+
+  /// Verifies the snapshot header and the checksum of the data.
+  ///
+  /// @throws IOError  The file is not a snapshot or corrupted.
+  /// @throws VersionError  The snapshot format or the input schema differ.
+  void Check() const;
+
+  std::string file_;  ///< The snapshot file for error messages.
+  MappedFile data_;  ///< The snapshot block.
+};
+
+}  // namespace scram::mef
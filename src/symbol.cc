@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the interned string table.
+
+#include "symbol.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace scram::mef {
+
+namespace {
+
+/// The storage of the interned strings.
+struct Table {
+  std::mutex mutex;  ///< Serializes the interning from multiple threads.
+  /// The chunked storage with stable addresses.
+  /// Short strings are kept entirely within the chunks.
+  std::deque<Symbol::Data> strings;
+  /// The interned strings keyed by their own views.
+  std::unordered_map<std::string_view, const Symbol::Data*> index;
+};
+
+/// @returns The table alive even for elements with static storage.
+Table& GetTable() {
+  static Table* table = new Table;  // Never destroyed.
+  return *table;
+}
+
+}  // namespace
+
+Symbol Symbol::Intern(std::string_view value) {
+  Table& table = GetTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  if (auto it = table.index.find(value); it != table.index.end())
+    return Symbol(it->second);
+  std::uint32_t id = table.strings.size() + 1;
+  const Data& data = table.strings.emplace_back(Data{std::string(value), id});
+  table.index.emplace(data.value, &data);
+  return Symbol(&data);
+}
+
+Symbol::Symbol(std::string_view value) {
+  Table& table = GetTable();
+  std::lock_guard<std::mutex> lock(table.mutex);
+  if (auto it = table.index.find(value); it != table.index.end())
+    data_ = it->second;
+}
+
+}  // namespace scram::mef
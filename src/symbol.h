@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Interned strings with dense integer identifiers.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace scram::mef {
+
+/// Handle to a unique immutable string interned in the process-wide table.
+///
+/// Element names, ids, and paths repeat across the model
+/// (e.g., all elements of a fault tree share the same base path).
+/// The interned strings are stored once in chunks of the table
+/// and are referenced by the elements instead of being owned by each.
+/// Every interned string gets a dense integer id,
+/// so tables keyed by symbols hash and compare integers instead of strings.
+///
+/// The explicit conversions from strings only look up the existing symbols
+/// for table keys; only Intern adds new strings into the table.
+/// Lookups by strings should convert once
+/// since every conversion searches the table under its lock.
+///
+/// @note The interned strings are never released.
+/// @note The table is safe to use from multiple threads.
+class Symbol {
+ public:
+  /// The interned string with its id.
+  struct Data {
+    std::string value;  ///< The unique string.
+    std::uint32_t id;  ///< The dense id starting from 1.
+  };
+
+  /// @param[in] value  The string to intern.
+  ///
+  /// @returns The unique symbol of the value
+  ///          with the string address stable until the program exit.
+  static Symbol Intern(std::string_view value);
+
+  /// Constructs the null symbol that never matches interned strings.
+  Symbol() = default;
+
+  /// Finds the symbol of the string without interning it.
+  ///
+  /// @param[in] value  The string to look up.
+  ///
+  /// @post The symbol is null if the value has never been interned.
+  ///
+  /// @{
+  explicit Symbol(std::string_view value);
+  explicit Symbol(const std::string& value)
+      : Symbol(std::string_view(value)) {}
+  explicit Symbol(const char* value) : Symbol(std::string_view(value)) {}
+  /// @}
+
+  /// @returns The interned string or empty string for the null symbol.
+  const std::string& str() const {
+    static const std::string empty;
+    return data_ ? data_->value : empty;
+  }
+
+  /// @returns The dense id of the symbol or 0 for the null symbol.
+  std::uint32_t id() const { return data_ ? data_->id : 0; }
+
+  /// @returns true for symbols of interned strings.
+  explicit operator bool() const { return data_; }
+
+  /// Symbols are equal only if their interned strings are equal.
+  /// @{
+  friend bool operator==(Symbol lhs, Symbol rhs) {
+    return lhs.data_ == rhs.data_;
+  }
+  friend bool operator!=(Symbol lhs, Symbol rhs) { return !(lhs == rhs); }
+  /// @}
+
+  /// Orders symbols by their ids, i.e., not lexicographically.
+  friend bool operator<(Symbol lhs, Symbol rhs) { return lhs.id() < rhs.id(); }
+
+ private:
+  /// @param[in] data  The interned string.
+  explicit Symbol(const Data* data) : data_(data) {}
+
+  const Data* data_ = nullptr;  ///< The interned string or nullptr.
+};
+
+}  // namespace scram::mef
+
+namespace std {
+
+/// Hashing of symbols by their dense ids.
+template <>
+struct hash<scram::mef::Symbol> {
+  /// @returns The symbol id as the hash value.
+  std::size_t operator()(scram::mef::Symbol symbol) const noexcept {
+    return symbol.id();
+  }
+};
+
+}  // namespace std
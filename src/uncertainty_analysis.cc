@@ -30,8 +30,9 @@
 #include <boost/accumulators/statistics/variance.hpp>
 
 #include "event.h"
-#include "expression.h"
+#include "expression/tape.h"
 #include "logger.h"
+#include "resources.h"
 
 namespace scram::core {
 
@@ -42,8 +43,10 @@ UncertaintyAnalysis::UncertaintyAnalysis(
       sigma_(0),
       error_factor_(1) {}
 
-void UncertaintyAnalysis::Analyze() noexcept {
+void UncertaintyAnalysis::Analyze() {
   CLOCK(analysis_time);
+  TRACE("Uncertainty analysis");
+  ResourceMeter meter(&Analysis::resources());
   CLOCK(sample_time);
   LOG(DEBUG3) << "Sampling probabilities...";
   // Sample probabilities and generate data.
@@ -58,29 +61,32 @@ void UncertaintyAnalysis::Analyze() noexcept {
   Analysis::AddAnalysisTime(DUR(analysis_time));
 }
 
-std::vector<std::pair<int, mef::Expression&>>
-UncertaintyAnalysis::GatherDeviateExpressions(const Pdag* graph) noexcept {
-  std::vector<std::pair<int, mef::Expression&>> deviate_expressions;
+void UncertaintyAnalysis::GatherDeviateExpressions(
+    const Pdag* graph) noexcept {
+  std::vector<mef::Expression*> deviate_expressions;
+  deviate_variables_.clear();
   int index = Pdag::kVariableStartIndex;
   for (const mef::BasicEvent* event : graph->basic_events()) {
-    if (event->expression().IsDeviate())
-      deviate_expressions.emplace_back(index, event->expression());
+    if (event->expression().IsDeviate()) {
+      deviate_variables_.push_back(index);
+      deviate_expressions.push_back(&event->expression());
+    }
     ++index;
   }
-  return deviate_expressions;
+  deviate_tape_ = std::make_unique<mef::ExpressionTape>(deviate_expressions);
 }
 
-void UncertaintyAnalysis::SampleExpressions(
-    const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
-    Pdag::IndexMap<double>* p_vars) noexcept {
-  // Reset distributions.
-  for (const auto& expression : deviate_expressions)
-    expression.second.Reset();
-
-  // Sample all expressions with distributions.
-  for (const auto& expression : deviate_expressions) {
-    double prob = expression.second.Sample();
-    (*p_vars)[expression.first] = prob > 1 ? 1 : prob < 0 ? 0 : prob;
+void UncertaintyAnalysis::SampleExpressions(int num_trials,
+                                            int first_trial) noexcept {
+  assert(deviate_tape_ && "The deviate expressions are not gathered.");
+  deviate_tape_->Sample(num_trials, first_trial);
+}
+
+void UncertaintyAnalysis::LoadSampledExpressions(
+    int trial, Pdag::IndexMap<double>* p_vars) noexcept {
+  for (int i = 0; i < deviate_variables_.size(); ++i) {
+    double prob = deviate_tape_->value(i, trial);
+    (*p_vars)[deviate_variables_[i]] = prob > 1 ? 1 : prob < 0 ? 0 : prob;
   }
 }
 
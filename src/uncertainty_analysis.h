@@ -21,17 +21,16 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
 #include <utility>
 #include <vector>
 
 #include "analysis.h"
 #include "probability_analysis.h"
+#include "progress.h"
 #include "settings.h"
 
-namespace scram::mef {  // Decouple from the implementation dependence.
-class Expression;
-}  // namespace scram::mef
-
 namespace scram::core {
 
 /// Uncertainty analysis and statistics
@@ -51,7 +50,7 @@ class UncertaintyAnalysis : public Analysis {
   /// Performs quantitative analysis on the total probability.
   ///
   /// @note  Undefined behavior if analysis called two or more times.
-  void Analyze() noexcept;
+  void Analyze();
 
   /// @returns Mean of the final distribution.
   double mean() const { return mean_; }
@@ -76,21 +75,29 @@ class UncertaintyAnalysis : public Analysis {
   const std::vector<double>& quantiles() const { return quantiles_; }
 
  protected:
-  /// Gathers deviate expressions of variables.
+  /// The number of trials sampled at once by the expression tape.
+  static constexpr int kSampleBlockSize = 64;
+
+  /// Gathers deviate expressions of variables
+  /// and compiles them into a tape for sampling.
   ///
   /// @param[in] graph  PDAG with the variables.
+  void GatherDeviateExpressions(const Pdag* graph) noexcept;
+
+  /// Samples uncertain probabilities in a block of trials.
+  ///
+  /// @param[in] num_trials  The number of trials in the block.
+  /// @param[in] first_trial  The index of the first trial in the block.
   ///
-  /// @returns The gathered deviate expressions with variable indices.
-  std::vector<std::pair<int, mef::Expression&>>
-  GatherDeviateExpressions(const Pdag* graph) noexcept;
+  /// @pre The deviate expressions are gathered.
+  void SampleExpressions(int num_trials, int first_trial) noexcept;
 
-  /// Samples uncertain probabilities.
+  /// Loads the sampled probabilities of a trial from the last block.
   ///
-  /// @param[in] deviate_expressions  A collection of deviate expressions.
+  /// @param[in] trial  The trial index in the last sampled block.
   /// @param[in,out] p_vars  Indices to probabilities mapping with values.
-  void SampleExpressions(
-      const std::vector<std::pair<int, mef::Expression&>>& deviate_expressions,
-      Pdag::IndexMap<double>* p_vars) noexcept;
+  void LoadSampledExpressions(int trial,
+                              Pdag::IndexMap<double>* p_vars) noexcept;
 
  private:
   /// Performs Monte Carlo Simulation
@@ -98,7 +105,7 @@ class UncertaintyAnalysis : public Analysis {
   /// and providing the final sampled values of the final probability.
   ///
   /// @returns Sampled values.
-  virtual std::vector<double> Sample() noexcept = 0;
+  virtual std::vector<double> Sample() = 0;
 
   /// Calculates statistical values from the final distribution.
   ///
@@ -114,6 +121,10 @@ class UncertaintyAnalysis : public Analysis {
   std::vector<std::pair<double, double>> distribution_;
   /// The quantiles of the distribution.
   std::vector<double> quantiles_;
+  /// The indices of variables with deviate expressions.
+  std::vector<int> deviate_variables_;
+  /// The compiled deviate expressions in the order of the variables.
+  std::unique_ptr<mef::ExpressionTape> deviate_tape_;
 };
 
 /// Uncertainty analysis facility.
@@ -132,25 +143,32 @@ class UncertaintyAnalyzer : public UncertaintyAnalysis {
 
  private:
   /// @returns Samples of the total probability.
-  std::vector<double> Sample() noexcept override;
+  std::vector<double> Sample() override;
 
   /// Calculator of the total probability.
   ProbabilityAnalyzer<Calculator>* prob_analyzer_;
 };
 
 template <class Calculator>
-std::vector<double> UncertaintyAnalyzer<Calculator>::Sample() noexcept {
-  std::vector<std::pair<int, mef::Expression&>> deviate_expressions =
-      UncertaintyAnalysis::GatherDeviateExpressions(prob_analyzer_->graph());
+std::vector<double> UncertaintyAnalyzer<Calculator>::Sample() {
+  UncertaintyAnalysis::GatherDeviateExpressions(prob_analyzer_->graph());
   Pdag::IndexMap<double> p_vars = prob_analyzer_->p_vars();  // Private copy!
   std::vector<double> samples;
   samples.reserve(Analysis::settings().num_trials());
 
-  for (int i = 0; i < Analysis::settings().num_trials(); ++i) {
-    UncertaintyAnalysis::SampleExpressions(deviate_expressions, &p_vars);
-    double result = prob_analyzer_->CalculateTotalProbability(p_vars);
-    assert(result >= 0 && result <= 1);
-    samples.push_back(result);
+  for (int i = 0; i < Analysis::settings().num_trials();
+       i += kSampleBlockSize) {
+    int num_trials =
+        std::min(kSampleBlockSize, Analysis::settings().num_trials() - i);
+    ReportProgress(Analysis::settings().progress(), "uncertainty analysis", i,
+                   Analysis::settings().num_trials());
+    UncertaintyAnalysis::SampleExpressions(num_trials, i);
+    for (int trial = 0; trial < num_trials; ++trial) {
+      UncertaintyAnalysis::LoadSampledExpressions(trial, &p_vars);
+      double result = prob_analyzer_->CalculateTotalProbability(p_vars);
+      assert(result >= 0 && result <= 1);
+      samples.push_back(result);
+    }
   }
 
   return samples;
@@ -20,14 +20,37 @@
 
 #include "xml.h"
 
+#include <cerrno>
+#include <climits>
+
 #include <libxml/xinclude.h>
 
 namespace scram::xml {
 
+namespace {
+
+/// The parser options of the streaming reader.
+/// The blank text nodes are dropped
+/// because the extracted elements may be kept until the model is complete.
+const int kReaderOptions = kParserOptions | XML_PARSE_NOBLANKS;
+
+/// @returns true if the library can parse the file directly from memory.
+bool FitsMemoryParser(const MappedFile& input) {
+  return input.size() <= static_cast<std::size_t>(INT_MAX);
+}
+
+}  // namespace
+
 Document::Document(const std::string& file_path, Validator* validator)
     : doc_(nullptr, &xmlFreeDoc) {
   xmlResetLastError();
-  doc_.reset(xmlReadFile(file_path.c_str(), nullptr, kParserOptions));
+  {
+    MappedFile input(file_path);
+    doc_.reset(FitsMemoryParser(input)
+                   ? xmlReadMemory(input.data(), input.size(),
+                                   file_path.c_str(), nullptr, kParserOptions)
+                   : xmlReadFile(file_path.c_str(), nullptr, kParserOptions));
+  }
   xmlErrorPtr xml_error = xmlGetLastError();
   if (xml_error) {
     if (xml_error->domain == xmlErrorDomain::XML_FROM_IO) {
@@ -63,4 +86,230 @@ Validator::Validator(const std::string& rng_file)
     SCRAM_THROW(detail::GetError<LogicError>());
 }
 
+template <class F>
+int Reader::Call(F&& operation) {
+  void* context = xmlStructuredErrorContext;
+  xmlStructuredErrorFunc handler = xmlStructuredError;
+  xmlSetStructuredErrorFunc(this, &Reader::CaptureError);
+  int ret = operation();
+  xmlSetStructuredErrorFunc(context, handler);
+  CheckErrors(ret);
+  return ret;
+}
+
+Reader::Reader(const std::string& file_path, Validator* validator)
+    : file_path_(file_path),
+      input_(file_path),
+      reader_(nullptr, &xmlFreeTextReader),
+      document_(xmlNewDoc(detail::to_utf8("1.0"))) {
+  if (!document_.get())
+    SCRAM_THROW(LogicError("Failed to create an XML document."));
+  document_.get()->URL = xmlStrdup(detail::to_utf8(file_path.c_str()));
+  Call([this] {
+    reader_.reset(FitsMemoryParser(input_)
+                      ? xmlReaderForMemory(input_.data(), input_.size(),
+                                           file_path_.c_str(), nullptr,
+                                           kReaderOptions)
+                      : xmlReaderForFile(file_path_.c_str(), nullptr,
+                                         kReaderOptions));
+    return reader_ ? 0 : -1;
+  });
+  if (validator) {
+    if (xmlTextReaderRelaxNGSetSchema(reader_.get(), validator->schema_.get()))
+      SCRAM_THROW(LogicError("Failed to set the schema for the XML reader."));
+    validating_ = true;
+  }
+
+  do {
+    if (!Read()) {
+      SCRAM_THROW(ParseError("The document has no root element."))
+          << boost::errinfo_file_name(file_path_);
+    }
+  } while (xmlTextReaderNodeType(reader_.get()) != XML_READER_TYPE_ELEMENT);
+  current_ = true;
+  Enter();
+}
+
+Reader::~Reader() noexcept {
+  Release();
+  xmlResetError(&error_);
+  xmlResetError(&validity_error_);
+}
+
+std::optional<Element> Reader::Next() {
+  Release();
+  if (lookahead_) {
+    lookahead_ = false;
+    return Element(reinterpret_cast<const xmlElement*>(
+        xmlTextReaderCurrentNode(reader_.get())));
+  }
+  if (parents_.empty())
+    return {};  // The trailing misc nodes are irrelevant.
+  if (closing_) {
+    closing_ = false;
+    parents_.pop_back();
+    return {};
+  }
+  if (current_) {
+    current_ = false;
+    Skip();
+  }
+  int child_depth = parents_.size();
+  for (;;) {
+    if (pending_) {
+      pending_ = false;
+    } else if (!Read()) {
+      parents_.clear();
+      return {};
+    }
+    int depth = xmlTextReaderDepth(reader_.get());
+    int type = xmlTextReaderNodeType(reader_.get());
+    if (depth < child_depth && type == XML_READER_TYPE_END_ELEMENT) {
+      parents_.pop_back();
+      return {};
+    }
+    if (depth == child_depth && type == XML_READER_TYPE_ELEMENT) {
+      current_ = true;
+      return Element(reinterpret_cast<const xmlElement*>(
+          xmlTextReaderCurrentNode(reader_.get())));
+    }
+  }
+}
+
+Element Reader::Expand() {
+  assert(current_ && !lookahead_ && !expanded_ && "No element to expand.");
+  Call([this] {
+    expanded_ = xmlTextReaderExpand(reader_.get());
+    return expanded_ ? 0 : -1;
+  });
+  if (validating_) {
+    // The subtree is validated only upon skipping,
+    // which also releases the original nodes.
+    expanded_ = xmlDocCopyNode(expanded_, document_.get(), /*extended=*/1);
+    if (!expanded_)
+      SCRAM_THROW(LogicError("Failed to copy the XML element."));
+    copied_ = true;
+    current_ = false;
+    Skip();
+  }
+  return Element(reinterpret_cast<const xmlElement*>(expanded_));
+}
+
+Element Reader::Enter() {
+  assert(current_ && !lookahead_ && !expanded_ && "No element to enter.");
+  current_ = false;
+  // Only the attributes are copied.
+  xmlNode* node = xmlDocCopyNode(xmlTextReaderCurrentNode(reader_.get()),
+                                 document_.get(), /*extended=*/2);
+  if (!node)
+    SCRAM_THROW(LogicError("Failed to copy the XML element."));
+  if (parents_.empty()) {
+    xmlDocSetRootElement(document_.get(), node);
+  } else {
+    xmlAddChild(parents_.back(), node);
+  }
+  parents_.push_back(node);
+  if (xmlTextReaderIsEmptyElement(reader_.get())) {
+    closing_ = true;
+    return Element(reinterpret_cast<const xmlElement*>(node));
+  }
+  // The label and attributes precede the other child elements.
+  for (;;) {
+    std::optional<Element> child = Next();
+    if (!child) {
+      parents_.push_back(node);
+      closing_ = true;
+      break;
+    }
+    if (child->name() != "label" && child->name() != "attributes") {
+      lookahead_ = true;
+      break;
+    }
+    Expand();
+    Keep();
+  }
+  return Element(reinterpret_cast<const xmlElement*>(node));
+}
+
+Element Reader::Keep() {
+  assert(expanded_ && "No element to keep.");
+  xmlNode* node = copied_ ? expanded_
+                          : xmlDocCopyNode(expanded_, document_.get(),
+                                           /*extended=*/1);
+  if (!node)
+    SCRAM_THROW(LogicError("Failed to copy the XML element."));
+  xmlAddChild(parents_.back(), node);
+  expanded_ = nullptr;
+  copied_ = false;
+  return Element(reinterpret_cast<const xmlElement*>(node));
+}
+
+void Reader::Skip() {
+  // The library fails to skip the empty elements included with XInclude.
+  bool empty = xmlTextReaderIsEmptyElement(reader_.get()) == 1;
+  pending_ = Call([this, empty] {
+               return empty ? xmlTextReaderRead(reader_.get())
+                            : xmlTextReaderNext(reader_.get());
+             }) == 1;
+}
+
+void Reader::Release() noexcept {
+  if (copied_)
+    xmlFreeNode(expanded_);
+  expanded_ = nullptr;
+  copied_ = false;
+}
+
+bool Reader::Read() {
+  return Call([this] { return xmlTextReaderRead(reader_.get()); }) == 1;
+}
+
+void Reader::CaptureError(void* data, xmlErrorPtr error) noexcept {
+  auto* reader = static_cast<Reader*>(data);
+  if (error->level == XML_ERR_WARNING)
+    return;
+  xmlError* first = error->domain == XML_FROM_RELAXNGV
+                        ? &reader->validity_error_
+                        : &reader->error_;
+  if (first->code == XML_ERR_OK)
+    xmlCopyError(error, first);
+}
+
+void Reader::CheckErrors(int ret) {
+  if (ret < 0 || error_.code != XML_ERR_OK)
+    ThrowError(error_);
+  if (validating_ && (validity_error_.code != XML_ERR_OK ||
+                      xmlTextReaderIsValid(reader_.get()) == 0)) {
+    // Malformed documents are reported as such
+    // even if the validation fails before the malformation is reached.
+    xmlTextReaderRelaxNGSetSchema(reader_.get(), nullptr);
+    validating_ = false;
+    while (Call([this] { return xmlTextReaderRead(reader_.get()); }) == 1)
+      continue;
+    if (validity_error_.code == XML_ERR_OK) {
+      SCRAM_THROW(ValidityError("The document is not valid."))
+          << boost::errinfo_file_name(file_path_);
+    }
+    SCRAM_THROW(detail::GetError<ValidityError>(&validity_error_));
+  }
+}
+
+void Reader::ThrowError(const xmlError& error) const {
+  if (error.code == XML_ERR_OK) {
+    SCRAM_THROW(ParseError("Failed to read the document."))
+        << boost::errinfo_file_name(file_path_);
+  }
+  auto* xml_error = const_cast<xmlErrorPtr>(&error);
+  switch (error.domain) {
+    case xmlErrorDomain::XML_FROM_IO:
+      SCRAM_THROW(IOError(error.message))
+          << boost::errinfo_file_name(file_path_)
+          << boost::errinfo_errno(errno) << boost::errinfo_file_open_mode("r");
+    case xmlErrorDomain::XML_FROM_XINCLUDE:
+      SCRAM_THROW(detail::GetError<XIncludeError>(xml_error));
+    default:
+      SCRAM_THROW(detail::GetError<ParseError>(xml_error));
+  }
+}
+
 }  // namespace scram::xml
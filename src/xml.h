@@ -42,6 +42,7 @@
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <vector>
 
 #include <boost/exception/errinfo_at_line.hpp>
 #include <boost/exception/errinfo_errno.hpp>
@@ -53,8 +54,10 @@
 #include <libxml/parser.h>
 #include <libxml/relaxng.h>
 #include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 
 #include "error.h"
+#include "mapped_file.h"
 
 namespace scram::xml {
 
@@ -381,6 +384,9 @@ class Element {
            });
   }
 
+  /// @returns The underlying XML node.
+  const xmlNode* get() const { return to_node(); }
+
  private:
   /// Converts the data to its base.
   xmlNode* to_node() const {
@@ -396,6 +402,7 @@ const int kParserOptions = XML_PARSE_XINCLUDE | XML_PARSE_NOBASEFIX |
                            XML_PARSE_COMPACT | XML_PARSE_HUGE;
 
 class Validator;  // Forward declaration for validation upon DOM constructions.
+class Reader;  // Forward declaration for streaming document constructions.
 
 /// XML DOM tree document.
 class Document {
@@ -415,6 +422,9 @@ class Document {
   explicit Document(const std::string& file_path,
                     Validator* validator = nullptr);
 
+  /// @param[in] doc  The document built in memory to be owned.
+  explicit Document(xmlDoc* doc) : doc_(doc, &xmlFreeDoc) {}
+
   /// @returns The root element of the document.
   ///
   /// @pre The document has a root node.
@@ -435,6 +445,8 @@ class Document {
 
 /// RelaxNG validator.
 class Validator {
+  friend class Reader;  // Validates the document stream with the schema.
+
  public:
   /// @param[in] rng_file  The path to the schema file.
   ///
@@ -463,4 +475,144 @@ class Validator {
       valid_ctxt_;
 };
 
+/// Streaming reader of XML documents.
+///
+/// The document is parsed and validated in a single pass.
+/// The child elements are read one at a time,
+/// so the caller may enter the containers of definitions
+/// and handle the definitions one by one
+/// while the rest of the document is being read.
+/// Only the entered elements (with their attributes, labels, and attributes)
+/// and the elements kept explicitly are retained in the DOM document.
+/// All XInclude directives are processed on the fly.
+class Reader {
+ public:
+  /// Opens the document and enters its root element.
+  ///
+  /// @param[in] file_path  The path to the document file.
+  /// @param[in] validator  Optional validator against the RNG schema.
+  ///
+  /// @throws IOError  The file is not available.
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws XIncludeError  XInclude resolution has failed.
+  /// @throws ValidityError  The XML file is not valid.
+  explicit Reader(const std::string& file_path, Validator* validator = nullptr);
+
+  ~Reader() noexcept;  ///< Releases the expanded copy and the library errors.
+
+  /// @returns The root element with the retained child elements.
+  Element root() const { return document_.root(); }
+
+  /// Reads the next child element of the innermost entered element.
+  /// The previous element is skipped unless it has been entered.
+  ///
+  /// @returns The start of the element with its XML attributes only,
+  ///          which is valid until the next read.
+  ///          None if the entered element ends, which also leaves it.
+  ///
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws XIncludeError  XInclude resolution has failed.
+  /// @throws ValidityError  The XML file is not valid.
+  std::optional<Element> Next();
+
+  /// Reads the whole current element.
+  /// With the validation, the element is validated before its use.
+  ///
+  /// @returns The complete element valid until the next read.
+  ///
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws XIncludeError  XInclude resolution has failed.
+  /// @throws ValidityError  The XML file is not valid.
+  ///
+  /// @pre The current element is returned by Next and not entered.
+  Element Expand();
+
+  /// Enters the current element to read its child elements with Next.
+  ///
+  /// @returns The element retained in the document
+  ///          with its XML attributes and the label and attributes elements.
+  ///
+  /// @throws ParseError  There are XML parsing failures.
+  /// @throws XIncludeError  XInclude resolution has failed.
+  /// @throws ValidityError  The XML file is not valid.
+  ///
+  /// @pre The current element is returned by Next and not expanded.
+  Element Enter();
+
+  /// Retains the expanded element in the document.
+  ///
+  /// @returns The element in the document.
+  ///
+  /// @pre The current element is expanded.
+  Element Keep();
+
+  /// @returns The document with the entered and kept elements.
+  Document document() && { return std::move(document_); }
+
+ private:
+  /// Advances the reader to the next node.
+  ///
+  /// @returns false if the end of the document is reached.
+  ///
+  /// @throws Error  The parsing or validation has failed.
+  bool Read();
+
+  /// Skips the rest of the current node.
+  ///
+  /// @throws Error  The parsing or validation has failed.
+  void Skip();
+
+  /// Frees the expanded element copy if it is not kept.
+  void Release() noexcept;
+
+  /// Calls the library reader operation
+  /// and checks the errors raised by the operation.
+  ///
+  /// @tparam F  The operation type: () -> int.
+  ///
+  /// @param[in] operation  The operation returning a negative code on failure.
+  ///
+  /// @returns The code returned by the operation.
+  ///
+  /// @throws Error  The parsing or validation has failed.
+  template <class F>
+  int Call(F&& operation);
+
+  /// Checks the errors captured from the last library operation.
+  ///
+  /// @param[in] ret  The code returned by the operation.
+  ///
+  /// @throws Error  The parsing or validation has failed.
+  void CheckErrors(int ret);
+
+  /// Records the first errors of the library into the reader.
+  ///
+  /// @param[in,out] data  The reader.
+  /// @param[in] error  The library error.
+  static void CaptureError(void* data, xmlErrorPtr error) noexcept;
+
+  /// Throws the library error converted by its domain.
+  ///
+  /// @param[in] error  The first error captured from the library.
+  ///
+  /// @throws Error  The converted error.
+  [[noreturn]] void ThrowError(const xmlError& error) const;
+
+  std::string file_path_;  ///< The document file for error messages.
+  MappedFile input_;  ///< The document contents read in place by the library.
+  /// The library streaming reader.
+  std::unique_ptr<xmlTextReader, decltype(&xmlFreeTextReader)> reader_;
+  Document document_;  ///< The entered and kept elements.
+  std::vector<xmlNode*> parents_;  ///< The entered elements in the document.
+  xmlNode* expanded_ = nullptr;  ///< The expanded current element.
+  bool copied_ = false;  ///< The expanded element is a copy to free.
+  bool current_ = false;  ///< The reader is at the element returned by Next.
+  bool lookahead_ = false;  ///< The current element is to be returned again.
+  bool closing_ = false;  ///< The innermost entered element has ended.
+  bool pending_ = false;  ///< The reader is at a node not yet inspected.
+  bool validating_ = false;  ///< The stream is validated with a schema.
+  xmlError error_ = {};  ///< The first parsing error.
+  xmlError validity_error_ = {};  ///< The first validation error.
+};
+
 }  // namespace scram::xml
@@ -0,0 +1,347 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+/// Implementation of the XML stream destinations.
+
+#include "xml_stream.h"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/exception/errinfo_errno.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/exception/errinfo_file_open_mode.hpp>
+
+#include <zlib.h>
+
+#ifdef SCRAM_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace scram::xml {
+
+namespace {
+
+/// @returns The error number of the last failure or EIO if unknown.
+int LastError() { return errno ? errno : EIO; }
+
+/// Opens the file for writing.
+///
+/// @param[in] file  The destination file.
+/// @param[in] mode  The stdio mode to open the file.
+///
+/// @returns The open file.
+///
+/// @throws IOError  The file cannot be opened.
+std::FILE* OpenFile(const std::string& file, const char* mode) {
+  std::FILE* fp = std::fopen(file.c_str(), mode);
+  if (!fp) {
+    SCRAM_THROW(IOError("Cannot open the output file."))
+        << boost::errinfo_errno(LastError())
+        << boost::errinfo_file_open_mode(mode);
+  }
+  return fp;
+}
+
+/// Output into a stdio file.
+class FileOutput : public Output {
+ public:
+  /// @param[in] file  The destination file.
+  /// @param[in] owner  The flag to close the file upon completion.
+  FileOutput(std::FILE* file, bool owner) : file_(file), owner_(owner) {}
+
+  ~FileOutput() override {
+    if (file_ && owner_)
+      std::fclose(file_);
+  }
+
+  void Write(const char* data, std::size_t size) noexcept override {
+    if (std::fwrite(data, 1, size, file_) != size && !error_)
+      error_ = LastError();
+  }
+
+  int Finish() noexcept override {
+    if (std::fflush(file_) && !error_)
+      error_ = LastError();
+    if (std::ferror(file_) && !error_)
+      error_ = EIO;
+    if (owner_ && std::fclose(file_) && !error_)
+      error_ = LastError();
+    file_ = owner_ ? nullptr : file_;
+    return error_;
+  }
+
+ private:
+  std::FILE* file_;  ///< The destination file.
+  bool owner_;  ///< The ownership of the file.
+  int error_ = 0;  ///< The first failure.
+};
+
+/// Output into a gzip-compressed file.
+class GzipOutput : public Output {
+ public:
+  /// @param[in] file  The destination file path.
+  ///
+  /// @throws IOError  The file cannot be opened.
+  explicit GzipOutput(const std::string& file)
+      : file_(gzopen(file.c_str(), "wb6")) {
+    if (!file_) {
+      SCRAM_THROW(IOError("Cannot open the output file."))
+          << boost::errinfo_errno(LastError())
+          << boost::errinfo_file_open_mode("wb");
+    }
+    gzbuffer(file_, kBufferSize);
+  }
+
+  ~GzipOutput() override {
+    if (file_)
+      gzclose(file_);
+  }
+
+  void Write(const char* data, std::size_t size) noexcept override {
+    while (size && !error_) {
+      unsigned int chunk = std::min<std::size_t>(size, kBufferSize);
+      if (gzwrite(file_, data, chunk) != static_cast<int>(chunk))
+        error_ = LastError();
+      data += chunk;
+      size -= chunk;
+    }
+  }
+
+  int Finish() noexcept override {
+    if (gzclose(file_) != Z_OK && !error_)
+      error_ = LastError();
+    file_ = nullptr;
+    return error_;
+  }
+
+ private:
+  static constexpr unsigned int kBufferSize = 1 << 17;  ///< The zlib buffer.
+
+  gzFile file_;  ///< The compressed file.
+  int error_ = 0;  ///< The first failure.
+};
+
+#ifdef SCRAM_WITH_ZSTD
+/// Output into a Zstandard-compressed file.
+class ZstdOutput : public Output {
+ public:
+  /// @param[in] file  The destination file.
+  ///
+  /// @throws IOError  The compression context cannot be initialized.
+  explicit ZstdOutput(std::FILE* file)
+      : file_(file, /*owner=*/true),
+        context_(ZSTD_createCCtx()),
+        buffer_(ZSTD_CStreamOutSize()) {
+    if (!context_)
+      SCRAM_THROW(IOError("Cannot initialize the Zstandard compression."));
+    ZSTD_CCtx_setParameter(context_.get(), ZSTD_c_compressionLevel, 3);
+  }
+
+  void Write(const char* data, std::size_t size) noexcept override {
+    ZSTD_inBuffer input = {data, size, 0};
+    while (input.pos < input.size && !error_)
+      Compress(&input, ZSTD_e_continue);
+  }
+
+  int Finish() noexcept override {
+    ZSTD_inBuffer input = {nullptr, 0, 0};
+    while (!error_ && Compress(&input, ZSTD_e_end)) {
+    }
+    int error = file_.Finish();
+    return error_ ? error_ : error;
+  }
+
+ private:
+  /// Deleter of the compression context.
+  struct Deleter {
+    /// Frees the context.
+    void operator()(ZSTD_CCtx* context) const { ZSTD_freeCCtx(context); }
+  };
+
+  /// Compresses the input data into the file.
+  ///
+  /// @param[in,out] input  The data to consume.
+  /// @param[in] directive  The flushing directive of the compression.
+  ///
+  /// @returns The number of bytes remaining to be flushed.
+  std::size_t Compress(ZSTD_inBuffer* input, ZSTD_EndDirective directive) {
+    ZSTD_outBuffer output = {buffer_.data(), buffer_.size(), 0};
+    std::size_t remaining =
+        ZSTD_compressStream2(context_.get(), &output, input, directive);
+    if (ZSTD_isError(remaining)) {
+      error_ = EIO;
+      return 0;
+    }
+    file_.Write(buffer_.data(), output.pos);
+    return remaining;
+  }
+
+  FileOutput file_;  ///< The destination file.
+  std::unique_ptr<ZSTD_CCtx, Deleter> context_;  ///< The compression state.
+  std::vector<char> buffer_;  ///< The compressed block.
+  int error_ = 0;  ///< The first failure of the compression.
+};
+#endif
+
+/// Output passing the data to another output in a background thread.
+class BackgroundOutput : public Output {
+ public:
+  /// @param[in] output  The destination output.
+  explicit BackgroundOutput(std::unique_ptr<Output> output)
+      : output_(std::move(output)), thread_([this] { Run(); }) {}
+
+  ~BackgroundOutput() override {
+    if (thread_.joinable())
+      Finish();
+  }
+
+  void Write(const char* data, std::size_t size) noexcept override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_.wait(lock, [this] { return blocks_.size() < kMaxBlocks; });
+    blocks_.emplace_back(data, size);
+    condition_.notify_all();
+  }
+
+  int Finish() noexcept override {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      done_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+    return output_->Finish();
+  }
+
+ private:
+  /// The maximum number of pending blocks to bound the memory.
+  static constexpr int kMaxBlocks = 4;
+
+  /// Writes the pending blocks until the completion.
+  void Run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+      condition_.wait(lock, [this] { return !blocks_.empty() || done_; });
+      if (blocks_.empty())
+        return;
+      std::string block = std::move(blocks_.front());
+      blocks_.pop_front();
+      lock.unlock();
+      condition_.notify_all();
+      output_->Write(block.data(), block.size());
+      lock.lock();
+    }
+  }
+
+  std::unique_ptr<Output> output_;  ///< The destination.
+  std::mutex mutex_;  ///< The guard of the pending blocks.
+  std::condition_variable condition_;  ///< The change of the pending blocks.
+  std::deque<std::string> blocks_;  ///< The pending blocks in order.
+  bool done_ = false;  ///< The indication of no more blocks.
+  std::thread thread_;  ///< The writer of the blocks.
+};
+
+}  // namespace
+
+namespace detail {
+
+const char* FindSpecialChar(const char* first, const char* last) noexcept {
+  using Word = std::uint64_t;
+  const Word kOnes = ~Word(0) / 0xFF;  // 0x0101...01
+  const Word kHighs = kOnes << 7;  // 0x8080...80
+  // The high bit of any zero byte of the word (no false negatives).
+  auto zero_bytes = [&](Word word) { return (word - kOnes) & ~word & kHighs; };
+  for (; last - first >= static_cast<std::ptrdiff_t>(sizeof(Word));
+       first += sizeof(Word)) {
+    Word word;
+    std::memcpy(&word, first, sizeof(word));
+    if (zero_bytes(word ^ (kOnes * '&')) | zero_bytes(word ^ (kOnes * '<')) |
+        zero_bytes(word ^ (kOnes * '"'))) {
+      break;  // The exact position is found in the word bytes.
+    }
+  }
+  for (; first != last; ++first) {
+    if (*first == '&' || *first == '<' || *first == '"')
+      return first;
+  }
+  return last;
+}
+
+}  // namespace detail
+
+std::unique_ptr<Output> Output::Open(const std::string& file,
+                                     bool background) {
+  std::unique_ptr<Output> output;
+  try {
+    if (boost::ends_with(file, ".gz")) {
+      output = std::make_unique<GzipOutput>(file);
+    } else if (boost::ends_with(file, ".zst")) {
+#ifdef SCRAM_WITH_ZSTD
+      output = std::make_unique<ZstdOutput>(OpenFile(file, "wb"));
+#else
+      SCRAM_THROW(
+          IOError("Zstandard compression is not supported in this build."));
+#endif
+    } else {
+      return std::make_unique<FileOutput>(OpenFile(file, "w"), /*owner=*/true);
+    }
+  } catch (IOError& err) {
+    err << boost::errinfo_file_name(file);
+    throw;
+  }
+  if (background)
+    return std::make_unique<BackgroundOutput>(std::move(output));
+  return output;
+}
+
+std::unique_ptr<Output> Output::Open(std::FILE* file) {
+  return std::make_unique<FileOutput>(file, /*owner=*/false);
+}
+
+Stream::Stream(std::FILE* out, bool indent)
+    : Stream(Output::Open(out), indent) {
+  assert(!std::ferror(out) && "Unclean error state in output destination.");
+}
+
+Stream::Stream(std::unique_ptr<Output> output, bool indent)
+    : indenter_(indent),
+      has_root_(false),
+      uncaught_exceptions_(std::uncaught_exceptions()),
+      output_(std::move(output)),
+      out_(output_.get()) {
+  out_ << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+}
+
+Stream::~Stream() noexcept(false) {
+  out_.flush();
+  int err = output_->Finish();
+  if (err && (std::uncaught_exceptions() == uncaught_exceptions_))
+    SCRAM_THROW(IOError("FILE error on write")) << boost::errinfo_errno(err);
+}
+
+}  // namespace scram::xml
@@ -22,12 +22,14 @@
 
 #include <cassert>
 #include <cstdio>
+#include <cstring>
 
 #include <algorithm>
-#include <exception>
+#include <charconv>
+#include <memory>
 #include <string>
-
-#include <boost/exception/errinfo_errno.hpp>
+#include <string_view>
+#include <system_error>
 
 #include "error.h"
 
@@ -38,6 +40,46 @@ struct StreamError : public Error {
   using Error::Error;
 };
 
+/// Destination of the streamed XML data.
+class Output {
+ public:
+  /// Opens the output file for the stream.
+  /// The file extension selects the on-the-fly compression:
+  /// ".gz" for gzip, ".zst" for Zstandard, none otherwise.
+  ///
+  /// @param[in] file  The destination file to overwrite.
+  /// @param[in] background  Compress the data in a background thread
+  ///                        so that the stream writer never waits for it.
+  ///
+  /// @returns The output writing into the file.
+  ///
+  /// @throws IOError  The file is not accessible,
+  ///                  or the compression format is not supported.
+  static std::unique_ptr<Output> Open(const std::string& file,
+                                      bool background = false);
+
+  /// @param[in] file  The open destination file, e.g., the standard output.
+  ///
+  /// @returns The output writing into the file without closing it.
+  static std::unique_ptr<Output> Open(std::FILE* file);
+
+  virtual ~Output() = default;
+
+  /// Writes the data block into the destination.
+  /// The failures are deferred to the completion.
+  ///
+  /// @param[in] data  The beginning of the block.
+  /// @param[in] size  The number of bytes in the block.
+  virtual void Write(const char* data, std::size_t size) noexcept = 0;
+
+  /// Completes writing all the data into the destination.
+  ///
+  /// @returns The error number of the first failure or 0.
+  ///
+  /// @post No more writes are accepted.
+  virtual int Finish() noexcept = 0;
+};
+
 namespace detail {  // XML streaming helpers.
 
 const char kIndentChar = ' ';  ///< The whitespace character.
@@ -99,48 +141,76 @@ class Indenter {
   char spaces[kMaxIndent + 1];  ///< The indentation and terminator.
 };
 
-/// Adaptor for stdio FILE stream with write generic interface.
+/// Finds the first XML special character (&, <, ") to escape.
+/// The characters are searched a machine word at a time.
+///
+/// @param[in] first  The beginning of the text.
+/// @param[in] last  The end of the text.
+///
+/// @returns The position of the special character or the end of the text.
+const char* FindSpecialChar(const char* first, const char* last) noexcept;
+
+/// Buffered writer of values into the output with write generic interface.
 ///
 /// @note Write operations do not return any error code or throw exceptions.
 ///       If any IO errors happen,
-///       the FILE handler contains the error information.
+///       the output reports them upon completion.
 class FileStream {
  public:
-  /// @param[in] file  The output file stream.
-  explicit FileStream(std::FILE* file) : file_(file) {}
-
-  /// @returns The destination file stream.
-  std::FILE* file() { return file_; }
+  /// @param[in] output  The destination of the data.
+  explicit FileStream(Output* output)
+      : output_(output), buffer_(new char[kBufferSize]) {}
 
-  /// Writes a value into file.
+  /// Writes a value into the buffer.
+  /// The numbers are in the shortest form that reads back the same value.
   /// @{
-  void write(const std::string& value) { write(value.c_str()); }
-  void write(const char* value) { std::fputs(value, file_); }
-  void write(const char value) { std::fputc(value, file_); }
-  void write(int value) {
-    if (value < 0) {
-      std::fputc('-', file_);
-      value = -value;
-    }
-    write(static_cast<std::size_t>(value));
+  void write(std::string_view value) { write(value.data(), value.size()); }
+  void write(const char* value) { write(value, std::strlen(value)); }
+  void write(const char value) {
+    if (size_ == kBufferSize)
+      flush();
+    buffer_[size_++] = value;
   }
-  void write(std::size_t value) {
-    char temp[20];
-    char* p = temp;
-    do {
-      *p++ = value % 10 + '0';
-      value /= 10;
-    } while (value > 0);
-
-    do {
-      std::fputc(*--p, file_);
-    } while (p != temp);
+  void write(int value) { write_number(value); }
+  void write(std::size_t value) { write_number(value); }
+  void write(double value) { write_number(value); }
+  void write(const char* data, std::size_t size) {
+    if (size > kBufferSize - size_) {
+      flush();
+      if (size >= kBufferSize)
+        return output_->Write(data, size);
+    }
+    std::memcpy(buffer_.get() + size_, data, size);
+    size_ += size;
   }
-  void write(double value) { std::fprintf(file_, "%g", value); }
   /// @}
 
+  /// Passes the buffered data to the output.
+  void flush() {
+    if (size_) {
+      output_->Write(buffer_.get(), size_);
+      size_ = 0;
+    }
+  }
+
  private:
-  std::FILE* file_;  ///< The destination file.
+  static constexpr std::size_t kBufferSize = 1 << 16;  ///< The block size.
+  static constexpr int kMaxDigits = 32;  ///< The space for any number.
+
+  /// Formats the number directly into the buffer.
+  template <typename T>
+  void write_number(T value) {
+    if (kBufferSize - size_ < kMaxDigits)
+      flush();
+    char* first = buffer_.get() + size_;
+    auto [last, ec] = std::to_chars(first, first + kMaxDigits, value);
+    assert(ec == std::errc() && "Insufficient space for the number.");
+    size_ += last - first;
+  }
+
+  Output* output_;  ///< The destination of the data.
+  std::unique_ptr<char[]> buffer_;  ///< The block of data for the output.
+  std::size_t size_ = 0;  ///< The number of bytes in the buffer.
 };
 
 /// Convenience wrapper to provide C++ stream-like interface.
@@ -350,42 +420,30 @@ class StreamElement {
   void PutValue(double value) { out_ << value; }
   void PutValue(std::size_t value) { out_ << value; }
   void PutValue(bool value) { out_ << (value ? "true" : "false"); }
-  void PutValue(const std::string& value) { PutValue(value.c_str()); }
-  void PutValue(const char* value) {
-    bool has_special_chars = [value]() mutable {  // 2x faster than strpbrk.
-      for (;; ++value) {
-        switch (*value) {
-          case '\0':
-            return false;
-          case '&':
-          case '<':
-          case '"':
-            return true;
-        }
-      }
-    }();
-
-    if (!has_special_chars) {  // The most common case.
-      out_ << value;
-    } else {
-      for (;; ++value) {
-        switch (*value) {
-          case '\0':
-            return;
-          case '&':
-            out_ << "&amp;";
-            break;
-          case '<':
-            out_ << "&lt;";
-            break;
-          case '"':
-            out_ << "&quot;";
-            break;
-          default:
-            out_ << *value;
-        }
+  void PutValue(const std::string& value) {
+    PutValue(std::string_view(value));
+  }
+  void PutValue(const char* value) { PutValue(std::string_view(value)); }
+  void PutValue(std::string_view value) {
+    const char* first = value.data();
+    const char* last = first + value.size();
+    for (const char* special = detail::FindSpecialChar(first, last);
+         special != last; special = detail::FindSpecialChar(first, last)) {
+      out_.write(first, special - first);
+      switch (*special) {
+        case '&':
+          out_ << "&amp;";
+          break;
+        case '<':
+          out_ << "&lt;";
+          break;
+        default:
+          assert(*special == '"');
+          out_ << "&quot;";
       }
+      first = special + 1;
     }
+    out_.write(first, last - first);  // The most common case is the whole.
   }
   /// @}
 
@@ -407,6 +465,9 @@ class StreamElement {
 ///
 /// @note The document elements are indented up to 10 levels for readability.
 ///       The XML tree depth beyond 10 elements is printed at level 10.
+///
+/// @note The data reaches the destination in blocks,
+///       and the last block is written upon the destruction of the stream.
 class Stream {
  public:
   /// Constructs a document with XML header.
@@ -415,23 +476,18 @@ class Stream {
   /// @param[in] indent  Option to indent output for readability.
   ///
   /// @note This output file has clean error state.
-  explicit Stream(std::FILE* out, bool indent = true)
-      : indenter_(indent),
-        has_root_(false),
-        uncaught_exceptions_(std::uncaught_exceptions()),
-        out_(out) {
-    assert(!std::ferror(out) && "Unclean error state in output destination.");
-    out_ << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
-  }
+  explicit Stream(std::FILE* out, bool indent = true);
 
+  /// @param[in] output  The stream destination.
+  /// @param[in] indent  Option to indent output for readability.
+  explicit Stream(std::unique_ptr<Output> output, bool indent = true);
+
+  /// Completes the output.
+  ///
   /// @throws IOError  The file write operation has failed.
   ///
   /// @post The exception is thrown only if no other exception is on flight.
-  ~Stream() noexcept(false) {
-    int err = std::ferror(out_.file());
-    if (err && (std::uncaught_exceptions() == uncaught_exceptions_))
-      SCRAM_THROW(IOError("FILE error on write")) << boost::errinfo_errno(err);
-  }
+  ~Stream() noexcept(false);
 
   /// Creates a root element for the document.
   ///
@@ -455,7 +511,8 @@ class Stream {
   detail::Indenter indenter_;  ///< The indentation manager for the document.
   bool has_root_;  ///< The document has constructed its root.
   int uncaught_exceptions_;  ///< The balance of exceptions.
-  detail::FileStream out_;  ///< The output stream.
+  std::unique_ptr<Output> output_;  ///< The output destination.
+  detail::FileStream out_;  ///< The buffered output stream.
 };
 
 }  // namespace scram::xml
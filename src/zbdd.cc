@@ -29,6 +29,7 @@
 #include "ext/algorithm.h"
 #include "ext/find_iterator.h"
 #include "logger.h"
+#include "progress.h"
 
 namespace scram::core {
 
@@ -84,14 +85,17 @@ Zbdd::Zbdd(const Pdag* graph, const Settings& settings) noexcept
   CHECK_ZBDD(true);
 }
 
-void Zbdd::Analyze(const Pdag* graph) noexcept {
+void Zbdd::Analyze(const Pdag* graph) {
   CLOCK(zbdd_time);
+  TRACE("ZBDD module analysis");
   assert(root_->terminal() ||
          SetNode::Ref(root_).max_set_order() <= kSettings_.limit_order());
   root_ = Minimize(root_);  // Likely to be minimal by now.
   assert(root_->terminal() || SetNode::Ref(root_).minimal());
-  for (const auto& entry : modules_)
+  for (const auto& entry : modules_) {
+    CheckCancellation(kSettings_.progress());
     entry.second->Analyze();
+  }
 
   Prune(root_, kSettings_.limit_order());
   if (graph)
@@ -114,6 +118,7 @@ Zbdd::Zbdd(const Bdd::Function& module, bool coherent, Bdd* bdd,
            const Settings& settings, int module_index) noexcept
     : Zbdd(settings, coherent, module_index) {
   CLOCK(init_time);
+  TRACE("Converting BDD into ZBDD");
   LOG(DEBUG2) << "Creating ZBDD from BDD: G" << module_index;
   LOG(DEBUG4) << "Limit on product order: " << settings.limit_order();
   PairTable<VertexPtr> ites;
@@ -157,6 +162,7 @@ Zbdd::Zbdd(const Gate& gate, const Settings& settings) noexcept
     return;
   assert(!settings.prime_implicants() && "Not implemented.");
   CLOCK(init_time);
+  TRACE("Converting module into ZBDD");
   assert(gate.module() && "The constructor is meant for module gates.");
   LOG(DEBUG3) << "Converting module to ZBDD: G" << gate.index();
   LOG(DEBUG4) << "Limit on product order: " << settings.limit_order();
@@ -43,6 +43,9 @@ namespace scram::core {
 /// The order of the complement is higher than the order of the variable.
 class SetNode : public NonTerminal<SetNode> {
  public:
+  /// The kind of the vertex for resource accounting.
+  static constexpr Resource kResource = Resource::kZbddVertex;
+
   using NonTerminal::NonTerminal;
 
   /// @returns true if the ZBDD is minimized.
@@ -341,7 +344,7 @@ class Zbdd : private boost::noncopyable {
   /// @param[in] graph  The optional PDAG with non-declarative substitutions.
   ///
   /// @post Substitutions destroy all the modules.
-  void Analyze(const Pdag* graph = nullptr) noexcept;
+  void Analyze(const Pdag* graph = nullptr);
 
   /// @returns Products generated by the analysis.
   const Zbdd& products() const { return *this; }
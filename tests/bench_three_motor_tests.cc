@@ -91,4 +91,52 @@ TEST_F(RiskAnalysisTest, ThreeMotorEventTree) {
   }
 }
 
+// The sequences share a single BDD.
+TEST_F(RiskAnalysisTest, ThreeMotorEventTreeSharedBdd) {
+  std::string dir = "input/ThreeMotor/";
+  settings.probability_analysis(true).shared_bdd(true);
+  ASSERT_NO_THROW(
+      ProcessInputFiles({dir + "three_motor.xml", dir + "event_tree.xml"}));
+  ASSERT_NO_THROW(analysis->Analyze());
+  std::map<std::string, double> expected = {
+      {"S1", 0.02115}, {"S2", 0.00272}, {"S3", 0.00309}, {"S4", 0.00272},
+      {"S5", 0.00272}, {"S6", 0.00272}, {"S7", 0.00272}, {"S8", 0.00272}};
+  const auto& results = sequences();
+  ASSERT_EQ(8, results.size());
+  for (const auto& result : expected) {
+    INFO("seq: " + result.first);
+    ASSERT_TRUE(results.count(result.first));
+    EXPECT_NEAR(result.second, results.at(result.first), 1e-5);
+  }
+}
+
+// The sequences are analyzed concurrently.
+TEST_F(RiskAnalysisTest, ThreeMotorEventTreeThreads) {
+  std::string dir = "input/ThreeMotor/";
+  settings.probability_analysis(true).num_threads(4);
+  ASSERT_NO_THROW(
+      ProcessInputFiles({dir + "three_motor.xml", dir + "event_tree.xml"}));
+  ASSERT_NO_THROW(analysis->Analyze());
+  std::map<std::string, double> expected = {
+      {"S1", 0.02115}, {"S2", 0.00272}, {"S3", 0.00309}, {"S4", 0.00272},
+      {"S5", 0.00272}, {"S6", 0.00272}, {"S7", 0.00272}, {"S8", 0.00272}};
+  const auto& results = sequences();
+  ASSERT_EQ(8, results.size());
+  for (const auto& result : expected) {
+    INFO("seq: " + result.first);
+    ASSERT_TRUE(results.count(result.first));
+    EXPECT_NEAR(result.second, results.at(result.first), 1e-5);
+  }
+  // The results are in the deterministic order of the sequences.
+  const auto& sequences =
+      analysis->event_tree_results().front().event_tree_analysis->sequences();
+  REQUIRE(sequences.size() <= analysis->results().size());
+  for (int i = 0; i < sequences.size(); ++i) {
+    const auto& id = analysis->results()[i].id;
+    using Target = std::pair<const mef::InitiatingEvent&, const mef::Sequence&>;
+    ASSERT_TRUE(std::holds_alternative<Target>(id.target));
+    EXPECT_EQ(&sequences[i].sequence, &std::get<Target>(id.target).second);
+  }
+}
+
 }  // namespace scram::core::test
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2018 Olzhas Rakhimov
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Throughput of report writing with the XML stream.
+// The benchmark is run only if requested with the "[.perf]" tag.
+
+#include "xml_stream.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch.hpp>
+
+namespace scram::xml::test {
+
+namespace {
+
+/// Output discarding the data.
+class NullOutput : public Output {
+ public:
+  /// @param[out] size  The counter of the written bytes.
+  explicit NullOutput(std::size_t* size) : size_(*size) {}
+
+  void Write(const char* /*data*/, std::size_t size) noexcept override {
+    size_ += size;
+  }
+
+  int Finish() noexcept override { return 0; }
+
+ private:
+  std::size_t& size_;  ///< The number of written bytes.
+};
+
+}  // namespace
+
+// The products of a report with the probabilities of the literals.
+TEST_CASE("XmlStreamTest.Throughput", "[.perf]") {
+  const int kNumProducts = 1000000;
+  const int kOrder = 4;
+  std::vector<std::string> events;
+  for (int i = 0; i < 1000; ++i)
+    events.push_back("BasicEvent-" + std::to_string(i) + "-pump-fails");
+
+  std::size_t size = 0;
+  auto start = std::chrono::steady_clock::now();
+  {
+    Stream xml_stream(std::make_unique<NullOutput>(&size));
+    StreamElement report = xml_stream.root("report");
+    StreamElement results = report.AddChild("results");
+    StreamElement sum_of_products = results.AddChild("sum-of-products");
+    double p = 1;
+    for (int i = 0; i < kNumProducts; ++i) {
+      StreamElement product = sum_of_products.AddChild("product");
+      p *= 0.999999;
+      product.SetAttribute("order", kOrder)
+          .SetAttribute("probability", p / 3)
+          .SetAttribute("contribution", p / kNumProducts);
+      for (int j = 0; j < kOrder; ++j) {
+        product.AddChild("basic-event")
+            .SetAttribute("name", events[(i * 7 + j * 13) % events.size()]);
+      }
+    }
+  }
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+  double throughput = size / time.count() / (1 << 20);
+  WARN("Report of " << size / (1 << 20) << " MiB in " << time.count()
+                    << "s: " << throughput << " MiB/s");
+#ifdef NDEBUG
+  CHECK(throughput > 400);
+#endif
+}
+
+}  // namespace scram::xml::test
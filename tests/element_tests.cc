@@ -221,4 +221,45 @@ TEST_CASE("ElementTest.Id", "[mef::element]") {
   CHECK(id_private.name() == "id");
 }
 
+TEST_CASE("ElementTest.InternedStrings", "[mef::element]") {
+  NameId first("first", "tree.component", RoleSpecifier::kPrivate);
+  NameId second("second", "tree.component", RoleSpecifier::kPrivate);
+  CHECK(&first.base_path() == &second.base_path());
+  CHECK(first.id() == "tree.component.first");
+
+  NameId copy("first");
+  CHECK(&copy.name() == &first.name());
+  copy.id("other");  // Other elements are not affected.
+  CHECK(first.name() == "first");
+  CHECK(copy.name() == "other");
+
+  first.label("label");
+  second.label(std::string("label"));
+  CHECK(&first.label() == &second.label());
+}
+
+TEST_CASE("ElementTest.Symbols", "[mef::element]") {
+  CHECK_FALSE(Symbol("never interned symbol"));
+  CHECK(Symbol("never interned symbol").id() == 0);
+  CHECK(Symbol().str().empty());
+
+  Symbol symbol = Symbol::Intern("symbol");
+  CHECK(symbol);
+  CHECK(symbol.id() > 0);
+  CHECK(symbol.str() == "symbol");
+  CHECK(Symbol::Intern("symbol") == symbol);
+  CHECK(Symbol(std::string("symbol")) == symbol);
+
+  Symbol next = Symbol::Intern("next symbol");
+  CHECK(next != symbol);
+  CHECK(next.id() == symbol.id() + 1);  // Dense ids.
+
+  NameId element("name", "tree", RoleSpecifier::kPrivate);
+  CHECK(element.name_symbol() == Symbol("name"));
+  CHECK(element.id_symbol() == Symbol("tree.name"));
+  CHECK(element.full_path() == element.id_symbol());
+  NameId public_element("name", "tree");
+  CHECK(public_element.id_symbol() == element.name_symbol());
+}
+
 }  // namespace scram::mef::test
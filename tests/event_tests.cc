@@ -22,6 +22,8 @@
 #include "cycle.h"
 #include "error.h"
 #include "expression/constant.h"
+#include "expression/exponential.h"
+#include "parameter.h"
 
 namespace scram::mef::test {
 
@@ -45,6 +47,26 @@ TEST_CASE("BasicEventTest.ExpressionReset", "[mef::event]") {
   CHECK(event.p() == 0.1);
 }
 
+TEST_CASE("BasicEventTest.ProbabilityOverTime", "[mef::event]") {
+  MissionTime time(8760);
+  ConstantExpression lambda(7e-4);
+  ConstantExpression mu(4e-4);
+  ConstantExpression tau(120);
+  ConstantExpression theta(4740);
+  PeriodicTest periodic_test(&lambda, &mu, &tau, &theta, &time);
+  BasicEvent event("event");
+  event.expression(&periodic_test);
+
+  std::vector<double> time_points = {0, 100, 4740, 4800, 5000, 8760};
+  std::vector<double> p_time = event.p(time_points);
+  REQUIRE(p_time.size() == time_points.size());
+  CHECK(time.value() == 8760);
+  for (int i = 0; i < time_points.size(); ++i) {
+    time.value(time_points[i]);
+    CHECK(p_time[i] == Approx(event.p()));
+  }
+}
+
 TEST_CASE("BasicEventTest.Validate", "[mef::event]") {
   BasicEvent event("event");
   CHECK_FALSE(event.HasExpression());
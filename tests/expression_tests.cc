@@ -22,6 +22,7 @@
 #include "expression/exponential.h"
 #include "expression/numerical.h"
 #include "expression/random_deviate.h"
+#include "expression/tape.h"
 #include "parameter.h"
 
 #include <catch.hpp>
@@ -51,6 +52,7 @@ class OpenExpression : public Expression {
     return Interval::closed(min ? min : sample, max ? max : sample);
   }
   bool IsDeviate() noexcept override { return min || max; }
+  bool IsConstant() noexcept override { return false; }
 };
 
 namespace {
@@ -320,6 +322,74 @@ TEST_CASE("ExpressionTest.PeriodicTest11", "[mef::expression]") {
   EXPECT_NEAR(0.645377, dev->value(), 1e-5);
 }
 
+TEST_CASE("ExpressionTest.Philox", "[mef::expression]") {
+  using Philox = ext::philox4x32;
+  // Known answers from the Random123 test vectors.
+  CHECK(Philox::generate({0, 0, 0, 0}, {0, 0}) ==
+        Philox::counter_type{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+  CHECK(Philox::generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+                         {0xffffffff, 0xffffffff}) ==
+        Philox::counter_type{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+
+  Philox stream({1, 2}, {3, 4, 5, 6});
+  Philox::counter_type first = Philox::generate({3, 4, 5, 6}, {1, 2});
+  Philox::counter_type second = Philox::generate({3, 4, 5, 7}, {1, 2});
+  for (std::uint32_t value : first)
+    CHECK(stream() == value);
+  for (std::uint32_t value : second)
+    CHECK(stream() == value);
+}
+
+TEST_CASE("ExpressionTest.CounterBasedDeviates", "[mef::expression]") {
+  ConstantExpression min(0);
+  ConstantExpression max(1);
+  ConstantExpression mean(0);
+  ConstantExpression sigma(1);
+  UniformDeviate uniform(&min, &max);
+  NormalDeviate normal(&mean, &sigma);
+  uniform.key(RandomDeviate::MakeKey("parameter u", 0));
+  normal.key(RandomDeviate::MakeKey("parameter n", 0));
+  CHECK(RandomDeviate::MakeKey("parameter u", 0) !=
+        RandomDeviate::MakeKey("parameter u", 1));
+  auto sample = [](Expression* deviate, int first_trial, int num_trials) {
+    std::vector<double> samples;
+    for (int i = first_trial; i < first_trial + num_trials; ++i) {
+      RandomDeviate::trial(i);
+      deviate->Reset();
+      samples.push_back(deviate->Sample());
+    }
+    return samples;
+  };
+
+  RandomDeviate::engine(core::RngEngine::kPhilox);
+  RandomDeviate::seed(42);
+  std::vector<double> uniform_samples = sample(&uniform, 0, 10);
+  std::vector<double> normal_samples = sample(&normal, 0, 10);
+
+  // The samples do not depend on the order of sampling.
+  CHECK(sample(&normal, 0, 10) == normal_samples);
+  CHECK(sample(&uniform, 0, 10) == uniform_samples);
+
+  // The sampling can skip ahead to a range of trials.
+  std::vector<double> tail = sample(&uniform, 5, 5);
+  CHECK(tail == std::vector<double>(uniform_samples.begin() + 5,
+                                    uniform_samples.end()));
+
+  // The samples do not depend on the construction of other deviates.
+  UniformDeviate other(&min, &max);
+  other.key(uniform.key());
+  CHECK(sample(&other, 0, 10) == uniform_samples);
+  other.key(RandomDeviate::MakeKey("parameter u", 1));
+  CHECK(sample(&other, 0, 10) != uniform_samples);
+
+  RandomDeviate::seed(7);
+  CHECK(sample(&uniform, 0, 10) != uniform_samples);
+
+  RandomDeviate::engine(core::RngEngine::kMt19937);
+  RandomDeviate::seed(42);
+  CHECK(sample(&uniform, 0, 10) != uniform_samples);
+}
+
 // Uniform deviate test for invalid minimum and maximum values.
 TEST_CASE("ExpressionTest.UniformDeviate", "[mef::expression]") {
   OpenExpression min(1, 2);
@@ -1193,4 +1263,129 @@ TEST_CASE("ExpressionTest.Switch", "[mef::expression]") {
   EXPECT_DOUBLE_EQ(10, Switch({}, &arg_three).value());
 }
 
+TEST_CASE("ExpressionTest.Tape", "[mef::expression]") {
+  MissionTime time(100);
+  ConstantExpression lambda(1e-3);
+  Parameter rate("rate");
+  rate.expression(&lambda);
+  ConstantExpression two(2);
+  Mul double_rate(std::vector<Expression*>{&rate, &two});
+  Exponential first(&rate, &time);
+  Exponential second(&double_rate, &time);
+  OpenExpression arg(0.5, 0.25, 0.1, 0.9);
+  Add sum(std::vector<Expression*>{&arg, &first});
+
+  ExpressionTape tape({&first, &second, &sum, &rate});
+  CHECK(tape.mission_time() == &time);
+  // Shared nodes are compiled once, and constants are folded.
+  CHECK(tape.instructions().size() == 5);
+
+  tape.Evaluate();
+  REQUIRE(tape.num_lanes() == 1);
+  EXPECT_DOUBLE_EQ(first.value(), tape.value(0));
+  EXPECT_DOUBLE_EQ(second.value(), tape.value(1));
+  EXPECT_DOUBLE_EQ(sum.value(), tape.value(2));
+  EXPECT_DOUBLE_EQ(1e-3, tape.value(3));
+
+  std::vector<double> time_points = {0, 10, 1000};
+  tape.Evaluate(time_points);
+  REQUIRE(tape.num_lanes() == 3);
+  CHECK(time.value() == 100);
+  for (int i = 0; i < time_points.size(); ++i) {
+    EXPECT_DOUBLE_EQ(1 - std::exp(-1e-3 * time_points[i]), tape.value(0, i));
+    EXPECT_DOUBLE_EQ(1 - std::exp(-2e-3 * time_points[i]), tape.value(1, i));
+  }
+
+  tape.Sample(2);
+  REQUIRE(tape.num_lanes() == 2);
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_DOUBLE_EQ(first.value(), tape.value(0, i));
+    EXPECT_DOUBLE_EQ(0.25 + first.value(), tape.value(2, i));
+  }
+}
+
+TEST_CASE("ExpressionTest.TapeConstantFolding", "[mef::expression]") {
+  MissionTime time(100);
+  ConstantExpression lambda(1e-3);
+  Parameter rate("rate");
+  rate.expression(&lambda);
+  ConstantExpression two(2);
+  ConstantExpression ten(10);
+  Mul double_rate(std::vector<Expression*>{&rate, &two});
+  Exponential constant(&double_rate, &ten);
+  Exponential time_dependent(&double_rate, &time);
+  ConstantExpression min(1);
+  ConstantExpression max(2);
+  UniformDeviate deviate(&min, &max);
+  Mul product(std::vector<Expression*>{&deviate, &time_dependent});
+
+  CHECK(double_rate.IsConstant());
+  CHECK(constant.IsConstant());
+  CHECK_FALSE(time_dependent.IsConstant());
+  CHECK_FALSE(deviate.IsConstant());
+  CHECK_FALSE(product.IsConstant());
+
+  ExpressionTape tape({&constant, &time_dependent, &product});
+  using Opcode = ExpressionTape::Opcode;
+  const auto& instructions = tape.instructions();
+  REQUIRE(instructions.size() == 4);
+  CHECK(instructions[0].opcode == Opcode::kMissionTime);
+  CHECK(instructions[1].opcode == Opcode::kExponential);
+  CHECK(instructions[1].dependency == ExpressionTape::kTimeDependency);
+  CHECK(instructions[2].opcode == Opcode::kCall);
+  CHECK(instructions[2].dependency == ExpressionTape::kSampleDependency);
+  CHECK(instructions[3].opcode == Opcode::kMul);
+  CHECK(instructions[3].dependency ==
+        (ExpressionTape::kTimeDependency | ExpressionTape::kSampleDependency));
+
+  tape.Evaluate({10, 100});
+  for (int i = 0; i < 2; ++i)
+    EXPECT_DOUBLE_EQ(constant.value(), tape.value(0, i));
+  EXPECT_DOUBLE_EQ(1 - std::exp(-2e-3 * 10), tape.value(1, 0));
+  EXPECT_DOUBLE_EQ(time_dependent.value(), tape.value(1, 1));
+
+  tape.Sample(10);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_DOUBLE_EQ(time_dependent.value(), tape.value(1, i));
+    CHECK(tape.value(2, i) >= time_dependent.value());
+    CHECK(tape.value(2, i) <= 2 * time_dependent.value());
+  }
+}
+
+TEST_CASE("ExpressionTest.TapeSampleDeviate", "[mef::expression]") {
+  ConstantExpression min(1);
+  ConstantExpression max(2);
+  UniformDeviate deviate(&min, &max);
+  ConstantExpression ten(10);
+  Mul product(std::vector<Expression*>{&deviate, &ten});
+  ExpressionTape tape({&deviate, &product});
+  tape.Sample(100);
+  for (int i = 0; i < 100; ++i) {
+    CHECK(tape.value(0, i) >= 1);
+    CHECK(tape.value(0, i) <= 2);
+    EXPECT_DOUBLE_EQ(10 * tape.value(0, i), tape.value(1, i));
+  }
+}
+
+TEST_CASE("ExpressionTest.TapeSampleOrder", "[mef::expression]") {
+  ConstantExpression min(0);
+  ConstantExpression max(1);
+  UniformDeviate first(&min, &max);
+  UniformDeviate second(&min, &max);
+  Add sum(std::vector<Expression*>{&second, &first});
+  std::vector<Expression*> roots = {&first, &sum, &second};
+  ExpressionTape tape(roots);
+
+  RandomDeviate::seed(123);
+  tape.Sample(10);
+  // The same random numbers as sampling the root expressions one by one.
+  RandomDeviate::seed(123);
+  for (int i = 0; i < 10; ++i) {
+    for (Expression* root : roots)
+      root->Reset();
+    for (int j = 0; j < roots.size(); ++j)
+      CHECK(tape.value(j, i) == roots[j]->Sample());
+  }
+}
+
 }  // namespace scram::mef::test
@@ -30,6 +30,7 @@
 #endif
 
 #include "expression/constant.h"
+#include "expression/tape.h"
 
 namespace scram::mef::test {
 
@@ -152,6 +153,50 @@ TEST_CASE("ExternTest.ExternExpression", "[mef::extern_function]") {
   }
 }
 
+TEST_CASE("ExternTest.ExternFunctionBatch", "[mef::extern_function]") {
+  const std::string cwd_dir = boost::filesystem::current_path().string();
+  ExternLibrary library("dummy", kLibRelPath, cwd_dir, false, true);
+  CHECK(library.find<double(double)>("identity"));
+  CHECK_FALSE(library.find<double(double)>("foobar"));
+
+  ExternFunction<double, double> identity("dummy_id", "identity", library);
+  ExternFunction<double, double, double> sub("dummy_sub", "sub", library);
+  ExternFunction<double, double, double> div("dummy_div", "div", library,
+                                             true);
+  CHECK(identity.batched());
+  CHECK_FALSE(sub.batched());
+  CHECK(div.batched());
+  CHECK_FALSE(identity.pure());
+  CHECK(div.pure());
+
+  std::vector<double> results(3);
+  std::vector<double> args = {1, 2, 3};
+  identity(args.size(), results.data(), args.data());
+  CHECK(results == args);
+
+  ConstantExpression arg_one(42);
+  ConstantExpression arg_two(4);
+  ExternExpression impure(&identity, {&arg_one});
+  CHECK_FALSE(impure.IsConstant());
+  ExternExpression pure(&div, {&arg_one, &arg_two});
+  CHECK(pure.IsConstant());
+  CHECK(pure.value() == 10.5);
+  CHECK(pure.value() == 10.5);  // Memoized.
+
+  const double* blocks[] = {args.data(), args.data()};
+  pure.Compute(args.size(), blocks, results.data());
+  CHECK(results == std::vector<double>{1, 1, 1});
+
+  ExpressionTape tape({&impure, &pure});
+  REQUIRE(tape.instructions().size() == 1);  // The pure call is folded.
+  CHECK(tape.instructions().front().opcode == ExpressionTape::Opcode::kExtern);
+  tape.Evaluate(args);
+  for (int i = 0; i < args.size(); ++i) {
+    CHECK(tape.value(0, i) == 42);
+    CHECK(tape.value(1, i) == 10.5);
+  }
+}
+
 TEST_CASE("ExternTest.ExternFunctionApply", "[mef::extern_function]") {
   const std::string cwd_dir = boost::filesystem::current_path().string();
   ExternLibrary library("dummy", kLibRelPath, cwd_dir, false, true);
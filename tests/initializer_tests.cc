@@ -58,6 +58,29 @@ TEST_CASE("InitializerTest.PassTheSameFileTwice", "[mef::initializer]") {
                   IOError);
 }
 
+// Concurrent parsing must produce the same model
+// and report errors in the order of the files.
+TEST_CASE("InitializerTest.ParallelParsing", "[mef::initializer]") {
+  std::vector<std::string> input_files = {
+      "input/Chinese/chinese.xml", "input/Chinese/chinese-basic-events.xml"};
+  core::Settings settings;
+  auto serial = Initializer(input_files, settings).model();
+  auto parallel = Initializer(input_files, settings.num_threads(2)).model();
+  CHECK(parallel->gates().size() == serial->gates().size());
+  CHECK(parallel->basic_events().size() == serial->basic_events().size());
+
+  CHECK_THROWS_AS(Initializer({"tests/input/fta/correct_tree_input.xml",
+                               "tests/input/xml_formatting_error.xml",
+                               "tests/input/schema_fail.xml"},
+                              settings),
+                  xml::ParseError);
+  CHECK_THROWS_AS(Initializer({"tests/input/fta/correct_tree_input.xml",
+                               "tests/input/schema_fail.xml",
+                               "tests/input/xml_formatting_error.xml"},
+                              settings),
+                  xml::ValidityError);
+}
+
 // Test if the schema catches errors.
 // This is trusted to XML libraries and the correctness of the RELAX NG schema,
 // so the test is very basic calls.
@@ -332,6 +355,7 @@ TEST_CASE("InitializerTest.CorrectModelInputs", "[mef::initializer]") {
   const char* correct_inputs[] = {
       "extern_library.xml",
       "extern_function.xml",
+      "pure_extern_function.xml",
       "extern_expression.xml",
       "valid_alignment.xml",
       "valid_sum_alignment.xml",
@@ -446,4 +470,69 @@ TEST_CASE("InitializerTest.NonDeclarativeSubstitutionsWithAppproximations",
   CHECK_THROWS_AS(Initializer({input}, core::Settings()), ValidityError);
 }
 
+// Only the elements reachable from the analysis targets are loaded.
+TEST_CASE("InitializerTest.ReachableElements", "[mef::initializer]") {
+  std::string input = "tests/input/model/reachable_elements.xml";
+  core::Settings settings;
+
+  SECTION("Gate target") {
+    settings.targets({"TrainOne"});
+    std::unique_ptr<Model> model = Initializer({input}, settings).model();
+    CHECK(model->gates().size() == 1);
+    CHECK(model->gates().count("TrainOne"));
+    CHECK(model->basic_events().size() == 3);  // With all the CCF members.
+    CHECK(model->basic_events().count("PumpTwo"));
+    CHECK(model->ccf_groups().size() == 1);
+    CHECK(model->ccf_groups().count("Pumps"));
+    CHECK(model->parameters().size() == 2);
+    CHECK(model->initiating_events().empty());
+    CHECK(model->event_trees().empty());
+    CHECK(model->sequences().empty());
+    CHECK(model->fault_trees().size() == 2);
+    for (const FaultTree& fault_tree : model->fault_trees()) {
+      INFO(fault_tree.name());
+      CHECK(fault_tree.top_events().size() ==
+            (fault_tree.name() == "TwoTrains"));
+      CHECK(fault_tree.ccf_groups().size() ==
+            (fault_tree.name() == "TwoTrains"));
+    }
+  }
+
+  SECTION("Initiating event target") {
+    settings.targets({"I"});
+    std::unique_ptr<Model> model = Initializer({input}, settings).model();
+    CHECK(model->initiating_events().size() == 1);
+    CHECK(model->initiating_events().count("I"));
+    CHECK(model->event_trees().size() == 1);
+    CHECK(model->sequences().size() == 1);
+    CHECK(model->gates().size() == 1);
+    CHECK(model->gates().count("TrainTwo"));
+    CHECK(model->basic_events().size() == 3);
+    CHECK(model->ccf_groups().size() == 1);
+  }
+
+  SECTION("Multiple targets") {
+    settings.targets({"J", "CoolingFailure"});
+    std::unique_ptr<Model> model = Initializer({input}, settings).model();
+    CHECK(model->initiating_events().size() == 1);
+    CHECK(model->gates().size() == 1);
+    CHECK(model->basic_events().size() == 3);
+    CHECK(model->ccf_groups().count("Fans"));
+    CHECK(model->parameters().size() == 2);
+  }
+
+  SECTION("Undefined target") {
+    settings.targets({"TrainOne", "Missing"});
+    CHECK_THROWS_AS(Initializer({input}, settings), UndefinedElement);
+  }
+
+  SECTION("All elements") {
+    std::unique_ptr<Model> model = Initializer({input}, settings).model();
+    CHECK(model->initiating_events().size() == 2);
+    CHECK(model->gates().size() == 4);
+    CHECK(model->basic_events().size() == 6);
+    CHECK(model->ccf_groups().size() == 2);
+  }
+}
+
 }  // namespace scram::mef::test
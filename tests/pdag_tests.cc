@@ -103,6 +103,35 @@ TEST_CASE("PdagTest.Cardinality", "[mef::pdag]") {
   }
 }
 
+TEST_CASE("PdagTest.Specialize", "[mef::pdag]") {
+  mef::BasicEvent one("one");
+  mef::HouseEvent house("house");
+  mef::Gate root("root");
+  root.formula(std::make_unique<mef::Formula>(
+      mef::kAnd, mef::Formula::ArgSet{&one, &house}));
+  Pdag symbolic(root, /*ccf=*/false, /*model=*/nullptr, /*symbolic=*/true);
+  CHECK(symbolic.root()->type() == kAnd);
+  CHECK(symbolic.root()->args() == Gate::ArgSet{2, 3});
+  CHECK(symbolic.basic_events().size() == 1);
+
+  SECTION("False house event") {
+    std::unique_ptr<Pdag> pdag = symbolic.Specialize();
+    CHECK(pdag->basic_events().size() == 1);
+    pdag->RemoveNullGates();
+    CHECK(pdag->IsTrivial());
+    CHECK(pdag->root()->constant());
+    CHECK(pdag->root()->args() == Gate::ArgSet{-1});
+  }
+  SECTION("True house event") {
+    house.state(true);
+    std::unique_ptr<Pdag> pdag = symbolic.Specialize();
+    pdag->RemoveNullGates();
+    CHECK(pdag->IsTrivial());
+    CHECK_FALSE(pdag->root()->constant());
+    CHECK(pdag->root()->args() == Gate::ArgSet{2});
+  }
+}
+
 static_assert(kNumConnectives == 8, "New gate types are not considered!");
 
 class GateTest {
@@ -97,6 +97,15 @@ TEST_CASE("ProjectTest.PrimeImplicantsSettings", "[config]") {
   CHECK(settings.prime_implicants());
 }
 
+TEST_CASE("ProjectTest.RngEngineSettings", "[config]") {
+  std::string config_file = "tests/input/fta/philox_configuration.xml";
+  Project config(config_file);
+  const core::Settings& settings = config.settings();
+  CHECK(settings.uncertainty_analysis());
+  CHECK(settings.seed() == 97531);
+  CHECK(settings.rng_engine() == core::RngEngine::kPhilox);
+}
+
 TEST_CASE("ProjectTest.CanonicalPath", "[config]") {
   std::string config_file = "tests/input/win_path_in_config.xml";
   std::string cwd = boost::filesystem::current_path().generic_string();
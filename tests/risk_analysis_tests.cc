@@ -17,14 +17,30 @@
 
 #include "risk_analysis_tests.h"
 
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
+#include "compact_reporter.h"
 #include "env.h"
 #include "error.h"
 #include "initializer.h"
+#include "logger.h"
+#include "progress.h"
 #include "reporter.h"
+#include "resources.h"
 #include "xml.h"
 
 namespace fs = boost::filesystem;
@@ -440,6 +456,70 @@ TEST_P(RiskAnalysisTest, AnalyzeEventTree) {
   }
 }
 
+// The overlapping sequences of an end state are not double-counted.
+TEST_P(RiskAnalysisTest, AnalyzeEventTreeEndStates) {
+  const char* tree_input = "tests/input/eta/end_states.xml";
+  settings.probability_analysis(true).approximation("none");
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  REQUIRE(analysis->event_tree_results().size() == 1);
+  const auto& eta = *analysis->event_tree_results().front().event_tree_analysis;
+  REQUIRE(eta.end_states().size() == 2);
+  const auto& end_state = eta.end_states().front();
+  CHECK(end_state.name == "CD");
+  CHECK(end_state.sequences.size() == 2);
+  CHECK(end_state.p_end_state == Approx(0.28));
+  CHECK(sequences().at("S2") + sequences().at("S3") == Approx(0.3));
+
+  using Target = std::pair<const mef::InitiatingEvent&,
+                           const core::EventTreeAnalysis::EndState&>;
+  auto it = std::find_if(analysis->results().begin(),
+                         analysis->results().end(), [](const auto& result) {
+                           return std::holds_alternative<Target>(
+                               result.id.target);
+                         });
+  REQUIRE(it != analysis->results().end());
+  CHECK(&std::get<Target>(it->id.target).second == &end_state);
+  REQUIRE(it->fault_tree_analysis);
+  CHECK(it->fault_tree_analysis->products().size() == 2);
+}
+
+// The paths reaching the same branch in the same state are collected once.
+TEST_P(RiskAnalysisTest, AnalyzeEventTreeSharedBranchStates) {
+  const char* tree_input = "tests/input/eta/shared_branch_states.xml";
+  settings.probability_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK(analysis->event_tree_results().size() == 1);
+  const auto& results = sequences();
+  REQUIRE(results.size() == 2);
+  REQUIRE(results.count("Failure"));
+  CHECK(results.at("Failure") == Approx(0.1));
+}
+
+TEST_P(RiskAnalysisTest, AnalyzeEventTreeUnconditionalPath) {
+  settings.probability_analysis(true);
+  SECTION("Formulas") {
+    const char* tree_input = "tests/input/eta/unconditional_path_formula.xml";
+    REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+    REQUIRE_NOTHROW(analysis->Analyze());
+    const auto& results = sequences();
+    REQUIRE(results.size() == 1);
+    REQUIRE(results.count("S"));
+    CHECK(results.at("S") == Approx(0.1));
+  }
+  SECTION("Expressions") {
+    const char* tree_input =
+        "tests/input/eta/unconditional_path_expression.xml";
+    REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+    REQUIRE_NOTHROW(analysis->Analyze());
+    const auto& results = sequences();
+    REQUIRE(results.size() == 1);
+    REQUIRE(results.count("S"));
+    CHECK(results.at("S") == Approx(0.15));
+  }
+}
+
 TEST_P(RiskAnalysisTest, AnalyzeTestEventDefault) {
   const char* tree_input = "tests/input/eta/test_event_default.xml";
   settings.probability_analysis(true);
@@ -593,12 +673,276 @@ TEST_F(RiskAnalysisTest, ReportAlignment) {
   CheckReport({tree_input});
 }
 
+// Phases share the qualitative analysis of unaffected targets
+// and specialize the preprocessed graph of the affected targets.
+TEST_F(RiskAnalysisTest, AlignmentReuseQualitativeAnalysis) {
+  std::string tree_input = "tests/input/model/phases_house_events.xml";
+  settings.probability_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  std::map<std::string, std::vector<const core::RiskAnalysis::Result*>> tops;
+  for (const core::RiskAnalysis::Result& result : analysis->results())
+    tops[std::get<const mef::Gate*>(result.id.target)->id()].push_back(&result);
+  REQUIRE(tops.size() == 2);
+  REQUIRE(tops["Dependent"].size() == 2);
+  REQUIRE(tops["Independent"].size() == 2);
+  CHECK(tops["Dependent"][0]->fault_tree_analysis !=
+        tops["Dependent"][1]->fault_tree_analysis);
+  CHECK(tops["Dependent"][0]->fault_tree_analysis->products().size() == 2);
+  CHECK(tops["Dependent"][1]->fault_tree_analysis->products().size() == 1);
+  CHECK(tops["Independent"][0]->fault_tree_analysis ==
+        tops["Independent"][1]->fault_tree_analysis);
+
+  auto p_independent = [](double mission_time) {
+    return (1 - std::exp(-1e-5 * mission_time)) *
+           (1 - std::exp(-2e-5 * mission_time));
+  };
+  double mission_time = model->mission_time().value();
+  for (int i : {0, 1}) {
+    const auto& pa = *tops["Independent"][i]->probability_analysis;
+    double phase_time = mission_time * (i ? 0.75 : 0.25);
+    CHECK(pa.settings().mission_time() == Approx(phase_time));
+    CHECK(pa.p_total() == Approx(p_independent(phase_time)));
+  }
+  auto p_dependent = [](double phase_time, bool repair) {
+    double p_a = 1 - std::exp(-1e-5 * phase_time);
+    double p_b = repair ? 0 : 1 - std::exp(-2e-5 * phase_time);
+    return 1 - (1 - p_a) * (1 - p_b);
+  };
+  for (int i : {0, 1}) {
+    const auto& pa = *tops["Dependent"][i]->probability_analysis;
+    double phase_time = mission_time * (i ? 0.75 : 0.25);
+    CHECK(pa.p_total() == Approx(p_dependent(phase_time, i)));
+  }
+}
+
+// The specialized graphs of the phases are preprocessed for every algorithm.
+TEST_P(RiskAnalysisTest, AlignmentSpecializeHouseEvents) {
+  std::string tree_input = "tests/input/model/phases_house_events.xml";
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  std::vector<const core::RiskAnalysis::Result*> dependent;
+  for (const core::RiskAnalysis::Result& result : analysis->results()) {
+    if (std::get<const mef::Gate*>(result.id.target)->id() == "Dependent")
+      dependent.push_back(&result);
+  }
+  REQUIRE(dependent.size() == 2);
+  CHECK(dependent[0]->fault_tree_analysis->products().size() == 2);
+  CHECK(dependent[1]->fault_tree_analysis->products().size() == 1);
+}
+
+// The analysis reports the progress of targets and honors cancellation.
+TEST_F(RiskAnalysisTest, ProgressAndCancellation) {
+  std::string tree_input = "tests/input/model/phases_house_events.xml";
+  std::vector<Progress::Status> reports;
+  Progress progress([&reports](const Progress::Status& status) {
+    if (status.stage == "targets")
+      reports.push_back(status);
+  });
+  settings.progress(&progress);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  REQUIRE(reports.size() == 4);  // 2 targets in each of 2 phases.
+  CHECK(reports.back().completed == 2);
+  CHECK(reports.back().total == 2);
+  CHECK(reports.back().remaining == Approx(0));
+
+  progress.Cancel();
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  CHECK_THROWS_AS(analysis->Analyze(), CancelError);
+}
+
+TEST_F(RiskAnalysisTest, TraceTimeline) {
+  std::string tree_input = "tests/input/model/phases_house_events.xml";
+  fs::path trace_file = fs::temp_directory_path() /
+                        ("scram_trace_test-" + fs::unique_path().string());
+  INFO("trace: " + trace_file.string());
+  settings.num_threads(2);
+  Tracer::Start();
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  REQUIRE_NOTHROW(Tracer::Write(trace_file.string()));
+  CHECK_FALSE(Tracer::enabled());
+
+  std::ifstream stream(trace_file.string());
+  std::string trace((std::istreambuf_iterator<char>(stream)),
+                    std::istreambuf_iterator<char>());
+  fs::remove(trace_file);
+  CHECK(trace.find("{\"traceEvents\": [") == 0);
+  CHECK(trace.find("\"name\": \"Processing input files\"") !=
+        std::string::npos);
+  CHECK(trace.find("\"name\": \"Fault tree analysis\"") !=
+        std::string::npos);
+  CHECK(trace.find("\"args\": {\"id\": \"Independent\"}") !=
+        std::string::npos);
+  CHECK(trace.find("\"thread_name\"") != std::string::npos);
+}
+
 TEST_F(RiskAnalysisTest, ReportAlignmentEventTree) {
   std::string dir = "input/EventTrees/";
   settings.probability_analysis(true);
   CheckReport({dir + "attack_alignment.xml", dir + "attack.xml"});
 }
 
+// Streaming of results as the analyses finish.
+TEST_F(RiskAnalysisTest, StreamReport) {
+  static xml::Validator validator(env::report_schema());
+  fs::path temp_file = fs::temp_directory_path() /
+                       ("scram_stream_test-" + fs::unique_path().string());
+  INFO("output: " + temp_file.string());
+  auto stream_report = [this, &temp_file](const std::string& input_file) {
+    REQUIRE_NOTHROW(ProcessInputFiles({input_file}));
+    REQUIRE_NOTHROW(Reporter().Stream(analysis.get(), temp_file.string()));
+    REQUIRE_NOTHROW(xml::Document(temp_file.string(), &validator));
+    std::ifstream stream(temp_file.string());
+    std::string report((std::istreambuf_iterator<char>(stream)),
+                       std::istreambuf_iterator<char>());
+    fs::remove(temp_file);
+    return report;
+  };
+  auto count = [](const std::string& report, const std::string& tag) {
+    int num_tags = 0;
+    for (auto pos = report.find(tag); pos != std::string::npos;
+         pos = report.find(tag, pos + 1)) {
+      ++num_tags;
+    }
+    return num_tags;
+  };
+
+  settings.importance_analysis(true).num_threads(2);
+  std::string report =
+      stream_report("tests/input/model/phases_house_events.xml");
+  REQUIRE(analysis->results().size() == 4);
+  for (const core::RiskAnalysis::Result& result : analysis->results()) {
+    CHECK_FALSE(result.fault_tree_analysis);  // Released after streaming.
+    CHECK_FALSE(result.probability_analysis);
+    CHECK_FALSE(result.importance_analysis);
+  }
+  CHECK(count(report, "<sum-of-products ") == 4);
+  CHECK(count(report, "<importance ") == 4);
+  CHECK(count(report, "<performance") == 0);
+
+  settings.uncertainty_analysis(true).num_trials(10);
+  report = stream_report("input/EventTrees/bcd.xml");
+  CHECK(count(report, "<initiating-event ") ==
+        analysis->event_tree_results().size());
+  CHECK(count(report, "<measure ") == analysis->results().size());
+}
+
+// Compact report formats written from the product containers.
+TEST_F(RiskAnalysisTest, CompactReport) {
+  settings.prime_implicants(true).importance_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({"tests/input/fta/children_nand_nor.xml"}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  fs::path temp_file = fs::temp_directory_path() /
+                       ("scram_compact_test-" + fs::unique_path().string());
+  INFO("output: " + temp_file.string());
+  auto compact_report = [this, &temp_file](CompactReporter::Format format) {
+    auto reporter = CompactReporter::Create(
+        format, true, xml::Output::Open(temp_file.string()));
+    reporter->Report(*analysis);
+    REQUIRE_NOTHROW(reporter->Finish());
+    std::ifstream stream(temp_file.string(), std::ios::binary);
+    std::string report((std::istreambuf_iterator<char>(stream)),
+                       std::istreambuf_iterator<char>());
+    fs::remove(temp_file);
+    return report;
+  };
+
+  SECTION("JSON lines") {
+    std::string report = compact_report(CompactReporter::kJsonLines);
+    std::map<std::string, int> lines;
+    std::istringstream stream(report);
+    for (std::string line; std::getline(stream, line);) {
+      REQUIRE(line.size() > 2);
+      CHECK(line.front() == '{');
+      CHECK(line.back() == '}');
+      auto type = line.find("\"type\":\"");
+      REQUIRE(type == 1);
+      type += 8;
+      lines[line.substr(type, line.find('"', type) - type)]++;
+    }
+    CHECK(lines["information"] == 1);
+    CHECK(lines["target"] == 1);
+    CHECK(lines["product"] == products().size());
+    CHECK(lines["importance"] ==
+          analysis->results().front().importance_analysis->importance().size());
+    CHECK(report.find("\"not\":[\"") != std::string::npos);
+  }
+
+  SECTION("columnar") {
+    std::string report = compact_report(CompactReporter::kColumnar);
+    std::size_t pos = 0;
+    auto get = [&report, &pos](auto value) {
+      REQUIRE(pos + sizeof(value) <= report.size());
+      std::memcpy(&value, report.data() + pos, sizeof(value));
+      pos += sizeof(value);
+      return value;
+    };
+    auto get_string = [&report, &pos, &get] {
+      auto size = get(std::uint32_t());
+      REQUIRE(pos + size <= report.size());
+      pos += size;
+      return report.substr(pos - size, size);
+    };
+    REQUIRE(report.compare(0, 8, "SCRAMCOL") == 0);
+    pos = 8;
+    CHECK(get(std::uint32_t()) == 1);
+    CHECK(get(std::uint32_t()) == 0x01020304);
+
+    REQUIRE(get(std::uint32_t()) == 1);  // The target table.
+    CHECK(get(std::uint32_t()) == 0);
+    CHECK(get(std::uint8_t()) == 0);
+    CHECK(get_string() == "TopEvent");
+    for (int i = 0; i < 4; ++i)
+      CHECK(get_string().empty());  // No sequence, context, or warnings.
+    CHECK(get(std::uint8_t()) == 0);
+    CHECK(get(double()) ==
+          analysis->results().front().probability_analysis->p_total());
+
+    REQUIRE(get(std::uint32_t()) == 2);  // The product table.
+    CHECK(get(std::uint32_t()) == 0);
+    std::vector<std::string> events(get(std::uint32_t()));
+    for (std::string& event : events)
+      event = get_string();
+    CHECK(std::is_sorted(events.begin(), events.end()));
+    auto num_products = get(std::uint64_t());
+    auto num_literals = get(std::uint64_t());
+    std::vector<std::uint64_t> offsets(num_products + 1);
+    for (std::uint64_t& offset : offsets)
+      offset = get(std::uint64_t());
+    REQUIRE(offsets.front() == 0);
+    REQUIRE(offsets.back() == num_literals);
+    std::set<std::set<std::string>> report_products;
+    for (std::uint64_t i = 0; i < num_products; ++i) {
+      std::set<std::string> product;
+      for (auto j = offsets[i]; j < offsets[i + 1]; ++j) {
+        auto literal = get(std::int32_t());
+        REQUIRE(literal != 0);
+        REQUIRE(std::abs(literal) <= events.size());
+        product.insert((literal < 0 ? "not " : "") +
+                       events[std::abs(literal) - 1]);
+      }
+      report_products.insert(std::move(product));
+    }
+    CHECK(report_products == products());
+    REQUIRE(get(std::uint8_t()) == 1);
+    pos += num_products * sizeof(double);
+
+    REQUIRE(get(std::uint32_t()) == 3);  // The importance table.
+    CHECK(get(std::uint32_t()) == 0);
+    auto num_events = get(std::uint32_t());
+    CHECK(num_events ==
+          analysis->results().front().importance_analysis->importance().size());
+    for (std::uint32_t i = 0; i < num_events; ++i)
+      get_string();
+    pos += num_events * (sizeof(std::int32_t) + 6 * sizeof(double));
+
+    CHECK(get(std::uint32_t()) == 0);  // The end of tables.
+    CHECK(pos == report.size());
+  }
+}
+
 // NAND and NOR as a child cases.
 TEST_P(RiskAnalysisTest, ChildNandNorGates) {
   std::string tree_input = "tests/input/fta/children_nand_nor.xml";
@@ -642,6 +986,90 @@ TEST_F(RiskAnalysisTest, UndefinedEventsMixedRoles) {
   CHECK(products() == mcs);
 }
 
+// Unchanged targets are restored from the persistent result cache.
+TEST_P(RiskAnalysisTest, ResultCache) {
+  std::string tree_input = "tests/input/fta/importance_test.xml";
+  fs::path cache_dir = fs::temp_directory_path() /
+                       ("scram_cache_test-" + fs::unique_path().string());
+  INFO("cache: " + cache_dir.string());
+  settings.importance_analysis(true).cache_directory(cache_dir.string());
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK_FALSE(analysis->results().front().cached);
+  std::set<std::set<std::string>> computed_products = products();
+  double computed_p_total = p_total();
+  ImportanceFactors computed_importance = importance("PumpOne");
+
+  auto check_results = [&] {
+    CHECK(products() == computed_products);
+    CHECK(p_total() == Approx(computed_p_total));
+    const ImportanceFactors& factors = importance("PumpOne");
+    CHECK(factors.occurrence == computed_importance.occurrence);
+    CHECK(factors.mif == Approx(computed_importance.mif));
+    CHECK(factors.raw == Approx(computed_importance.raw));
+  };
+
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK(analysis->results().front().cached);
+  check_results();
+
+  settings.cache_verification(1);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK_FALSE(analysis->results().front().cached);
+  check_results();
+
+  settings.cache_verification(0).mission_time(100);  // Changed probabilities.
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK_FALSE(analysis->results().front().cached);
+  fs::remove_all(cache_dir);
+}
+
+// Failures to write the result cache do not fail the analysis.
+TEST_P(RiskAnalysisTest, ResultCacheWriteFailure) {
+  std::string tree_input = "tests/input/fta/importance_test.xml";
+  fs::path temp_dir = fs::temp_directory_path() /
+                      ("scram_cache_test-" + fs::unique_path().string());
+  // The cache directory path leaves no room for the entry file names.
+  fs::path cache_dir = temp_dir;
+  while (cache_dir.string().size() < 3800)
+    cache_dir /= std::string(200, 'c');
+  cache_dir /= std::string(4080 - cache_dir.string().size() - 1, 'c');
+  INFO("cache: " + temp_dir.string());
+  settings.cache_directory(cache_dir.string());
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK_FALSE(analysis->results().front().cached);
+  CHECK_FALSE(products().empty());
+  CHECK(fs::is_empty(cache_dir));
+  fs::remove_all(temp_dir);
+}
+
+TEST_P(RiskAnalysisTest, ResourceAccounting) {
+  std::string tree_input = "tests/input/fta/importance_test.xml";
+  settings.importance_analysis(true);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  const RiskAnalysis::Result& result = analysis->results().front();
+  const Resources& fta = result.fault_tree_analysis->resources();
+  CHECK(fta.pdag_nodes > 0);
+  CHECK(fta.allocated > 0);
+  CHECK(fta.products == products().size());
+  if (settings.algorithm() == Algorithm::kBdd) {
+    CHECK(fta.bdd_vertices > 0);
+  } else {
+    CHECK(fta.bdd_vertices == 0);
+  }
+  CHECK(fta.zbdd_vertices > 0);
+
+  // Probability and importance analyses reuse the products or the BDD.
+  const Resources& importance = result.importance_analysis->resources();
+  CHECK(importance.pdag_nodes == 0);
+  CHECK(importance.products == 0);
+}
+
 // Extern function call check.
 TEST_P(RiskAnalysisTest, ExternFunctionProbability) {
   std::string tree_input = "tests/input/model/extern_full_check.xml";
@@ -653,4 +1081,32 @@ TEST_P(RiskAnalysisTest, ExternFunctionProbability) {
   CHECK(p_total() == Approx(0.1));
 }
 
+// The counter-based deviates reproduce the samples of a reloaded model.
+TEST_F(RiskAnalysisTest, CounterBasedUncertainty) {
+  std::string tree_input = "tests/input/fta/weibull_lnorm_deviate_2p.xml";
+  settings.uncertainty_analysis(true).mission_time(40).num_trials(100);
+  settings.seed(97531).rng_engine(RngEngine::kPhilox);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  double first_mean = mean();
+  double first_sigma = sigma();
+  CHECK(first_sigma > 0);
+
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  CHECK(mean() == first_mean);
+  CHECK(sigma() == first_sigma);
+}
+
+// Memoized calls of pure extern functions.
+TEST_P(RiskAnalysisTest, PureExternFunctionProbability) {
+  std::string tree_input = "tests/input/model/pure_extern_function.xml";
+  settings.probability_analysis(true).mission_time(100);
+  REQUIRE_NOTHROW(ProcessInputFiles({tree_input}, true));
+  REQUIRE_NOTHROW(analysis->Analyze());
+  std::set<std::set<std::string>> mcs = {{"e1"}, {"e2"}};
+  CHECK(products() == mcs);
+  CHECK(p_total() == Approx(0.003).epsilon(1e-3));
+}
+
 }  // namespace scram::core::test
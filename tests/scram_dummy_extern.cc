@@ -28,4 +28,14 @@ double identity(double arg) { return arg; }
 double div(double lhs, double rhs) { return lhs / rhs; }
 double sum(double arg1, double arg2, double arg3) { return arg1 + arg2 + arg3; }
 double sub(double lhs, double rhs) { return lhs - rhs; }
+
+void identity_batch(int n, double* results, const double* args) {
+  for (int i = 0; i < n; ++i)
+    results[i] = args[i];
+}
+
+void div_batch(int n, double* results, const double* lhs, const double* rhs) {
+  for (int i = 0; i < n; ++i)
+    results[i] = lhs[i] / rhs[i];
+}
 }
@@ -17,6 +17,8 @@
 
 #include "serialization.h"
 
+#include <fstream>
+
 #include <boost/filesystem.hpp>
 
 #include <catch.hpp>
@@ -24,6 +26,7 @@
 #include "env.h"
 #include "initializer.h"
 #include "settings.h"
+#include "snapshot.h"
 #include "xml.h"
 
 namespace fs = boost::filesystem;
@@ -59,4 +62,84 @@ TEST_CASE("SerializationTest.InputOutput", "[mef::serialization]") {
   }
 }
 
+TEST_CASE("SnapshotTest.InputOutput", "[mef::snapshot]") {
+  std::vector<std::vector<std::string>> inputs = {
+      {"tests/input/xml_special_chars.xml"},
+      {"tests/input/xinclude.xml"},
+      {"input/EventTrees/bcd.xml"},
+      {"input/EventTrees/attack_alignment.xml"},
+      {"input/ThreeMotor/three_motor.xml"},
+      {"input/Baobab/baobab2.xml", "input/Baobab/baobab2-basic-events.xml"}};
+
+  for (const auto& input : inputs) {
+    INFO("inputs: " +
+         Catch::StringMaker<std::vector<std::string>>::convert(input))
+    std::unique_ptr<Model> model;
+    REQUIRE_NOTHROW(model = Initializer(input, core::Settings{}).model());
+    fs::path unique_name = "scram_test-" + fs::unique_path().string();
+    fs::path temp_file = fs::temp_directory_path() / unique_name;
+    INFO("temp file: " + temp_file.string());
+    REQUIRE_NOTHROW(Snapshot::Write(input, temp_file.string()));
+    std::unique_ptr<Model> loaded;
+    REQUIRE_NOTHROW(loaded = Initializer(Snapshot::Read(temp_file.string()),
+                                         core::Settings{})
+                                 .model());
+    fs::remove(temp_file);
+    CHECK(loaded->name() == model->name());
+    CHECK(loaded->label() == model->label());
+    CHECK(loaded->gates().size() == model->gates().size());
+    CHECK(loaded->basic_events().size() == model->basic_events().size());
+    CHECK(loaded->house_events().size() == model->house_events().size());
+    CHECK(loaded->parameters().size() == model->parameters().size());
+    CHECK(loaded->ccf_groups().size() == model->ccf_groups().size());
+    CHECK(loaded->event_trees().size() == model->event_trees().size());
+    CHECK(loaded->sequences().size() == model->sequences().size());
+    CHECK(loaded->alignments().size() == model->alignments().size());
+    auto total_p = [](const Model& data) {
+      double sum = 0;
+      for (const BasicEvent& event : data.basic_events())
+        sum += event.HasExpression() ? event.p() : 0;
+      return sum;
+    };
+    CHECK(total_p(*loaded) == Approx(total_p(*model)));
+  }
+}
+
+// The expressions are validated with the settings of the loading.
+TEST_CASE("SnapshotTest.MissionTime", "[mef::snapshot]") {
+  std::vector<std::string> input = {"tests/input/fta/linear_mission_time.xml"};
+  core::Settings settings;
+  settings.mission_time(100);
+  REQUIRE_NOTHROW(Initializer(input, settings));
+  fs::path unique_name = "scram_test-" + fs::unique_path().string();
+  std::string temp_file = (fs::temp_directory_path() / unique_name).string();
+  Snapshot::Write(input, temp_file);
+  CHECK_NOTHROW(Initializer(Snapshot::Read(temp_file), settings));
+  settings.mission_time(2000);
+  CHECK_THROWS_AS(Initializer(input, settings), ValidityError);
+  CHECK_THROWS_AS(Initializer(Snapshot::Read(temp_file), settings),
+                  ValidityError);
+  fs::remove(temp_file);
+}
+
+TEST_CASE("SnapshotTest.Corruption", "[mef::snapshot]") {
+  CHECK_THROWS_AS(Snapshot::Read("tests/input/nonexistent_file.snap"),
+                  IOError);
+  CHECK_THROWS_AS(Snapshot::Read("tests/input/fta/correct_tree_input.xml"),
+                  IOError);
+
+  fs::path unique_name = "scram_test-" + fs::unique_path().string();
+  std::string temp_file = (fs::temp_directory_path() / unique_name).string();
+  Snapshot::Write({"tests/input/fta/correct_tree_input.xml"}, temp_file);
+  CHECK_NOTHROW(Snapshot::Read(temp_file));
+  {
+    std::fstream file(temp_file, std::ios::in | std::ios::out |
+                                     std::ios::binary | std::ios::ate);
+    file.seekp(-2, std::ios::end);  // The last string byte.
+    file.put('#');
+  }
+  CHECK_THROWS_AS(Snapshot::Read(temp_file), IOError);
+  fs::remove(temp_file);
+}
+
 }  // namespace scram::mef::test
@@ -45,6 +45,11 @@ TEST_CASE("SettingsTest IncorrectSetup", "[settings]") {
   CHECK_THROWS_AS(s.num_bins(0), SettingsError);
   // Incorrect seed.
   CHECK_THROWS_AS(s.seed(-1), SettingsError);
+  // Incorrect random number engine.
+  CHECK_THROWS_AS(s.rng_engine("mt"), SettingsError);
+  // Incorrect number of threads.
+  CHECK_THROWS_AS(s.num_threads(0), SettingsError);
+  CHECK_THROWS_AS(s.num_threads(-1), SettingsError);
   // Incorrect mission time.
   CHECK_THROWS_AS(s.mission_time(-10), SettingsError);
   // Incorrect time step.
@@ -92,6 +97,14 @@ TEST_CASE("SettingsTest CorrectSetup", "[settings]") {
 
   // Correct seed.
   CHECK_NOTHROW(s.seed(1));
+  // Correct random number engine.
+  CHECK_NOTHROW(s.rng_engine("philox"));
+  CHECK(s.rng_engine() == RngEngine::kPhilox);
+  CHECK_NOTHROW(s.rng_engine("mt19937"));
+  CHECK(s.rng_engine() == RngEngine::kMt19937);
+  // Correct number of threads.
+  CHECK_NOTHROW(s.num_threads(1));
+  CHECK_NOTHROW(s.num_threads(8));
 
   // Correct mission time.
   CHECK_NOTHROW(s.mission_time(0));
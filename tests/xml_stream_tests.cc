@@ -17,14 +17,24 @@
 
 #include "xml_stream.h"
 
+#include <cstdlib>
+
 #include <fstream>
+#include <limits>
 #include <memory>
 #include <sstream>
+#include <string>
 
 #include <boost/filesystem.hpp>
 
 #include <catch.hpp>
 
+#include <zlib.h>
+
+#ifdef SCRAM_WITH_ZSTD
+#include <zstd.h>
+#endif
+
 namespace fs = boost::filesystem;
 
 namespace scram::xml::test {
@@ -156,4 +166,182 @@ TEST_CASE("XmlStreamTest.Full", "[xml_stream]") {
   fs::remove(temp_file);
 }
 
+namespace {
+
+/// The expected document of the streamed test data.
+const char kContent[] =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<root name=\"master\" age=\"42\" stamina=\"0.42\" empty=\"\">\n"
+    "  <empty/>\n"
+    "  <student new=\"true\" old=\"false\">\n"
+    "    <label>newbie</label>\n"
+    "  </student>\n"
+    "  <student name=\"brut'\" motto=\"less &lt; more\">\n"
+    "    <label>brut' less &lt; more</label>\n"
+    "  </student>\n"
+    "  <student name=\"brut&quot;\" motto=\"less > more\">\n"
+    "    <label>brut&quot; less > more</label>\n"
+    "  </student>\n"
+    "  <student name=\"brut&amp;\" motto=\"less &amp; more\">\n"
+    "    <label>brut&amp; less &amp; more</label>\n"
+    "  </student>\n"
+    "</root>\n";
+
+/// Streams the test data into the document.
+void WriteContent(Stream* xml_stream) {
+  StreamElement root = xml_stream->root("root");
+  root.SetAttribute("name", "master")
+      .SetAttribute("age", 42)
+      .SetAttribute("stamina", "0.42")
+      .SetAttribute("empty", "");
+  root.AddChild("empty");
+  {
+    StreamElement student = root.AddChild("student");
+    student.SetAttribute("new", true).SetAttribute("old", false);
+    student.AddChild("label").AddText("newbie");
+  }
+  auto add_student = [&root](const char* name, const char* motto) {
+    StreamElement student = root.AddChild("student");
+    student.SetAttribute("name", name).SetAttribute("motto", motto);
+    student.AddChild("label").AddText(name).AddText(" ").AddText(motto);
+  };
+  add_student("brut'", "less < more");
+  add_student("brut\"", "less > more");
+  add_student("brut&", "less & more");
+}
+
+/// Output into a string.
+class StringOutput : public Output {
+ public:
+  /// @param[out] data  The destination string.
+  explicit StringOutput(std::string* data) : data_(*data) {}
+
+  void Write(const char* data, std::size_t size) noexcept override {
+    data_.append(data, size);
+  }
+
+  int Finish() noexcept override { return 0; }
+
+ private:
+  std::string& data_;  ///< The destination string.
+};
+
+/// @returns The text streamed as the attribute value.
+template <typename T>
+std::string AttributeText(const T& value) {
+  std::string data;
+  {
+    Stream xml_stream(std::make_unique<StringOutput>(&data), false);
+    xml_stream.root("root").SetAttribute("value", value);
+  }
+  auto first = data.find("value=\"") + 7;
+  return data.substr(first, data.rfind('"') - first);
+}
+
+}  // namespace
+TEST_CASE("XmlStreamTest.Values", "[xml_stream]") {
+  SECTION("Numbers") {
+    CHECK(AttributeText(-42) == "-42");
+    CHECK(AttributeText(std::numeric_limits<std::size_t>::max()) ==
+          std::to_string(std::numeric_limits<std::size_t>::max()));
+    CHECK(AttributeText(0.5) == "0.5");
+    CHECK(AttributeText(100.0) == "100");
+    CHECK(AttributeText(1e-05) == "1e-05");
+    for (double value : {0.1, 1.0 / 3, 0.7225, 1e-300, 5e-324, 1.7e308}) {
+      std::string text = AttributeText(value);
+      INFO(text);
+      CHECK(std::strtod(text.c_str(), nullptr) == value);  // Round trip.
+    }
+  }
+
+  SECTION("Escaping") {
+    auto escape = [](const std::string& text) {
+      std::string result;
+      for (char ch : text) {
+        if (ch == '&') {
+          result += "&amp;";
+        } else if (ch == '<') {
+          result += "&lt;";
+        } else if (ch == '"') {
+          result += "&quot;";
+        } else {
+          result += ch;
+        }
+      }
+      return result;
+    };
+    for (char special : {'&', '<', '"'}) {
+      for (int i = 0; i < 20; ++i) {  // Positions across machine words.
+        std::string text(20, 'x');
+        text[i] = special;
+        text[19 - i] = special;
+        INFO(text);
+        CHECK(AttributeText(text) == escape(text));
+      }
+    }
+    CHECK(AttributeText(std::string(17, 'y')) == std::string(17, 'y'));
+    CHECK(AttributeText("<\"&") == "&lt;&quot;&amp;");
+  }
+}
+
+TEST_CASE("XmlStreamTest.Compressed", "[xml_stream]") {
+  bool background = GENERATE(false, true);
+  fs::path unique_name = "scram_xml_test-" + fs::unique_path().string();
+  fs::path temp_file = fs::temp_directory_path() / unique_name;
+  std::string large_text(1 << 20, 'x');  // Multiple blocks.
+
+  SECTION("gzip") {
+    std::string file = temp_file.string() + ".gz";
+    INFO("XML temp file: " + file);
+    {
+      Stream xml_stream(Output::Open(file, background));
+      WriteContent(&xml_stream);
+    }
+    std::unique_ptr<gzFile_s, decltype(&gzclose)> gz(gzopen(file.c_str(), "rb"),
+                                                    &gzclose);
+    REQUIRE(gz);
+    std::string content(sizeof(kContent), '\0');
+    int size = gzread(gz.get(), content.data(), content.size());
+    content.resize(size);
+    CHECK(content == kContent);
+    gz.reset();
+    fs::remove(file);
+
+    {
+      Stream xml_stream(Output::Open(file, background));
+      xml_stream.root("root").AddText(large_text);
+    }
+    CHECK(fs::file_size(file) < large_text.size() / 100);
+    fs::remove(file);
+  }
+
+  SECTION("zstd") {
+    std::string file = temp_file.string() + ".zst";
+    INFO("XML temp file: " + file);
+#ifdef SCRAM_WITH_ZSTD
+    {
+      Stream xml_stream(Output::Open(file, background));
+      WriteContent(&xml_stream);
+    }
+    std::stringstream str_stream;
+    str_stream << std::fstream(file, std::ios::in | std::ios::binary).rdbuf();
+    std::string compressed = str_stream.str();
+    std::string content(sizeof(kContent), '\0');
+    std::size_t size = ZSTD_decompress(content.data(), content.size(),
+                                       compressed.data(), compressed.size());
+    REQUIRE_FALSE(ZSTD_isError(size));
+    content.resize(size);
+    CHECK(content == kContent);
+    fs::remove(file);
+#else
+    CHECK_THROWS_AS(Output::Open(file, background), IOError);
+#endif
+  }
+
+  SECTION("Inaccessible file") {
+    CHECK_THROWS_AS(Output::Open("abracadabra.cadabraabra/output.xml.gz"),
+                    IOError);
+  }
+}
+
 }  // namespace scram::xml::test